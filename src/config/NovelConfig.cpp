@@ -55,6 +55,10 @@ void NovelConfig::setDefaults()
     m_proxyEnabled = false;
     m_proxyHost = "127.0.0.1";
     m_proxyPort = 8080;
+
+    // HTTP缓存配置
+    m_httpCacheEnabled = true;
+    m_httpCacheMaxSize = 256;
 }
 
 void NovelConfig::loadConfig()
@@ -95,6 +99,13 @@ void NovelConfig::loadConfig()
     m_proxyPort = m_settings->value("port", 8080).toInt();
 
     m_settings->endGroup();
+
+    m_settings->beginGroup("cache");
+
+    m_httpCacheEnabled = m_settings->value("enabled", true).toBool();
+    m_httpCacheMaxSize = m_settings->value("max-size", 256).toInt();
+
+    m_settings->endGroup();
 }
 
 void NovelConfig::saveConfig()
@@ -136,6 +147,13 @@ void NovelConfig::saveConfig()
 
     m_settings->endGroup();
 
+    m_settings->beginGroup("cache");
+
+    m_settings->setValue("enabled", m_httpCacheEnabled);
+    m_settings->setValue("max-size", m_httpCacheMaxSize);
+
+    m_settings->endGroup();
+
     m_settings->sync();
 }
 
@@ -279,6 +297,23 @@ void NovelConfig::setProxyPort(int port)
     }
 }
 
+// HTTP缓存配置设置方法
+void NovelConfig::setHttpCacheEnabled(bool enabled)
+{
+    if (m_httpCacheEnabled != enabled) {
+        m_httpCacheEnabled = enabled;
+        emit configChanged();
+    }
+}
+
+void NovelConfig::setHttpCacheMaxSize(int maxSizeMb)
+{
+    if (m_httpCacheMaxSize != maxSizeMb) {
+        m_httpCacheMaxSize = maxSizeMb;
+        emit configChanged();
+    }
+}
+
 // 基础配置获取方法
 QString NovelConfig::getLanguage() const
 {
@@ -367,3 +402,14 @@ int NovelConfig::getProxyPort() const
 {
     return m_proxyPort;
 }
+
+// HTTP缓存配置获取方法
+bool NovelConfig::getHttpCacheEnabled() const
+{
+    return m_httpCacheEnabled;
+}
+
+int NovelConfig::getHttpCacheMaxSize() const
+{
+    return m_httpCacheMaxSize;
+}
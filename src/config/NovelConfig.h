@@ -46,6 +46,10 @@ public:
     void setProxyHost(const QString& host);
     void setProxyPort(int port);
 
+    // HTTP cache configuration setters
+    void setHttpCacheEnabled(bool enabled);
+    void setHttpCacheMaxSize(int maxSizeMb);
+
     // Basic configuration getters
     QString getLanguage() const;
     QString getActiveRules() const;
@@ -71,6 +75,10 @@ public:
     QString getProxyHost() const;
     int getProxyPort() const;
 
+    // HTTP cache configuration getters
+    bool getHttpCacheEnabled() const;
+    int getHttpCacheMaxSize() const;
+
     // Configuration file management
     void saveConfig();
     void loadConfig();
@@ -108,6 +116,10 @@ private:
     QString m_proxyHost;
     int m_proxyPort;
 
+    // HTTP cache configuration items
+    bool m_httpCacheEnabled;
+    int m_httpCacheMaxSize;  // MB
+
     // Configuration file management
     QSettings* m_settings;
     QString m_configFilePath;
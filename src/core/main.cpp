@@ -5,12 +5,26 @@
 #include "mainwindow.h"
 #include "../config/SettingsDialog.h"
 #include "../config/settings.h"
+#include "../network/HttpClient.h"
 
 int main(int argc, char* argv[]) {
 	QApplication a(argc, argv);
 	a.setQuitOnLastWindowClosed(false);
 
+	// Offline crawl benchmarks: record live responses, or replay them through tools/replay_server
+	const QString recordDir = qEnvironmentVariable("HUYAN_RECORD_DIR");
+	if (!recordDir.isEmpty()) {
+		HttpClient::startRecording(recordDir);
+	}
+	const QString replayServer = qEnvironmentVariable("HUYAN_REPLAY_SERVER");
+	if (!replayServer.isEmpty()) {
+		const QUrl server = QUrl::fromUserInput(replayServer);
+		HttpClient::setReplayServer(server.host(), quint16(server.port(8089)));
+	}
+
 	MainWindow w;
 
-	return a.exec();
+	const int result = a.exec();
+	HttpClient::stopRecording();
+	return result;
 }
@@ -54,6 +54,8 @@ MainWindow::MainWindow(QWidget* parent)
 	        m_novelSearchManager, &NovelSearchManager::startSearch);
 	connect(m_novelSearchViewEnhanced, &NovelSearchViewEnhanced::downloadRequested,
 	        m_novelSearchManager, &NovelSearchManager::startDownload);
+	connect(m_novelSearchViewEnhanced, &NovelSearchViewEnhanced::searchResultSelected,
+	        m_novelSearchManager, &NovelSearchManager::prefetchResult);
 
 	// Connect manager signals to enhanced view
 	bool connected1 = connect(m_novelSearchManager, &NovelSearchManager::searchStarted,
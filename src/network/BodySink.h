@@ -0,0 +1,40 @@
+#ifndef BODYSINK_H
+#define BODYSINK_H
+
+#include <QByteArray>
+
+/**
+ * @brief Consumer of a response body as it arrives, instead of after the reply finished
+ *
+ * Set on NetworkDispatcher::PendingRequest. All calls are made on the network
+ * thread, in order, and must not block. A request that is retried (or falls
+ * back from HTTP/2) calls begin() again: the sink must drop what it received
+ * from the earlier attempt. The HttpResponse of a streamed request has an
+ * empty body; the sink holds the only copy of the data.
+ */
+class BodySink
+{
+public:
+    virtual ~BodySink() = default;
+
+    /**
+     * @brief An attempt starts delivering its body
+     * @param contentType Raw Content-Type header of the response
+     */
+    virtual void begin(const QByteArray &contentType) = 0;
+
+    /**
+     * @brief Next decoded (Content-Encoding removed) piece of the body
+     */
+    virtual void write(const char *data, int size) = 0;
+
+    /**
+     * @brief The final attempt's reply finished; called before the response callback
+     * @param complete The whole body was delivered by a successful transfer
+     *
+     * Not called for requests that never produced a reply (open circuit, shutdown).
+     */
+    virtual void end(bool complete) = 0;
+};
+
+#endif // BODYSINK_H
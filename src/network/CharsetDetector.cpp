@@ -0,0 +1,147 @@
+#include "CharsetDetector.h"
+#include <QTextCodec>
+#include <QDebug>
+
+namespace {
+
+// Meta declarations must appear early; browsers scan the first 1024 bytes,
+// but some novel sites put large inline scripts before <meta>
+const int kMetaScanLimit = 4096;
+
+bool isLabelTerminator(char c)
+{
+    return c == '"' || c == '\'' || c == ';' || c == '>' || c == '/'
+        || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Extract the value following "charset=" starting at 'from' in a lowercased buffer
+QByteArray charsetValueAt(const QByteArray &lower, int from)
+{
+    int pos = lower.indexOf("charset", from);
+    if (pos < 0) {
+        return QByteArray();
+    }
+    pos += 7;
+
+    while (pos < lower.size() && (lower[pos] == ' ' || lower[pos] == '\t')) {
+        ++pos;
+    }
+    if (pos >= lower.size() || lower[pos] != '=') {
+        return QByteArray();
+    }
+    ++pos;
+    while (pos < lower.size() && (lower[pos] == ' ' || lower[pos] == '\t' || lower[pos] == '"' || lower[pos] == '\'')) {
+        ++pos;
+    }
+
+    int end = pos;
+    while (end < lower.size() && !isLabelTerminator(lower[end])) {
+        ++end;
+    }
+    return lower.mid(pos, end - pos);
+}
+
+} // namespace
+
+QByteArray CharsetDetector::detect(const QByteArray &body, const QByteArray &contentType)
+{
+    QByteArray charset = fromBom(body);
+    if (charset.isEmpty()) {
+        charset = fromContentType(contentType);
+    }
+    if (charset.isEmpty()) {
+        charset = fromMetaTags(body);
+    }
+    return charset.isEmpty() ? QByteArray("utf-8") : charset;
+}
+
+QByteArray CharsetDetector::fromBom(const QByteArray &body)
+{
+    if (body.startsWith("\xEF\xBB\xBF")) {
+        return "utf-8";
+    }
+    if (body.startsWith("\xFE\xFF")) {
+        return "utf-16be";
+    }
+    if (body.startsWith("\xFF\xFE")) {
+        return "utf-16le";
+    }
+    return QByteArray();
+}
+
+QByteArray CharsetDetector::fromContentType(const QByteArray &contentType)
+{
+    if (contentType.isEmpty()) {
+        return QByteArray();
+    }
+    return normalize(charsetValueAt(contentType.toLower(), 0));
+}
+
+QByteArray CharsetDetector::fromMetaTags(const QByteArray &body)
+{
+    const QByteArray head = body.left(kMetaScanLimit).toLower();
+
+    int pos = 0;
+    while ((pos = head.indexOf("<meta", pos)) >= 0) {
+        int tagEnd = head.indexOf('>', pos);
+        if (tagEnd < 0) {
+            tagEnd = head.size();
+        }
+
+        // Covers both <meta charset="gbk"> and
+        // <meta http-equiv="Content-Type" content="text/html; charset=gbk">
+        const QByteArray tag = head.mid(pos, tagEnd - pos + 1);
+        const QByteArray label = normalize(charsetValueAt(tag, 0));
+        if (!label.isEmpty()) {
+            return label;
+        }
+        pos = tagEnd;
+    }
+    return QByteArray();
+}
+
+QByteArray CharsetDetector::normalize(const QByteArray &label)
+{
+    QByteArray normalized = label.trimmed().toLower();
+    if (normalized.isEmpty()) {
+        return normalized;
+    }
+
+    if (normalized == "utf8" || normalized == "unicode-1-1-utf-8") {
+        return "utf-8";
+    }
+
+    // Sites labelled gb2312/gbk routinely contain characters outside those tables;
+    // GB18030 is a strict superset, so decode the whole family with it
+    if (normalized == "gb2312" || normalized == "gbk" || normalized == "x-gbk"
+        || normalized == "cp936" || normalized == "gb_2312-80" || normalized == "chinese") {
+        return "gb18030";
+    }
+
+    if (normalized == "big5-hkscs" || normalized == "x-x-big5") {
+        return "big5";
+    }
+
+    return normalized;
+}
+
+bool CharsetDetector::isUtf8(const QByteArray &charset)
+{
+    return charset.isEmpty()
+        || charset.compare("utf-8", Qt::CaseInsensitive) == 0
+        || charset.compare("utf8", Qt::CaseInsensitive) == 0;
+}
+
+QString CharsetDetector::decode(const QByteArray &bytes, const QByteArray &charset)
+{
+    if (isUtf8(charset)) {
+        return QString::fromUtf8(bytes);
+    }
+
+    QTextCodec *codec = QTextCodec::codecForName(charset);
+    if (!codec) {
+        qDebug() << "CharsetDetector: Unknown charset" << charset << ", decoding as UTF-8";
+        return QString::fromUtf8(bytes);
+    }
+    return codec->toUnicode(bytes);
+}
@@ -0,0 +1,57 @@
+#ifndef CHARSETDETECTOR_H
+#define CHARSETDETECTOR_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Determines the character encoding of a raw HTTP/HTML body
+ *
+ * Detection order follows the HTML encoding sniffing rules: byte order mark,
+ * then the Content-Type charset parameter, then <meta charset> or
+ * <meta http-equiv="Content-Type"> in the first bytes of the document.
+ * Labels are normalized so GBK-family pages decode with the GB18030 superset.
+ */
+class CharsetDetector
+{
+public:
+    /**
+     * @brief Detect the charset of a body, defaulting to "utf-8"
+     * @param body Raw response body
+     * @param contentType Raw Content-Type header, may be empty
+     * @return Normalized lowercase charset label
+     */
+    static QByteArray detect(const QByteArray &body, const QByteArray &contentType);
+
+    /**
+     * @brief Charset announced by a byte order mark, empty if none
+     */
+    static QByteArray fromBom(const QByteArray &body);
+
+    /**
+     * @brief Charset parameter of a Content-Type header, empty if none
+     */
+    static QByteArray fromContentType(const QByteArray &contentType);
+
+    /**
+     * @brief Charset declared by a meta tag within the first 4 KB, empty if none
+     */
+    static QByteArray fromMetaTags(const QByteArray &body);
+
+    /**
+     * @brief Normalize a charset label (case, aliases, GBK family)
+     */
+    static QByteArray normalize(const QByteArray &label);
+
+    /**
+     * @brief Whether a label denotes UTF-8 (an empty label is treated as UTF-8)
+     */
+    static bool isUtf8(const QByteArray &charset);
+
+    /**
+     * @brief Decode bytes to QString, falling back to UTF-8 for unknown labels
+     */
+    static QString decode(const QByteArray &bytes, const QByteArray &charset);
+};
+
+#endif // CHARSETDETECTOR_H
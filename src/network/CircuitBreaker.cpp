@@ -0,0 +1,141 @@
+#include "CircuitBreaker.h"
+#include <QMutexLocker>
+#include <QDebug>
+
+CircuitBreaker *CircuitBreaker::instance()
+{
+    static CircuitBreaker breaker;
+    return &breaker;
+}
+
+CircuitBreaker::CircuitBreaker()
+    : m_enabled(true)
+    , m_failureThreshold(5)
+    , m_baseOpenMs(10000)
+    , m_maxOpenMs(5 * 60 * 1000)
+{
+    m_clock.start();
+}
+
+void CircuitBreaker::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_enabled = enabled;
+    if (!enabled) {
+        m_hosts.clear();
+    }
+}
+
+bool CircuitBreaker::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
+
+void CircuitBreaker::configure(int failureThreshold, int openMs, int maxOpenMs)
+{
+    QMutexLocker locker(&m_mutex);
+    m_failureThreshold = qMax(1, failureThreshold);
+    m_baseOpenMs = qMax(100, openMs);
+    m_maxOpenMs = qMax(m_baseOpenMs, maxOpenMs);
+}
+
+bool CircuitBreaker::allowRequest(const QString &host)
+{
+    const QString key = host.toLower();
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled || key.isEmpty()) {
+        return true;
+    }
+
+    auto it = m_hosts.find(key);
+    if (it == m_hosts.end() || it->state == Closed) {
+        return true;
+    }
+
+    if (it->state == Open) {
+        if (m_clock.elapsed() - it->openedAt < it->openMs) {
+            return false;
+        }
+        it->state = HalfOpen;
+        it->probeInFlight = false;
+        qDebug() << "CircuitBreaker: Half-open for" << key;
+    }
+
+    if (it->probeInFlight) {
+        return false;
+    }
+    it->probeInFlight = true;
+    return true;
+}
+
+bool CircuitBreaker::recordFailure(const QString &host)
+{
+    const QString key = host.toLower();
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled || key.isEmpty()) {
+        return false;
+    }
+
+    HostState &state = m_hosts[key];
+    state.consecutiveFailures++;
+
+    if (state.state == HalfOpen) {
+        // The probe failed: stay away twice as long
+        state.state = Open;
+        state.openMs = qMin(state.openMs * 2, m_maxOpenMs);
+        state.openedAt = m_clock.elapsed();
+        state.probeInFlight = false;
+        qDebug() << "CircuitBreaker: Probe failed for" << key << "- open for" << state.openMs << "ms";
+        return true;
+    }
+
+    if (state.state == Closed && state.consecutiveFailures >= m_failureThreshold) {
+        state.state = Open;
+        state.openMs = m_baseOpenMs;
+        state.openedAt = m_clock.elapsed();
+        qDebug() << "CircuitBreaker: Opened for" << key << "after" << state.consecutiveFailures
+                 << "failures - open for" << state.openMs << "ms";
+        return true;
+    }
+    return false;
+}
+
+void CircuitBreaker::recordSuccess(const QString &host)
+{
+    const QString key = host.toLower();
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_hosts.find(key);
+    if (it == m_hosts.end()) {
+        return;
+    }
+    if (it->state != Closed) {
+        qDebug() << "CircuitBreaker: Closed for" << key;
+    }
+    m_hosts.erase(it);
+}
+
+CircuitBreaker::State CircuitBreaker::state(const QString &host) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hosts.value(host.toLower()).state;
+}
+
+int CircuitBreaker::remainingOpenMs(const QString &host) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_hosts.constFind(host.toLower());
+    if (it == m_hosts.constEnd() || it->state != Open) {
+        return 0;
+    }
+    return int(qMax<qint64>(0, it->openedAt + it->openMs - m_clock.elapsed()));
+}
+
+void CircuitBreaker::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hosts.clear();
+}
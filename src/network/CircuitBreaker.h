@@ -0,0 +1,83 @@
+#ifndef CIRCUITBREAKER_H
+#define CIRCUITBREAKER_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+
+/**
+ * @brief Per-host circuit breaker consulted by NetworkDispatcher
+ *
+ * Closed: requests flow, consecutive failures are counted. After
+ * failureThreshold of them the host is Open: requests fail immediately for a
+ * cool-down that doubles on every failed probe. When the cool-down expires the
+ * host is HalfOpen and exactly one probe (a background probe from the
+ * dispatcher, or the next real request) decides between Closed and Open.
+ * Thread-safe.
+ */
+class CircuitBreaker
+{
+public:
+    enum State {
+        Closed,
+        Open,
+        HalfOpen
+    };
+
+    static CircuitBreaker *instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * @param failureThreshold Consecutive failures that open the circuit
+     * @param openMs First cool-down; doubled per failed probe up to maxOpenMs
+     */
+    void configure(int failureThreshold, int openMs, int maxOpenMs);
+
+    /**
+     * @brief Whether a request to this host may be sent now
+     *
+     * In HalfOpen the first caller is let through as the probe; everyone else
+     * is refused until that probe is recorded.
+     */
+    bool allowRequest(const QString &host);
+
+    /**
+     * @brief Record a request outcome
+     * @return true if this failure just opened the circuit
+     */
+    bool recordFailure(const QString &host);
+    void recordSuccess(const QString &host);
+
+    State state(const QString &host) const;
+
+    /**
+     * @brief Milliseconds until an open host may be probed, 0 if not open
+     */
+    int remainingOpenMs(const QString &host) const;
+
+    void reset();
+
+private:
+    CircuitBreaker();
+
+    struct HostState {
+        State state = Closed;
+        int consecutiveFailures = 0;
+        int openMs = 0;                 // Current cool-down
+        qint64 openedAt = 0;            // On m_clock, ms
+        bool probeInFlight = false;
+    };
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    bool m_enabled;
+    int m_failureThreshold;
+    int m_baseOpenMs;
+    int m_maxOpenMs;
+    QHash<QString, HostState> m_hosts;
+};
+
+#endif // CIRCUITBREAKER_H
@@ -0,0 +1,271 @@
+#include "ContentDecoder.h"
+#include <QDebug>
+
+#ifdef HUYAN_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef HUYAN_HAVE_BROTLI
+#include <brotli/decode.h>
+#endif
+
+namespace {
+
+const int kOutputChunk = 64 * 1024;
+
+} // namespace
+
+ContentDecoder::ContentDecoder(const QByteArray &contentEncoding)
+    : m_encoding(Unsupported)
+    , m_finished(false)
+    , m_truncated(false)
+    , m_zstream(nullptr)
+    , m_brotli(nullptr)
+{
+    const QByteArray coding = contentEncoding.trimmed().toLower();
+
+    if (coding.isEmpty() || coding == "identity") {
+        m_encoding = Identity;
+    } else if (coding == "gzip" || coding == "x-gzip") {
+        m_encoding = Gzip;
+    } else if (coding == "deflate") {
+        m_encoding = Deflate;
+    } else if (coding == "br") {
+        m_encoding = Brotli;
+    }
+
+#ifndef HUYAN_HAVE_ZLIB
+    if (m_encoding == Gzip || m_encoding == Deflate) {
+        m_encoding = Unsupported;
+    }
+#endif
+
+#ifdef HUYAN_HAVE_BROTLI
+    if (m_encoding == Brotli) {
+        m_brotli = BrotliDecoderCreateInstance(nullptr, nullptr, nullptr);
+        if (!m_brotli) {
+            m_error = "Failed to create brotli decoder";
+        }
+    }
+#else
+    if (m_encoding == Brotli) {
+        m_encoding = Unsupported;
+    }
+#endif
+
+    if (m_encoding == Unsupported) {
+        m_error = QString("Unsupported Content-Encoding: %1").arg(QString::fromLatin1(contentEncoding));
+    }
+}
+
+ContentDecoder::~ContentDecoder()
+{
+#ifdef HUYAN_HAVE_ZLIB
+    if (m_zstream) {
+        z_stream *stream = static_cast<z_stream*>(m_zstream);
+        inflateEnd(stream);
+        delete stream;
+    }
+#endif
+
+#ifdef HUYAN_HAVE_BROTLI
+    if (m_brotli) {
+        BrotliDecoderDestroyInstance(static_cast<BrotliDecoderState*>(m_brotli));
+    }
+#endif
+}
+
+QByteArray ContentDecoder::acceptEncoding()
+{
+#if defined(HUYAN_HAVE_ZLIB) && defined(HUYAN_HAVE_BROTLI)
+    return "gzip, deflate, br";
+#elif defined(HUYAN_HAVE_ZLIB)
+    return "gzip, deflate";
+#else
+    return QByteArray();
+#endif
+}
+
+bool ContentDecoder::isAvailable()
+{
+    // Brotli alone is not enough: servers that ignore "br" would fall back to
+    // gzip, which must then still be decodable
+#ifdef HUYAN_HAVE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool ContentDecoder::decode(const QByteArray &chunk, QByteArray *output)
+{
+    if (hasError()) {
+        return false;
+    }
+    if (chunk.isEmpty()) {
+        return true;
+    }
+
+    switch (m_encoding) {
+    case Identity:
+        output->append(chunk);
+        return true;
+    case Gzip:
+    case Deflate:
+        return decodeZlib(chunk, output);
+    case Brotli:
+        return decodeBrotli(chunk, output);
+    case Unsupported:
+        break;
+    }
+    return false;
+}
+
+bool ContentDecoder::finish(QByteArray *output)
+{
+    Q_UNUSED(output);
+
+    if (hasError()) {
+        return false;
+    }
+    if (m_encoding == Identity) {
+        return true;
+    }
+
+    // Many novel sites close gzip streams without the trailer; the caller keeps
+    // what was inflated instead of throwing the page away, but must not cache it
+    if (!m_finished && (m_zstream || m_brotli)) {
+        qDebug() << "ContentDecoder: Compressed stream ended without end marker";
+        m_truncated = true;
+        return false;
+    }
+    return true;
+}
+
+bool ContentDecoder::initializeZlib(const QByteArray &firstChunk)
+{
+#ifdef HUYAN_HAVE_ZLIB
+    z_stream *stream = new z_stream();
+    stream->zalloc = Z_NULL;
+    stream->zfree = Z_NULL;
+    stream->opaque = Z_NULL;
+
+    int windowBits = 15 + 32;   // Auto-detect gzip or zlib header
+    if (m_encoding == Deflate && firstChunk.size() >= 2) {
+        // "deflate" is supposed to be zlib-wrapped, but some servers send a raw stream
+        const unsigned char cmf = static_cast<unsigned char>(firstChunk[0]);
+        const unsigned char flg = static_cast<unsigned char>(firstChunk[1]);
+        const bool zlibHeader = (cmf & 0x0F) == 8 && ((cmf << 8) | flg) % 31 == 0;
+        if (!zlibHeader) {
+            windowBits = -15;
+        }
+    }
+
+    if (inflateInit2(stream, windowBits) != Z_OK) {
+        delete stream;
+        m_error = "Failed to initialize zlib";
+        return false;
+    }
+
+    m_zstream = stream;
+    return true;
+#else
+    Q_UNUSED(firstChunk);
+    m_error = "zlib support not compiled in";
+    return false;
+#endif
+}
+
+bool ContentDecoder::decodeZlib(const QByteArray &chunk, QByteArray *output)
+{
+#ifdef HUYAN_HAVE_ZLIB
+    if (!m_zstream && !initializeZlib(chunk)) {
+        return false;
+    }
+    if (m_finished) {
+        return true;    // Trailing garbage after the stream end is ignored
+    }
+
+    z_stream *stream = static_cast<z_stream*>(m_zstream);
+    stream->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(chunk.constData()));
+    stream->avail_in = static_cast<uInt>(chunk.size());
+
+    // Keep going while input remains or the last pass filled the whole output chunk
+    do {
+        const int oldSize = output->size();
+        output->resize(oldSize + kOutputChunk);
+        stream->next_out = reinterpret_cast<Bytef*>(output->data() + oldSize);
+        stream->avail_out = kOutputChunk;
+
+        const int status = inflate(stream, Z_NO_FLUSH);
+        output->resize(oldSize + kOutputChunk - static_cast<int>(stream->avail_out));
+
+        if (status == Z_STREAM_END) {
+            if (stream->avail_in > 0 && m_encoding == Gzip) {
+                // Concatenated gzip members
+                inflateReset(stream);
+                continue;
+            }
+            m_finished = true;
+            break;
+        }
+        if (status == Z_BUF_ERROR) {
+            break;      // No progress possible until more input arrives
+        }
+        if (status != Z_OK) {
+            m_error = QString("zlib inflate failed: %1").arg(stream->msg ? stream->msg : "unknown error");
+            return false;
+        }
+    } while (stream->avail_in > 0 || stream->avail_out == 0);
+    return true;
+#else
+    Q_UNUSED(chunk);
+    Q_UNUSED(output);
+    return false;
+#endif
+}
+
+bool ContentDecoder::decodeBrotli(const QByteArray &chunk, QByteArray *output)
+{
+#ifdef HUYAN_HAVE_BROTLI
+    if (!m_brotli) {
+        return false;
+    }
+    if (m_finished) {
+        return true;
+    }
+
+    BrotliDecoderState *state = static_cast<BrotliDecoderState*>(m_brotli);
+    size_t availableIn = static_cast<size_t>(chunk.size());
+    const uint8_t *nextIn = reinterpret_cast<const uint8_t*>(chunk.constData());
+
+    for (;;) {
+        const int oldSize = output->size();
+        output->resize(oldSize + kOutputChunk);
+        size_t availableOut = kOutputChunk;
+        uint8_t *nextOut = reinterpret_cast<uint8_t*>(output->data() + oldSize);
+
+        const BrotliDecoderResult result = BrotliDecoderDecompressStream(
+            state, &availableIn, &nextIn, &availableOut, &nextOut, nullptr);
+        output->resize(oldSize + kOutputChunk - static_cast<int>(availableOut));
+
+        if (result == BROTLI_DECODER_RESULT_SUCCESS) {
+            m_finished = true;
+            return true;
+        }
+        if (result == BROTLI_DECODER_RESULT_NEEDS_MORE_INPUT) {
+            return true;
+        }
+        if (result == BROTLI_DECODER_RESULT_ERROR) {
+            m_error = QString("Brotli decode failed: %1")
+                .arg(BrotliDecoderErrorString(BrotliDecoderGetErrorCode(state)));
+            return false;
+        }
+        // BROTLI_DECODER_RESULT_NEEDS_MORE_OUTPUT: loop with a fresh output chunk
+    }
+#else
+    Q_UNUSED(chunk);
+    Q_UNUSED(output);
+    return false;
+#endif
+}
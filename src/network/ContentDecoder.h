@@ -0,0 +1,77 @@
+#ifndef CONTENTDECODER_H
+#define CONTENTDECODER_H
+
+#include <QByteArray>
+#include <QString>
+
+/**
+ * @brief Streaming decoder for HTTP Content-Encoding (gzip, deflate, brotli)
+ *
+ * Used by NetworkDispatcher when HttpClient negotiates compression itself, so
+ * the compressed bytes can be counted before they are inflated. gzip/deflate
+ * need zlib (HUYAN_HAVE_ZLIB), brotli needs libbrotlidec (HUYAN_HAVE_BROTLI).
+ * Without zlib no encoding is advertised and Qt's built-in gzip support is used.
+ */
+class ContentDecoder
+{
+public:
+    enum Encoding {
+        Identity,
+        Gzip,
+        Deflate,
+        Brotli,
+        Unsupported
+    };
+
+    /**
+     * @param contentEncoding Raw Content-Encoding response header
+     */
+    explicit ContentDecoder(const QByteArray &contentEncoding);
+    ~ContentDecoder();
+
+    ContentDecoder(const ContentDecoder &) = delete;
+    ContentDecoder &operator=(const ContentDecoder &) = delete;
+
+    /**
+     * @brief Accept-Encoding value for the codecs compiled in, empty if none
+     */
+    static QByteArray acceptEncoding();
+
+    /**
+     * @brief Whether compression can be negotiated by HttpClient at all
+     */
+    static bool isAvailable();
+
+    Encoding encoding() const { return m_encoding; }
+
+    /**
+     * @brief Decode one chunk of the body, appending the result to output
+     * @return false on corrupt input or an unsupported encoding
+     */
+    bool decode(const QByteArray &chunk, QByteArray *output);
+
+    /**
+     * @brief Flush the decoder at the end of the body
+     * @return false if the stream was truncated or corrupt; a truncated
+     *         stream is not an error, what was decoded so far stays usable
+     */
+    bool finish(QByteArray *output);
+
+    bool hasError() const { return !m_error.isEmpty(); }
+    bool isTruncated() const { return m_truncated; }
+    QString errorString() const { return m_error; }
+
+private:
+    bool initializeZlib(const QByteArray &firstChunk);
+    bool decodeZlib(const QByteArray &chunk, QByteArray *output);
+    bool decodeBrotli(const QByteArray &chunk, QByteArray *output);
+
+    Encoding m_encoding;
+    bool m_finished;        // Compressed stream reached its end marker
+    bool m_truncated;       // Body ended before the end marker
+    QString m_error;
+    void *m_zstream;        // z_stream*, created on the first chunk
+    void *m_brotli;         // BrotliDecoderState*
+};
+
+#endif // CONTENTDECODER_H
@@ -0,0 +1,89 @@
+#include "DnsCache.h"
+#include <QHostInfo>
+#include <QPointer>
+#include <QMetaObject>
+#include <QDebug>
+
+DnsCache *DnsCache::instance()
+{
+    static DnsCache cache;
+    return &cache;
+}
+
+DnsCache::DnsCache()
+    : m_ttlMs(5 * 60 * 1000)
+{
+    m_clock.start();
+}
+
+void DnsCache::resolve(const QString &host, QObject *context, ResolveCallback callback)
+{
+    const QString key = host.toLower();
+    if (key.isEmpty() || !context) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_entries.constFind(key);
+        if (it != m_entries.constEnd() && freshLocked(*it)) {
+            const bool resolved = !it->addresses.isEmpty();
+            locker.unlock();
+            QMetaObject::invokeMethod(context, [callback, resolved]() {
+                if (callback) {
+                    callback(resolved);
+                }
+            }, Qt::QueuedConnection);
+            return;
+        }
+    }
+
+    QHostInfo::lookupHost(key, context, [this, key, callback](const QHostInfo &info) {
+        Entry entry;
+        if (info.error() == QHostInfo::NoError) {
+            entry.addresses = info.addresses();
+        } else {
+            qDebug() << "DnsCache: Failed to resolve" << key << "-" << info.errorString();
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            entry.resolvedAt = m_clock.elapsed();
+            m_entries.insert(key, entry);
+        }
+
+        if (callback) {
+            callback(!entry.addresses.isEmpty());
+        }
+    });
+}
+
+bool DnsCache::lookup(const QString &host, QList<QHostAddress> *addresses) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(host.toLower());
+    if (it == m_entries.constEnd() || !freshLocked(*it) || it->addresses.isEmpty()) {
+        return false;
+    }
+    if (addresses) {
+        *addresses = it->addresses;
+    }
+    return true;
+}
+
+void DnsCache::setTtl(int seconds)
+{
+    QMutexLocker locker(&m_mutex);
+    m_ttlMs = qMax(0, seconds) * 1000;
+}
+
+void DnsCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+}
+
+bool DnsCache::freshLocked(const Entry &entry) const
+{
+    return m_clock.elapsed() - entry.resolvedAt < m_ttlMs;
+}
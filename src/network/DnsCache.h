@@ -0,0 +1,59 @@
+#ifndef DNSCACHE_H
+#define DNSCACHE_H
+
+#include <QObject>
+#include <QString>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QHostAddress>
+#include <QElapsedTimer>
+#include <functional>
+
+/**
+ * @brief Small cache of host name resolutions used for connection warm-up
+ *
+ * Lookups go through QHostInfo, which also primes Qt's own short-lived
+ * resolver cache used by QNetworkAccessManager. Results (including failures)
+ * are kept for a TTL so repeated warm-ups neither re-resolve nor retry
+ * hosts that are known to be dead. Thread-safe.
+ */
+class DnsCache
+{
+public:
+    using ResolveCallback = std::function<void(bool resolved)>;
+
+    static DnsCache *instance();
+
+    /**
+     * @brief Resolve a host, answering from the cache when possible
+     * @param context Object whose thread runs the callback; the callback is dropped if it is destroyed
+     */
+    void resolve(const QString &host, QObject *context, ResolveCallback callback);
+
+    /**
+     * @brief Cached addresses for a host
+     * @return false if the host is unknown, expired or failed to resolve
+     */
+    bool lookup(const QString &host, QList<QHostAddress> *addresses) const;
+
+    void setTtl(int seconds);
+    void clear();
+
+private:
+    DnsCache();
+
+    struct Entry {
+        QList<QHostAddress> addresses;  // Empty if resolution failed
+        qint64 resolvedAt = 0;          // On m_clock, ms
+    };
+
+    bool freshLocked(const Entry &entry) const;
+
+    mutable QMutex m_mutex;
+    QElapsedTimer m_clock;
+    int m_ttlMs;
+    QHash<QString, Entry> m_entries;
+};
+
+#endif // DNSCACHE_H
@@ -0,0 +1,253 @@
+#include "FixtureArchive.h"
+#include <QMutexLocker>
+#include <QCryptographicHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSaveFile>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+
+FixtureArchive::FixtureArchive(const QString &directory)
+    : m_directory(directory)
+    , m_dirty(false)
+{
+}
+
+FixtureArchive::~FixtureArchive()
+{
+    QString error;
+    if (!save(&error)) {
+        qDebug() << "FixtureArchive: Failed to write index for" << m_directory << "-" << error;
+    }
+}
+
+bool FixtureArchive::load(QString *error)
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+    m_byUrl.clear();
+
+    QFile file(QDir(m_directory).filePath("index.json"));
+    if (!file.exists()) {
+        return true;
+    }
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = QString("Cannot open %1: %2").arg(file.fileName(), file.errorString());
+        }
+        return false;
+    }
+
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll(), &parseError);
+    if (!doc.isObject()) {
+        if (error) {
+            *error = QString("Invalid fixture index %1: %2").arg(file.fileName(), parseError.errorString());
+        }
+        return false;
+    }
+
+    const QJsonArray entries = doc.object()["entries"].toArray();
+    for (const QJsonValue &value : entries) {
+        const QJsonObject json = value.toObject();
+        Entry entry;
+        entry.method = json["method"].toString("GET").toUpper().toLatin1();
+        entry.url = QUrl(json["url"].toString());
+        entry.requestBody = json["requestBody"].toString().toUtf8();
+        entry.statusCode = json["status"].toInt(200);
+        entry.bodyFile = json["bodyFile"].toString();
+
+        const QJsonArray headers = json["headers"].toArray();
+        for (const QJsonValue &header : headers) {
+            const QJsonArray pair = header.toArray();
+            if (pair.size() == 2) {
+                entry.headers.append(qMakePair(pair[0].toString().toLatin1(), pair[1].toString().toUtf8()));
+            }
+        }
+
+        if (!entry.url.isValid()) {
+            qDebug() << "FixtureArchive: Skipping entry with invalid URL" << json["url"].toString();
+            continue;
+        }
+        m_byUrl[urlKey(entry.method, entry.url)].append(m_entries.size());
+        m_entries.append(entry);
+    }
+
+    qDebug() << "FixtureArchive: Loaded" << m_entries.size() << "fixtures from" << m_directory;
+    return true;
+}
+
+bool FixtureArchive::record(const QByteArray &method, const QUrl &url, const QByteArray &requestBody,
+                            const HttpResponse &response, QString *error)
+{
+    Entry entry;
+    entry.method = method.toUpper();
+    entry.url = url;
+    entry.requestBody = requestBody;
+    entry.statusCode = response.statusCode > 0 ? response.statusCode : 200;
+
+    // The body is stored decoded: drop headers that describe the wire form
+    for (const auto &header : response.rawHeaders) {
+        const QByteArray name = header.first.toLower();
+        if (name == "content-encoding" || name == "content-length" || name == "transfer-encoding"
+            || name == "connection") {
+            continue;
+        }
+        entry.headers.append(header);
+    }
+
+    const QByteArray key = urlKey(entry.method, url).toUtf8() + '\n' + requestBody;
+    entry.bodyFile = QString("bodies/%1.bin")
+        .arg(QString::fromLatin1(QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex()));
+
+    QMutexLocker locker(&m_mutex);
+
+    QDir dir(m_directory);
+    if (!dir.mkpath("bodies")) {
+        if (error) {
+            *error = QString("Cannot create %1").arg(dir.filePath("bodies"));
+        }
+        return false;
+    }
+
+    QSaveFile bodyFile(dir.filePath(entry.bodyFile));
+    if (!bodyFile.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = bodyFile.errorString();
+        }
+        return false;
+    }
+    bodyFile.write(response.body);
+    if (!bodyFile.commit()) {
+        if (error) {
+            *error = bodyFile.errorString();
+        }
+        return false;
+    }
+
+    const QString indexKey = urlKey(entry.method, url);
+    bool replaced = false;
+    for (int index : m_byUrl.value(indexKey)) {
+        if (m_entries[index].requestBody == requestBody) {
+            m_entries[index] = entry;
+            replaced = true;
+            break;
+        }
+    }
+    if (!replaced) {
+        m_byUrl[indexKey].append(m_entries.size());
+        m_entries.append(entry);
+    }
+    m_dirty = true;
+    return true;
+}
+
+bool FixtureArchive::find(const QByteArray &method, const QUrl &url, const QByteArray &requestBody, Entry *entry) const
+{
+    QString bodyPath;
+    {
+        QMutexLocker locker(&m_mutex);
+        const QList<int> candidates = m_byUrl.value(urlKey(method.toUpper(), url));
+        if (candidates.isEmpty()) {
+            return false;
+        }
+
+        int match = candidates.first();
+        for (int index : candidates) {
+            if (m_entries[index].requestBody == requestBody) {
+                match = index;
+                break;
+            }
+        }
+        *entry = m_entries[match];
+        bodyPath = QDir(m_directory).filePath(entry->bodyFile);
+    }
+
+    QFile file(bodyPath);
+    if (!entry->bodyFile.isEmpty() && file.open(QIODevice::ReadOnly)) {
+        entry->body = file.readAll();
+    } else if (!entry->bodyFile.isEmpty()) {
+        qDebug() << "FixtureArchive: Missing body file" << bodyPath;
+    }
+    return true;
+}
+
+QList<FixtureArchive::Entry> FixtureArchive::entries() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries;
+}
+
+bool FixtureArchive::save(QString *error)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_dirty) {
+        return true;
+    }
+    if (!saveIndexLocked(error)) {
+        return false;
+    }
+    m_dirty = false;
+    return true;
+}
+
+int FixtureArchive::size() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
+
+QString FixtureArchive::urlKey(const QByteArray &method, const QUrl &url)
+{
+    // http and https fixtures are interchangeable: the replay server speaks plain HTTP
+    QUrl normalized = url.adjusted(QUrl::RemoveScheme | QUrl::RemoveFragment | QUrl::NormalizePathSegments);
+    normalized.setHost(url.host().toLower());
+    if (normalized.path().isEmpty()) {
+        normalized.setPath("/");
+    }
+    return QString::fromLatin1(method) + ' ' + normalized.toString(QUrl::FullyEncoded);
+}
+
+bool FixtureArchive::saveIndexLocked(QString *error) const
+{
+    QJsonArray entries;
+    for (const Entry &entry : m_entries) {
+        QJsonObject json;
+        json["method"] = QString::fromLatin1(entry.method);
+        json["url"] = entry.url.toString(QUrl::FullyEncoded);
+        if (!entry.requestBody.isEmpty()) {
+            json["requestBody"] = QString::fromUtf8(entry.requestBody);
+        }
+        json["status"] = entry.statusCode;
+
+        QJsonArray headers;
+        for (const auto &header : entry.headers) {
+            headers.append(QJsonArray{QString::fromLatin1(header.first), QString::fromUtf8(header.second)});
+        }
+        json["headers"] = headers;
+        json["bodyFile"] = entry.bodyFile;
+        entries.append(json);
+    }
+
+    QJsonObject root;
+    root["version"] = 1;
+    root["entries"] = entries;
+
+    QSaveFile file(QDir(m_directory).filePath("index.json"));
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,89 @@
+#ifndef FIXTUREARCHIVE_H
+#define FIXTUREARCHIVE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QUrl>
+#include <QList>
+#include <QPair>
+#include <QHash>
+#include <QMutex>
+#include "HttpResponse.h"
+
+/**
+ * @brief Directory of recorded HTTP exchanges, written by HttpClient's record
+ *        mode and served by tools/replay_server
+ *
+ * Layout: index.json lists the exchanges (method, URL, request body, status,
+ * headers, body file); bodies live next to it as plain files, so fixtures can
+ * also be written by hand. Bodies are stored decoded, without Content-Encoding.
+ * Thread-safe.
+ */
+class FixtureArchive
+{
+public:
+    struct Entry {
+        QByteArray method = "GET";
+        QUrl url;
+        QByteArray requestBody;                         // POST data, matched when present
+        int statusCode = 200;
+        QList<QPair<QByteArray, QByteArray>> headers;
+        QString bodyFile;                               // Relative to the archive directory
+        QByteArray body;                                // Filled by find()
+    };
+
+    explicit FixtureArchive(const QString &directory);
+    ~FixtureArchive();
+
+    QString directory() const { return m_directory; }
+
+    /**
+     * @brief Read index.json; a missing index is an empty archive
+     */
+    bool load(QString *error = nullptr);
+
+    /**
+     * @brief Add a recorded response; the index is written by save()
+     *
+     * A later recording of the same exchange replaces the earlier one.
+     * Set-Cookie headers are kept so replayed sessions get their cookies.
+     */
+    bool record(const QByteArray &method, const QUrl &url, const QByteArray &requestBody,
+                const HttpResponse &response, QString *error = nullptr);
+
+    /**
+     * @brief Find the exchange for a request, body included
+     *
+     * Matches method, URL (scheme-insensitive) and request body; if no entry has
+     * the same body, the first entry for the method and URL is used, so a
+     * fixture recorded for one search keyword answers every keyword.
+     */
+    bool find(const QByteArray &method, const QUrl &url, const QByteArray &requestBody, Entry *entry) const;
+
+    /**
+     * @brief All exchanges in index order, without their bodies
+     */
+    QList<Entry> entries() const;
+
+    /**
+     * @brief Write index.json once recording is done
+     *
+     * Exchanges recorded after the last save are also written when the
+     * archive is destroyed.
+     */
+    bool save(QString *error = nullptr);
+
+    int size() const;
+
+private:
+    static QString urlKey(const QByteArray &method, const QUrl &url);
+    bool saveIndexLocked(QString *error) const;
+
+    QString m_directory;
+    mutable QMutex m_mutex;
+    QList<Entry> m_entries;
+    QHash<QString, QList<int>> m_byUrl;     // urlKey -> indices into m_entries
+    bool m_dirty;                           // Recorded since the index was last written
+};
+
+#endif // FIXTUREARCHIVE_H
@@ -0,0 +1,446 @@
+#include "HttpCache.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocale>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+const qint64 DEFAULT_MAXIMUM_SIZE = 256LL * 1024 * 1024;
+
+qint64 nowSeconds()
+{
+    return QDateTime::currentSecsSinceEpoch();
+}
+
+} // namespace
+
+HttpCache *HttpCache::instance()
+{
+    static HttpCache cache;
+    return &cache;
+}
+
+HttpCache::HttpCache()
+    : m_enabled(true)
+    , m_loaded(false)
+    , m_maximumSize(DEFAULT_MAXIMUM_SIZE)
+    , m_totalSize(0)
+    , m_hits(0)
+    , m_revalidated(0)
+    , m_misses(0)
+{
+    m_directory = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/http";
+}
+
+void HttpCache::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_enabled = enabled;
+}
+
+bool HttpCache::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
+
+void HttpCache::setDirectory(const QString &path)
+{
+    QMutexLocker locker(&m_mutex);
+    if (path == m_directory) {
+        return;
+    }
+    m_directory = path;
+    m_entries.clear();
+    m_blobRefs.clear();
+    m_totalSize = 0;
+    m_loaded = false;
+}
+
+QString HttpCache::directory() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_directory;
+}
+
+void HttpCache::setMaximumSize(qint64 bytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maximumSize = bytes;
+    if (m_loaded) {
+        evictIfNeeded();
+    }
+}
+
+qint64 HttpCache::maximumSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maximumSize;
+}
+
+qint64 HttpCache::cacheSize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_totalSize;
+}
+
+bool HttpCache::lookup(const QUrl &url, Entry *entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled) {
+        return false;
+    }
+    ensureLoaded();
+
+    auto it = m_entries.find(keyFor(url));
+    if (it == m_entries.end()) {
+        return false;
+    }
+
+    it->lastAccess = nowSeconds();
+    if (entry) {
+        *entry = it.value();
+    }
+    return true;
+}
+
+bool HttpCache::isFresh(const Entry &entry, int ttlSeconds) const
+{
+    const qint64 now = nowSeconds();
+
+    if (ttlSeconds == Immutable) {
+        return true;
+    }
+    if (ttlSeconds >= 0) {
+        return entry.storedAt + ttlSeconds > now;
+    }
+    return entry.expiresAt > now;
+}
+
+HttpResponse HttpCache::cachedResponse(const Entry &entry)
+{
+    HttpResponse response;
+
+    QString path;
+    {
+        QMutexLocker locker(&m_mutex);
+        path = blobPath(entry.bodyHash);
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qDebug() << "HttpCache: Blob missing for" << entry.url << "- dropping entry";
+        remove(QUrl(entry.url));
+        return response;
+    }
+
+    response.success = true;
+    response.fromCache = true;
+    response.statusCode = entry.statusCode;
+    response.url = QUrl(entry.url);
+    response.contentType = entry.contentType;
+    response.body = file.readAll();
+    response.rawHeaders.append(qMakePair(QByteArray("Content-Type"), entry.contentType));
+
+    QMutexLocker locker(&m_mutex);
+    ++m_hits;
+    return response;
+}
+
+void HttpCache::store(const QUrl &url, const HttpResponse &response, int ttlSeconds)
+{
+    // An empty or truncated 200 is a failed page, not content worth keeping
+    if (!response.success || response.statusCode != 200 || response.body.isEmpty() || response.truncated) {
+        return;
+    }
+
+    const qint64 now = nowSeconds();
+    bool noStore = false;
+    const qint64 expiresAt = serverExpiry(response, now, &noStore);
+    if (noStore && ttlSeconds == UseServerHeaders) {
+        return;
+    }
+
+    Entry entry;
+    entry.url = url.toString(QUrl::FullyEncoded);
+    entry.statusCode = response.statusCode;
+    entry.contentType = response.contentType;
+    entry.etag = response.header("ETag");
+    entry.lastModified = response.header("Last-Modified");
+    entry.bodyHash = QCryptographicHash::hash(response.body, QCryptographicHash::Sha1).toHex();
+    entry.size = response.body.size();
+    entry.storedAt = now;
+    entry.expiresAt = expiresAt;
+    entry.lastAccess = now;
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled || entry.size > m_maximumSize) {
+        return;
+    }
+    ensureLoaded();
+
+    const QByteArray key = keyFor(url);
+    if (m_entries.contains(key)) {
+        removeEntryLocked(key);
+    }
+
+    // Content-addressed: only write the blob if no other entry already holds this body
+    const QString blob = blobPath(entry.bodyHash);
+    if (!m_blobRefs.contains(entry.bodyHash)) {
+        QSaveFile file(blob);
+        if (!file.open(QIODevice::WriteOnly) || file.write(response.body) != response.body.size() || !file.commit()) {
+            qDebug() << "HttpCache: Failed to write blob for" << entry.url;
+            return;
+        }
+        m_totalSize += entry.size;
+    }
+    m_blobRefs[entry.bodyHash] += 1;
+
+    m_entries.insert(key, entry);
+    writeEntryLocked(key, entry);
+    evictIfNeeded();
+}
+
+void HttpCache::markValidated(const QUrl &url, const HttpResponse &notModified)
+{
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+
+    const QByteArray key = keyFor(url);
+    auto it = m_entries.find(key);
+    if (it == m_entries.end()) {
+        return;
+    }
+
+    const qint64 now = nowSeconds();
+    bool noStore = false;
+    it->storedAt = now;
+    it->lastAccess = now;
+    it->expiresAt = serverExpiry(notModified, now, &noStore);
+    const QByteArray etag = notModified.header("ETag");
+    if (!etag.isEmpty()) {
+        it->etag = etag;
+    }
+    writeEntryLocked(key, it.value());
+    ++m_revalidated;
+}
+
+void HttpCache::remove(const QUrl &url)
+{
+    QMutexLocker locker(&m_mutex);
+    ensureLoaded();
+    const QByteArray key = keyFor(url);
+    if (m_entries.contains(key)) {
+        removeEntryLocked(key);
+    }
+}
+
+void HttpCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    QDir(m_directory).removeRecursively();
+    m_entries.clear();
+    m_blobRefs.clear();
+    m_totalSize = 0;
+    m_loaded = false;
+}
+
+qint64 HttpCache::hitCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+qint64 HttpCache::revalidatedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_revalidated;
+}
+
+qint64 HttpCache::missCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+void HttpCache::recordMiss()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_misses;
+}
+
+void HttpCache::ensureLoaded()
+{
+    if (m_loaded) {
+        return;
+    }
+    m_loaded = true;
+
+    QDir dir(m_directory);
+    dir.mkpath("entries");
+    dir.mkpath("blobs");
+
+    QDir entriesDir(dir.filePath("entries"));
+    const QStringList files = entriesDir.entryList(QStringList() << "*.json", QDir::Files);
+    for (const QString &fileName : files) {
+        QFile file(entriesDir.filePath(fileName));
+        if (!file.open(QIODevice::ReadOnly)) {
+            continue;
+        }
+        QJsonObject json = QJsonDocument::fromJson(file.readAll()).object();
+        file.close();
+
+        Entry entry;
+        entry.url = json["url"].toString();
+        entry.statusCode = json["status"].toInt(200);
+        entry.contentType = json["contentType"].toString().toUtf8();
+        entry.etag = json["etag"].toString().toUtf8();
+        entry.lastModified = json["lastModified"].toString().toUtf8();
+        entry.bodyHash = json["body"].toString().toUtf8();
+        entry.size = static_cast<qint64>(json["size"].toDouble());
+        entry.storedAt = static_cast<qint64>(json["storedAt"].toDouble());
+        entry.expiresAt = static_cast<qint64>(json["expiresAt"].toDouble());
+        entry.lastAccess = static_cast<qint64>(json["lastAccess"].toDouble());
+
+        if (entry.url.isEmpty() || entry.bodyHash.isEmpty() || !QFileInfo::exists(blobPath(entry.bodyHash))) {
+            QFile::remove(file.fileName());
+            continue;
+        }
+
+        const QByteArray key = fileName.left(fileName.length() - 5).toLatin1();
+        m_entries.insert(key, entry);
+        if (!m_blobRefs.contains(entry.bodyHash)) {
+            m_totalSize += entry.size;
+        }
+        m_blobRefs[entry.bodyHash] += 1;
+    }
+
+    qDebug() << "HttpCache: Loaded" << m_entries.size() << "entries," << m_totalSize << "bytes from" << m_directory;
+    evictIfNeeded();
+}
+
+void HttpCache::evictIfNeeded()
+{
+    if (m_totalSize <= m_maximumSize) {
+        return;
+    }
+
+    // Evict least recently used entries down to 90% of the limit to avoid evicting on every store
+    const qint64 target = m_maximumSize - m_maximumSize / 10;
+
+    QList<QPair<qint64, QByteArray>> byAccess;
+    byAccess.reserve(m_entries.size());
+    for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+        byAccess.append(qMakePair(it->lastAccess, it.key()));
+    }
+    std::sort(byAccess.begin(), byAccess.end());
+
+    int evicted = 0;
+    for (const auto &item : byAccess) {
+        if (m_totalSize <= target) {
+            break;
+        }
+        removeEntryLocked(item.second);
+        ++evicted;
+    }
+
+    qDebug() << "HttpCache: Evicted" << evicted << "entries, size now" << m_totalSize << "bytes";
+}
+
+void HttpCache::removeEntryLocked(const QByteArray &key)
+{
+    Entry entry = m_entries.take(key);
+    QFile::remove(entryPath(key));
+
+    auto ref = m_blobRefs.find(entry.bodyHash);
+    if (ref == m_blobRefs.end()) {
+        return;
+    }
+    if (--ref.value() <= 0) {
+        m_blobRefs.erase(ref);
+        QFile::remove(blobPath(entry.bodyHash));
+        m_totalSize -= entry.size;
+    }
+}
+
+void HttpCache::writeEntryLocked(const QByteArray &key, const Entry &entry)
+{
+    QJsonObject json;
+    json["url"] = entry.url;
+    json["status"] = entry.statusCode;
+    json["contentType"] = QString::fromUtf8(entry.contentType);
+    json["etag"] = QString::fromUtf8(entry.etag);
+    json["lastModified"] = QString::fromUtf8(entry.lastModified);
+    json["body"] = QString::fromLatin1(entry.bodyHash);
+    json["size"] = static_cast<double>(entry.size);
+    json["storedAt"] = static_cast<double>(entry.storedAt);
+    json["expiresAt"] = static_cast<double>(entry.expiresAt);
+    json["lastAccess"] = static_cast<double>(entry.lastAccess);
+
+    QSaveFile file(entryPath(key));
+    if (file.open(QIODevice::WriteOnly)) {
+        file.write(QJsonDocument(json).toJson(QJsonDocument::Compact));
+        file.commit();
+    }
+}
+
+QByteArray HttpCache::keyFor(const QUrl &url)
+{
+    return QCryptographicHash::hash(url.toEncoded(QUrl::RemoveFragment), QCryptographicHash::Sha1).toHex();
+}
+
+qint64 HttpCache::serverExpiry(const HttpResponse &response, qint64 now, bool *noStore)
+{
+    const QByteArray cacheControl = response.header("Cache-Control").toLower();
+    if (noStore) {
+        *noStore = cacheControl.contains("no-store");
+    }
+    if (cacheControl.contains("no-cache")) {
+        return 0;
+    }
+
+    const int maxAgePos = cacheControl.indexOf("max-age=");
+    if (maxAgePos >= 0) {
+        QByteArray value = cacheControl.mid(maxAgePos + 8);
+        int end = 0;
+        while (end < value.size() && value.at(end) >= '0' && value.at(end) <= '9') {
+            ++end;
+        }
+        bool ok = false;
+        const qint64 maxAge = value.left(end).toLongLong(&ok);
+        if (ok) {
+            return now + maxAge;
+        }
+    }
+
+    const QByteArray expires = response.header("Expires");
+    if (!expires.isEmpty()) {
+        QDateTime expiry = QLocale::c().toDateTime(QString::fromLatin1(expires).trimmed(),
+                                                    "ddd, dd MMM yyyy HH:mm:ss 'GMT'");
+        if (expiry.isValid()) {
+            expiry.setTimeSpec(Qt::UTC);
+            return expiry.toSecsSinceEpoch();
+        }
+    }
+
+    return 0;
+}
+
+QString HttpCache::entryPath(const QByteArray &key) const
+{
+    return m_directory + "/entries/" + QString::fromLatin1(key) + ".json";
+}
+
+QString HttpCache::blobPath(const QByteArray &hash) const
+{
+    return m_directory + "/blobs/" + QString::fromLatin1(hash);
+}
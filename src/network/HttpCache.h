@@ -0,0 +1,121 @@
+#ifndef HTTPCACHE_H
+#define HTTPCACHE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QUrl>
+#include <QHash>
+#include <QMutex>
+#include "HttpResponse.h"
+
+/**
+ * @brief Disk-backed HTTP response cache shared by all HttpClient instances
+ *
+ * Entries are keyed by request URL; bodies are stored content-addressed
+ * (SHA-1 of the body), so identical pages fetched through different URLs
+ * share one blob. Stale entries carrying ETag/Last-Modified are revalidated
+ * with conditional requests. The total blob size is bounded and the least
+ * recently used entries are evicted first. Thread-safe.
+ */
+class HttpCache
+{
+public:
+    /**
+     * @brief Special TTL values; any value >= 0 is a TTL in seconds
+     */
+    enum TtlPolicy {
+        UseServerHeaders = -2,  // Freshness from Cache-Control / Expires
+        Immutable = -1          // Never expires once stored
+    };
+
+    struct Entry {
+        QString url;
+        int statusCode = 200;
+        QByteArray contentType;
+        QByteArray etag;
+        QByteArray lastModified;
+        QByteArray bodyHash;    // Hex SHA-1 of the body, names the blob file
+        qint64 size = 0;        // Body size in bytes
+        qint64 storedAt = 0;    // Seconds since epoch of the last store or revalidation
+        qint64 expiresAt = 0;   // Server-provided expiry, 0 if none
+        qint64 lastAccess = 0;  // Seconds since epoch, drives LRU eviction
+
+        bool hasValidators() const { return !etag.isEmpty() || !lastModified.isEmpty(); }
+    };
+
+    static HttpCache *instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+    void setDirectory(const QString &path);
+    QString directory() const;
+    void setMaximumSize(qint64 bytes);
+    qint64 maximumSize() const;
+    qint64 cacheSize() const;
+
+    /**
+     * @brief Look up the entry stored for a URL
+     * @return true if an entry exists (fresh or stale)
+     */
+    bool lookup(const QUrl &url, Entry *entry);
+
+    /**
+     * @brief Whether an entry may be served without contacting the server
+     * @param ttlSeconds Per-request TTL override, or a TtlPolicy value
+     */
+    bool isFresh(const Entry &entry, int ttlSeconds) const;
+
+    /**
+     * @brief Build a response from a stored entry
+     * @return Response with success == false if the blob is missing or unreadable
+     */
+    HttpResponse cachedResponse(const Entry &entry);
+
+    /**
+     * @brief Store a 200 response; ignored if the server forbids it and no TTL override is set
+     */
+    void store(const QUrl &url, const HttpResponse &response, int ttlSeconds);
+
+    /**
+     * @brief Refresh an entry after the server answered 304 Not Modified
+     */
+    void markValidated(const QUrl &url, const HttpResponse &notModified);
+
+    void remove(const QUrl &url);
+    void clear();
+
+    // Statistics since startup
+    qint64 hitCount() const;
+    qint64 revalidatedCount() const;
+    qint64 missCount() const;
+    void recordMiss();
+
+private:
+    HttpCache();
+
+    void ensureLoaded();
+    void evictIfNeeded();
+    void removeEntryLocked(const QByteArray &key);
+    void writeEntryLocked(const QByteArray &key, const Entry &entry);
+    static QByteArray keyFor(const QUrl &url);
+    static qint64 serverExpiry(const HttpResponse &response, qint64 now, bool *noStore);
+    // Both read m_directory: call with m_mutex held
+    QString entryPath(const QByteArray &key) const;
+    QString blobPath(const QByteArray &hash) const;
+
+    mutable QMutex m_mutex;
+    bool m_enabled;
+    bool m_loaded;
+    QString m_directory;
+    qint64 m_maximumSize;
+    qint64 m_totalSize;
+
+    QHash<QByteArray, Entry> m_entries;     // URL key -> entry
+    QHash<QByteArray, int> m_blobRefs;      // Body hash -> number of entries using it
+
+    qint64 m_hits;
+    qint64 m_revalidated;
+    qint64 m_misses;
+};
+
+#endif // HTTPCACHE_H
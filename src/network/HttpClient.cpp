@@ -1,4 +1,7 @@
 #include "HttpClient.h"
+#include "ContentDecoder.h"
+#include "LatencyTracker.h"
+#include "FixtureArchive.h"
 #include <QNetworkCookie>
 #include <QJsonDocument>
 #include <QJsonArray>
@@ -17,7 +20,69 @@
 #include <QSslKey>
 #include <QNetworkConfiguration>
 #include <QCoreApplication>
+#include <QFutureInterface>
+#include <QSharedPointer>
+#include <QPointer>
+#include <QNetworkProxy>
+#include <memory>
+
+namespace {
+
+// Process-wide record/replay switches shared by every HttpClient
+struct FixtureMode {
+    QMutex mutex;
+    std::shared_ptr<FixtureArchive> recorder;
+    bool replaying = false;
+};
+
+FixtureMode &fixtureMode()
+{
+    static FixtureMode mode;
+    return mode;
+}
+
+// Streamed bodies larger than this go to their sink only, not into HttpCache
+const int MAX_STREAM_CACHE_BYTES = 8 * 1024 * 1024;
+
+// Passes a streamed body through to the caller's sink and keeps a copy for HttpCache
+class CachingSink : public BodySink
+{
+public:
+    explicit CachingSink(std::shared_ptr<BodySink> target) : m_target(std::move(target)) {}
+
+    void begin(const QByteArray &contentType) override {
+        m_body.clear();
+        m_complete = false;
+        m_overflow = false;
+        m_target->begin(contentType);
+    }
+
+    void write(const char *data, int size) override {
+        if (!m_overflow && m_body.size() + size <= MAX_STREAM_CACHE_BYTES) {
+            m_body.append(data, size);
+        } else {
+            m_overflow = true;
+            m_body.clear();
+        }
+        m_target->write(data, size);
+    }
 
+    void end(bool complete) override {
+        m_complete = complete;
+        m_target->end(complete);
+    }
+
+    bool isCacheable() const { return m_complete && !m_overflow; }
+    QByteArray body() const { return m_body; }
+
+private:
+    std::shared_ptr<BodySink> m_target;
+    QByteArray m_body;
+    bool m_complete = false;
+    bool m_overflow = false;
+};
+
+} // namespace
 
 const QStringList HttpClient::DEFAULT_USER_AGENTS = {
     "Mozilla/5.0 (Windows NT 10.0; Win64; x64) AppleWebKit/537.36 (KHTML, like Gecko) Chrome/126.0.0.0 Safari/537.36",
@@ -43,10 +108,11 @@ HttpClient::HttpClient(QObject *parent)
     , m_networkManager(nullptr)
     , m_cookieJar(nullptr)
     , m_timeout(15000)  // 15秒超时
-    , m_maxRetries(3)
-    , m_retryDelay(2000)
+    , m_maxBodySize(DEFAULT_MAX_BODY_SIZE)
+    , m_retryPolicy(3, 2000, 30000)
     , m_userAgents(DEFAULT_USER_AGENTS)
     , m_cookiesEnabled(true)
+    , m_cacheEnabled(true)
 {
     qDebug() << "HttpClient::HttpClient - Constructor START";
     initializeNetworkManager();
@@ -122,7 +188,7 @@ QNetworkReply* HttpClient::get(const QString &url, const QJsonObject &headers)
     handleReply(reply);
 
 
-    if (m_maxRetries > 0) {
+    if (m_retryPolicy.maxRetries() > 0) {
         RetryInfo *retryInfo = new RetryInfo();
         retryInfo->url = url;
         retryInfo->headers = headers;
@@ -142,7 +208,7 @@ QNetworkReply* HttpClient::post(const QString &url, const QByteArray &data, cons
     handleReply(reply);
     
 
-    if (m_maxRetries > 0) {
+    if (m_retryPolicy.maxRetries() > 0) {
         RetryInfo *retryInfo = new RetryInfo();
         retryInfo->url = url;
         retryInfo->data = data;
@@ -170,16 +236,40 @@ void HttpClient::setTimeout(int timeoutMs)
     m_timeout = timeoutMs;
 }
 
+void HttpClient::setMaxBodySize(qint64 maxBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxBodySize = qMax<qint64>(0, maxBytes);
+}
+
+qint64 HttpClient::maxBodySize() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxBodySize;
+}
+
 void HttpClient::setMaxRetries(int maxRetries)
 {
     QMutexLocker locker(&m_mutex);
-    m_maxRetries = maxRetries;
+    m_retryPolicy.setMaxRetries(maxRetries);
 }
 
 void HttpClient::setRetryDelay(int delayMs)
 {
     QMutexLocker locker(&m_mutex);
-    m_retryDelay = delayMs;
+    m_retryPolicy.setBaseDelayMs(delayMs);
+}
+
+void HttpClient::setRetryPolicy(const RetryPolicy &policy)
+{
+    QMutexLocker locker(&m_mutex);
+    m_retryPolicy = policy;
+}
+
+RetryPolicy HttpClient::retryPolicy() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_retryPolicy;
 }
 
 void HttpClient::setUserAgents(const QStringList &userAgents)
@@ -202,32 +292,110 @@ void HttpClient::enableCookies(bool enable)
     m_cookiesEnabled = enable;
 }
 
-void HttpClient::clearCookies()
+void HttpClient::setCacheEnabled(bool enable)
 {
-    if (m_cookieJar) {
-        m_cookieJar->setAllCookiesPublic(QList<QNetworkCookie>());
+    QMutexLocker locker(&m_mutex);
+    m_cacheEnabled = enable;
+}
+
+void HttpClient::storeInCache(const QString &url, const HttpResponse &response, const CachePolicy &cachePolicy)
+{
+    // Cache hits are already stored; replays must keep reaching the fixture server
+    if (response.fromCache || isReplaying()) {
+        return;
     }
+    HttpCache::instance()->store(QUrl(url), response, cachePolicy.ttl);
 }
 
-void HttpClient::setCookie(const QString &name, const QString &value, const QString &domain)
+bool HttpClient::startRecording(const QString &archiveDirectory, QString *error)
 {
-    if (!m_cookiesEnabled || !m_cookieJar) return;
-    
-    QNetworkCookie cookie(name.toUtf8(), value.toUtf8());
-    if (!domain.isEmpty()) {
-        cookie.setDomain(domain);
+    auto archive = std::make_shared<FixtureArchive>(archiveDirectory);
+    if (!archive->load(error)) {
+        return false;
     }
-    
-    QList<QNetworkCookie> cookies = m_cookieJar->allCookiesPublic();
-    cookies.append(cookie);
-    m_cookieJar->setAllCookiesPublic(cookies);
+
+    QMutexLocker locker(&fixtureMode().mutex);
+    fixtureMode().recorder = archive;
+    qDebug() << "HttpClient: Recording responses to" << archiveDirectory;
+    return true;
+}
+
+void HttpClient::stopRecording()
+{
+    std::shared_ptr<FixtureArchive> archive;
+    {
+        QMutexLocker locker(&fixtureMode().mutex);
+        archive.swap(fixtureMode().recorder);
+    }
+    if (!archive) {
+        return;
+    }
+
+    // The index is written once here; requests still in flight save theirs when they let go
+    QString error;
+    if (!archive->save(&error)) {
+        qDebug() << "HttpClient: Failed to write fixture index to" << archive->directory() << "-" << error;
+    } else {
+        qDebug() << "HttpClient: Recorded" << archive->size() << "responses to" << archive->directory();
+    }
+}
+
+void HttpClient::setReplayServer(const QString &host, quint16 port)
+{
+    {
+        QMutexLocker locker(&fixtureMode().mutex);
+        fixtureMode().replaying = !host.isEmpty();
+    }
+
+    if (host.isEmpty()) {
+        NetworkDispatcher::instance()->setProxy(QNetworkProxy(QNetworkProxy::NoProxy));
+    } else {
+        NetworkDispatcher::instance()->setProxy(QNetworkProxy(QNetworkProxy::HttpProxy, host, port));
+        qDebug() << "HttpClient: Replaying fixtures from" << host << port;
+    }
+}
+
+bool HttpClient::isReplaying()
+{
+    QMutexLocker locker(&fixtureMode().mutex);
+    return fixtureMode().replaying;
+}
+
+void HttpClient::prefetch(const QString &url)
+{
+    NetworkDispatcher::instance()->warmUp(QUrl(url));
+}
+
+void HttpClient::clearCookies()
+{
+    SharedCookieStore::instance()->clear();
+}
+
+bool HttpClient::setCookie(const QString &name, const QString &value, const QString &domain)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_cookiesEnabled) return false;
+    }
+
+    if (domain.isEmpty()) {
+        qWarning() << "HttpClient: Rejecting cookie" << name << "without domain";
+        return false;
+    }
+    QNetworkCookie cookie(name.toUtf8(), value.toUtf8());
+    cookie.setDomain(domain);
+    cookie.setPath("/");
+    return SharedCookieStore::instance()->insert(cookie);
 }
 
 QString HttpClient::getCookie(const QString &name, const QString &domain) const
 {
-    if (!m_cookiesEnabled || !m_cookieJar) return QString();
-    
-    QList<QNetworkCookie> cookies = m_cookieJar->allCookiesPublic();
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_cookiesEnabled) return QString();
+    }
+
+    const QList<QNetworkCookie> cookies = SharedCookieStore::instance()->allCookies();
     for (const auto &cookie : cookies) {
         if (cookie.name() == name.toUtf8()) {
             if (domain.isEmpty() || cookie.domain() == domain) {
@@ -241,13 +409,13 @@ QString HttpClient::getCookie(const QString &name, const QString &domain) const
 bool HttpClient::isRequestInProgress() const
 {
     QMutexLocker locker(&m_mutex);
-    return !m_activeReplies.isEmpty();
+    return !m_activeReplies.isEmpty() || m_pendingAsync.loadAcquire() > 0;
 }
 
 int HttpClient::getActiveRequestCount() const
 {
     QMutexLocker locker(&m_mutex);
-    return m_activeReplies.size();
+    return m_activeReplies.size() + m_pendingAsync.loadAcquire();
 }
 
 QNetworkRequest HttpClient::createRequest(const QString &url, const QJsonObject &headers)
@@ -352,7 +520,7 @@ void HttpClient::onRequestError(QNetworkReply::NetworkError error)
 
     if (m_retryMap.contains(reply)) {
         RetryInfo *retryInfo = m_retryMap[reply];
-        if (retryInfo->attempts < m_maxRetries) {
+        if (m_retryPolicy.canRetry(retryInfo->attempts) && RetryBudget::instance()->tryAcquire()) {
             retryRequest(reply);
             return;
         }
@@ -374,7 +542,7 @@ void HttpClient::onTimeout()
 
 
             retryInfo->attempts++;
-            emit retryAttempt(retryInfo->attempts, m_maxRetries);
+            emit retryAttempt(retryInfo->attempts, m_retryPolicy.maxRetries());
 
             QNetworkReply *newReply = nullptr;
             if (retryInfo->method == "GET") {
@@ -407,8 +575,10 @@ void HttpClient::retryRequest(QNetworkReply *reply)
     RetryInfo *retryInfo = m_retryMap[reply];
     retryInfo->attempts++;
 
-    qDebug() << "HttpClient: Retrying request, attempt" << retryInfo->attempts << "of" << m_maxRetries;
-    emit retryAttempt(retryInfo->attempts, m_maxRetries);
+    const int delay = m_retryPolicy.backoffDelay(retryInfo->attempts - 1);
+    qDebug() << "HttpClient: Retrying request, attempt" << retryInfo->attempts << "of" << m_retryPolicy.maxRetries()
+             << "in" << delay << "ms";
+    emit retryAttempt(retryInfo->attempts, m_retryPolicy.maxRetries());
 
 
     if (!retryInfo->timer) {
@@ -417,210 +587,344 @@ void HttpClient::retryRequest(QNetworkReply *reply)
         connect(retryInfo->timer, &QTimer::timeout, this, &HttpClient::onTimeout);
     }
 
-    retryInfo->timer->start(m_retryDelay);
+    retryInfo->timer->start(delay);
 }
 
 void HttpClient::loadCookiesFromFile(const QString &filePath)
 {
-    if (!m_cookiesEnabled || !m_cookieJar) return;
+    if (!m_cookiesEnabled) return;
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qDebug() << "HttpClient: Failed to load cookies from" << filePath;
-        return;
+    QString error;
+    if (!SharedCookieStore::instance()->load(filePath, &error)) {
+        qDebug() << "HttpClient: Failed to load cookies from" << filePath << "-" << error;
     }
+}
 
-    QByteArray data = file.readAll();
-    QJsonDocument doc = QJsonDocument::fromJson(data);
-    if (!doc.isArray()) return;
-
-    QList<QNetworkCookie> cookies;
-    QJsonArray cookieArray = doc.array();
-
-    for (const auto &value : cookieArray) {
-        QJsonObject cookieObj = value.toObject();
-        QNetworkCookie cookie(
-            cookieObj["name"].toString().toUtf8(),
-            cookieObj["value"].toString().toUtf8()
-        );
-
-        if (cookieObj.contains("domain")) {
-            cookie.setDomain(cookieObj["domain"].toString());
-        }
-        if (cookieObj.contains("path")) {
-            cookie.setPath(cookieObj["path"].toString());
-        }
+void HttpClient::saveCookiesToFile(const QString &filePath)
+{
+    if (!m_cookiesEnabled) return;
 
-        cookies.append(cookie);
+    QString error;
+    if (!SharedCookieStore::instance()->save(filePath, &error)) {
+        qDebug() << "HttpClient: Failed to save cookies to" << filePath << "-" << error;
     }
-
-    m_cookieJar->setAllCookiesPublic(cookies);
-    qDebug() << "HttpClient: Loaded" << cookies.size() << "cookies from" << filePath;
 }
 
-void HttpClient::saveCookiesToFile(const QString &filePath)
+QString HttpClient::getSync(const QString &url, const QJsonObject &headers, bool *success, QString *error)
 {
-    if (!m_cookiesEnabled || !m_cookieJar) return;
-
-    QList<QNetworkCookie> cookies = m_cookieJar->allCookiesPublic();
-    QJsonArray cookieArray;
+    return performSyncRequest("GET", url, QByteArray(), headers, success, error);
+}
 
-    for (const auto &cookie : cookies) {
-        QJsonObject cookieObj;
-        cookieObj["name"] = QString::fromUtf8(cookie.name());
-        cookieObj["value"] = QString::fromUtf8(cookie.value());
-        cookieObj["domain"] = cookie.domain();
-        cookieObj["path"] = cookie.path();
-        cookieArray.append(cookieObj);
-    }
+QString HttpClient::postSync(const QString &url, const QByteArray &data, const QJsonObject &headers, bool *success, QString *error)
+{
+    return performSyncRequest("POST", url, data, headers, success, error);
+}
 
-    QJsonDocument doc(cookieArray);
+QFuture<HttpResponse> HttpClient::getAsync(const QString &url, const QJsonObject &headers)
+{
+    return sendAsync("GET", url, QByteArray(), headers);
+}
 
-    QFile file(filePath);
-    if (!file.open(QIODevice::WriteOnly)) {
-        qDebug() << "HttpClient: Failed to save cookies to" << filePath;
-        return;
-    }
+QFuture<HttpResponse> HttpClient::getAsync(const QString &url, const QJsonObject &headers, const CachePolicy &cachePolicy)
+{
+    return sendAsync("GET", url, QByteArray(), headers, false, cachePolicy);
+}
 
-    file.write(doc.toJson());
-    qDebug() << "HttpClient: Saved" << cookies.size() << "cookies to" << filePath;
+QFuture<HttpResponse> HttpClient::postAsync(const QString &url, const QByteArray &data, const QJsonObject &headers)
+{
+    return sendAsync("POST", url, data, headers);
 }
 
+QFuture<HttpResponse> HttpClient::getHedged(const QString &url, const QJsonObject &headers)
+{
+    return sendAsync("GET", url, QByteArray(), headers, true);
+}
 
+void HttpClient::getAsync(const QString &url, const QJsonObject &headers, QObject *context, ResponseCallback callback)
+{
+    sendAsync("GET", url, QByteArray(), headers, deliverTo(context, callback));
+}
 
+void HttpClient::getAsync(const QString &url, const QJsonObject &headers, const CachePolicy &cachePolicy,
+                          QObject *context, ResponseCallback callback)
+{
+    sendAsync("GET", url, QByteArray(), headers, deliverTo(context, callback), false, nullptr, cachePolicy);
+}
 
+void HttpClient::postAsync(const QString &url, const QByteArray &data, const QJsonObject &headers, QObject *context, ResponseCallback callback)
+{
+    sendAsync("POST", url, data, headers, deliverTo(context, callback));
+}
 
-QString HttpClient::getSync(const QString &url, const QJsonObject &headers, bool *success, QString *error)
+void HttpClient::getStreaming(const QString &url, const QJsonObject &headers, std::shared_ptr<BodySink> sink,
+                              QObject *context, ResponseCallback callback, const CachePolicy &cachePolicy)
 {
-    return performSyncRequest("GET", url, QByteArray(), headers, success, error);
+    sendAsync("GET", url, QByteArray(), headers, deliverTo(context, callback), false, sink, cachePolicy);
 }
 
-QString HttpClient::postSync(const QString &url, const QByteArray &data, const QJsonObject &headers, bool *success, QString *error)
+HttpClient::ResponseCallback HttpClient::deliverTo(QObject *context, ResponseCallback callback)
 {
-    return performSyncRequest("POST", url, data, headers, success, error);
+    QPointer<QObject> guard(context);
+    return [guard, callback](const HttpResponse &response) {
+        if (!guard || !callback) {
+            return;
+        }
+        QMetaObject::invokeMethod(guard.data(), [callback, response]() {
+            callback(response);
+        }, Qt::QueuedConnection);
+    };
 }
 
-QString HttpClient::performSyncRequest(const QString &method, const QString &url, const QByteArray &data, const QJsonObject &headers, bool *success, QString *error)
+NetworkDispatcher::PendingRequest HttpClient::buildPendingRequest(const QByteArray &method, const QString &url, const QByteArray &data, const QJsonObject &headers)
 {
-    qDebug() << "HttpClient::performSyncRequest - START" << method << url;
+    NetworkDispatcher::PendingRequest pending;
+    pending.method = method;
+    pending.data = data;
 
-    // Create request
-    QNetworkRequest request;
+    QNetworkRequest &request = pending.request;
     request.setUrl(QUrl(url));
 
+    // The replay server is a plain HTTP proxy: https requests reach it as http,
+    // with the original URL attached so the recorded https fixture still matches
+    if (isReplaying()) {
+        request.setRawHeader("X-Fixture-Url", request.url().toEncoded());
+        if (request.url().scheme() == "https") {
+            QUrl plain = request.url();
+            plain.setScheme("http");
+            if (plain.port() == 443) {
+                plain.setPort(-1);
+            }
+            request.setUrl(plain);
+        }
+    }
+
     // Set default headers
     request.setRawHeader("Accept", "*/*");
     request.setRawHeader("Connection", "keep-alive");
     request.setRawHeader("User-Agent", "curl/7.68.0");
 
+    // Negotiate compression ourselves so the dispatcher sees (and counts) the
+    // compressed bytes; without zlib, Qt's implicit gzip handling stays in charge
+    if (ContentDecoder::isAvailable()) {
+        request.setRawHeader("Accept-Encoding", ContentDecoder::acceptEncoding());
+    }
+
+    // The shared manager has no per-client jar: cookies are attached here and
+    // stored back in recordResponseCookies()
+    request.setAttribute(QNetworkRequest::CookieLoadControlAttribute, QNetworkRequest::Manual);
+    request.setAttribute(QNetworkRequest::CookieSaveControlAttribute, QNetworkRequest::Manual);
+
+    QMutexLocker locker(&m_mutex);
+    pending.timeoutMs = m_timeout;
+    pending.maxBodyBytes = m_maxBodySize;
+
+    // Only idempotent requests are retried by the transport; a search POST is retried by its caller
+    if (method == "GET") {
+        pending.retryPolicy = m_retryPolicy;
+    }
+
+    if (m_cookiesEnabled && !headers.contains("Cookie") && !headers.contains("cookie")) {
+        // Replays rewrite https to http: match cookies against the URL the caller asked for
+        QList<QNetworkCookie> cookies = SharedCookieStore::instance()->cookiesForUrl(QUrl(url));
+        if (!cookies.isEmpty()) {
+            request.setHeader(QNetworkRequest::CookieHeader, QVariant::fromValue(cookies));
+        }
+    }
+
     // Set custom headers
     for (auto it = headers.begin(); it != headers.end(); ++it) {
         request.setRawHeader(it.key().toUtf8(), it.value().toString().toUtf8());
         qDebug() << "HttpClient: Setting header" << it.key() << "=" << it.value().toString();
     }
 
-    qDebug() << "HttpClient: Request data:" << data;
+    return pending;
+}
 
-    // Create reply
-    QNetworkReply *reply = nullptr;
-    if (method.toLower() == "post") {
-        reply = m_networkManager->post(request, data);
-        qDebug() << "HttpClient: POST request created, reply pointer:" << reply;
-    } else {
-        reply = m_networkManager->get(request);
-        qDebug() << "HttpClient: GET request created, reply pointer:" << reply;
-    }
+void HttpClient::sendAsync(const QByteArray &method, const QString &url, const QByteArray &data, const QJsonObject &headers, ResponseCallback callback,
+                           bool hedged, std::shared_ptr<BodySink> sink, const CachePolicy &cachePolicy)
+{
+    NetworkDispatcher::PendingRequest pending = buildPendingRequest(method, url, data, headers);
+    pending.bodySink = sink;
 
-    if (!reply) {
-        qDebug() << "HttpClient: ERROR - Failed to create network request";
-        if (success) *success = false;
-        if (error) *error = "Failed to create network request";
-        return QString();
+    bool useCache = false;
+    const int cacheTtl = cachePolicy.ttl;
+    const bool storeResponse = !cachePolicy.deferStore;
+    {
+        QMutexLocker locker(&m_mutex);
+        // Replays must reach the fixture server every time to be measurable
+        useCache = m_cacheEnabled && method == "GET" && !isReplaying();
     }
 
-    // Wait for completion using event loop
-    QEventLoop loop;
-    QTimer timeoutTimer;
-    timeoutTimer.setSingleShot(true);
-    bool timedOut = false;
+    std::shared_ptr<FixtureArchive> recorder;
+    if (!sink) {
+        QMutexLocker locker(&fixtureMode().mutex);
+        recorder = fixtureMode().recorder;
+    }
+    const QUrl originalUrl(url);
+
+    // Serve fresh entries locally; send validators for stale ones
+    HttpCache *cache = HttpCache::instance();
+    const QUrl cacheUrl = pending.request.url();
+    HttpCache::Entry cached;
+    const bool haveCached = useCache && cache->lookup(cacheUrl, &cached);
+    if (haveCached && cache->isFresh(cached, cacheTtl)) {
+        HttpResponse response = cache->cachedResponse(cached);
+        if (response.success && sink) {
+            // Played into the sink on the network thread, as a transfer would be
+            qDebug() << "HttpClient: Cache hit for" << url << "(streamed)";
+            QMetaObject::invokeMethod(NetworkDispatcher::instance(), [sink, response, callback]() {
+                sink->begin(response.contentType);
+                sink->write(response.body.constData(), response.body.size());
+                sink->end(true);
+                if (callback) {
+                    HttpResponse streamed = response;
+                    streamed.body.clear();
+                    callback(streamed);
+                }
+            }, Qt::QueuedConnection);
+            return;
+        }
+        if (response.success) {
+            qDebug() << "HttpClient: Cache hit for" << url;
+            if (recorder) {
+                recorder->record(method, originalUrl, data, response);
+            }
+            if (callback) {
+                callback(response);
+            }
+            return;
+        }
+    }
+    // A 304 would leave a sink without its body: streamed requests refetch stale entries
+    if (haveCached && cached.hasValidators() && !sink) {
+        if (!cached.etag.isEmpty()) {
+            pending.request.setRawHeader("If-None-Match", cached.etag);
+        }
+        if (!cached.lastModified.isEmpty()) {
+            pending.request.setRawHeader("If-Modified-Since", cached.lastModified);
+        }
+    } else if (useCache) {
+        cache->recordMiss();
+    }
 
-    // Connect signals
-    connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-    connect(&timeoutTimer, &QTimer::timeout, [&]() {
-        timedOut = true;
-        loop.quit();
-    });
+    std::shared_ptr<CachingSink> cachingSink;
+    if (useCache && sink && storeResponse) {
+        cachingSink = std::make_shared<CachingSink>(sink);
+        pending.bodySink = cachingSink;
+    }
 
-    // Start timeout timer
-    timeoutTimer.start(m_timeout);
+    m_pendingAsync.ref();
+    QPointer<HttpClient> self(this);
+    auto onResponse = [self, callback, useCache, haveCached, cached, cacheUrl, cacheTtl, storeResponse, cachingSink,
+                       recorder, method, originalUrl, data](const HttpResponse &networkResponse) {
+        HttpResponse response = networkResponse;
+        if (useCache) {
+            HttpCache *cache = HttpCache::instance();
+            if (haveCached && response.success && response.statusCode == 304) {
+                cache->markValidated(cacheUrl, response);
+                HttpResponse revalidated = cache->cachedResponse(cached);
+                if (revalidated.success) {
+                    revalidated.cookies = response.cookies;
+                    response = revalidated;
+                }
+            } else if (storeResponse && response.success && response.statusCode == 200) {
+                if (!cachingSink) {
+                    cache->store(cacheUrl, response, cacheTtl);
+                } else if (cachingSink->isCacheable()) {
+                    HttpResponse streamed = response;
+                    streamed.body = cachingSink->body();
+                    cache->store(cacheUrl, streamed, cacheTtl);
+                }
+            }
+        }
 
-    qDebug() << "HttpClient: Starting event loop, timeout:" << m_timeout << "ms";
-    loop.exec();
+        // Record every answered exchange, error pages included; transport failures have nothing to replay
+        if (recorder && response.statusCode > 0 && response.statusCode != 304) {
+            QString recordError;
+            if (!recorder->record(method, originalUrl, data, response, &recordError)) {
+                qDebug() << "HttpClient: Failed to record fixture for" << originalUrl.toString() << "-" << recordError;
+            }
+        }
 
-    // Stop timer
-    timeoutTimer.stop();
+        if (self) {
+            self->recordResponseCookies(response);
+            self->m_pendingAsync.deref();
+        }
+        if (callback) {
+            callback(response);
+        }
+    };
 
-    // Check for timeout
-    if (timedOut) {
-        qDebug() << "HttpClient: Request timed out";
-        reply->abort();
-        reply->deleteLater();
-        if (success) *success = false;
-        if (error) *error = "Request timeout";
-        return QString();
+    if (hedged && method == "GET") {
+        // Hosts without history get a duplicate after 3 seconds
+        const int hedgeAfter = LatencyTracker::instance()->hedgeDelay(cacheUrl.host(), 3000);
+        NetworkDispatcher::instance()->dispatchHedged(pending, hedgeAfter, onResponse);
+    } else {
+        NetworkDispatcher::instance()->dispatch(pending, onResponse);
     }
+}
 
-    // Process response
-    bool requestSuccess = (reply->error() == QNetworkReply::NoError);
-    QString response;
-    QString requestError;
+QFuture<HttpResponse> HttpClient::sendAsync(const QByteArray &method, const QString &url, const QByteArray &data, const QJsonObject &headers,
+                                             bool hedged, const CachePolicy &cachePolicy)
+{
+    QSharedPointer<QFutureInterface<HttpResponse>> promise(new QFutureInterface<HttpResponse>());
+    promise->reportStarted();
+    QFuture<HttpResponse> future = promise->future();
 
-    qDebug() << "HttpClient: Request finished with error code:" << reply->error();
+    sendAsync(method, url, data, headers, [promise](const HttpResponse &response) {
+        promise->reportResult(response);
+        promise->reportFinished();
+    }, hedged, nullptr, cachePolicy);
 
-    // Check for redirects
-    int statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
-    QUrl finalUrl = reply->url();
-    QUrl originalUrl = reply->request().url();
+    return future;
+}
 
-    qDebug() << "HttpClient: HTTP status code:" << statusCode;
-    qDebug() << "HttpClient: Original URL:" << originalUrl.toString();
-    qDebug() << "HttpClient: Final URL:" << finalUrl.toString();
+void HttpClient::recordResponseCookies(const HttpResponse &response)
+{
+    QMutexLocker locker(&m_mutex);
+    m_lastResponseCookies = response.cookies;
 
-    if (originalUrl != finalUrl) {
-        qDebug() << "HttpClient: Redirect detected - from" << originalUrl.toString() << "to" << finalUrl.toString();
+    if (!response.cookies.isEmpty()) {
+        qDebug() << "HttpClient: Captured" << response.cookies.size() << "response cookies";
+        if (m_cookiesEnabled) {
+            SharedCookieStore::instance()->setCookiesFromUrl(response.cookies, response.url);
+        }
     }
+}
 
-    if (requestSuccess) {
-        response = QString::fromUtf8(reply->readAll());
-        qDebug() << "HttpClient: SUCCESS - Response length:" << response.length();
-    } else {
-        requestError = reply->errorString();
-        qDebug() << "HttpClient: ERROR -" << requestError;
+QString HttpClient::performSyncRequest(const QString &method, const QString &url, const QByteArray &data, const QJsonObject &headers, bool *success, QString *error)
+{
+    qDebug() << "HttpClient::performSyncRequest - START" << method << url;
+    qDebug() << "HttpClient: Request data:" << data;
+
+    // Blocks the calling thread outright; the reply itself is driven by the network thread,
+    // so no nested event loop re-enters the caller. For worker threads only: the GUI thread
+    // uses the callback overloads. Must not be called from a response callback.
+    QFuture<HttpResponse> future = sendAsync(method.toUpper().toUtf8(), url, data, headers);
+    future.waitForFinished();
+    HttpResponse response = future.result();
+
+    qDebug() << "HttpClient: HTTP status code:" << response.statusCode;
+    if (response.url != QUrl(url)) {
+        qDebug() << "HttpClient: Redirect detected - from" << url << "to" << response.url.toString();
     }
 
-    // Capture response cookies for later extraction
-    QVariant cookieVar = reply->header(QNetworkRequest::SetCookieHeader);
-    if (cookieVar.isValid()) {
-        m_lastResponseCookies = qvariant_cast<QList<QNetworkCookie>>(cookieVar);
-        qDebug() << "HttpClient: Captured" << m_lastResponseCookies.size() << "response cookies";
+    QString text;
+    if (response.success) {
+        text = response.text();
+        qDebug() << "HttpClient: SUCCESS - Response length:" << text.length();
     } else {
-        m_lastResponseCookies.clear();
+        qDebug() << "HttpClient: ERROR -" << response.error;
     }
 
-    // Clean up
-    reply->deleteLater();
-
-    qDebug() << "HttpClient: Final result - Success:" << requestSuccess
-             << "Error:" << requestError
-             << "Response length:" << response.length();
+    if (success) *success = response.success;
+    if (error) *error = response.error;
 
-    if (success) *success = requestSuccess;
-    if (error) *error = requestError;
-
-    return response;
+    return text;
 }
 
 QList<QNetworkCookie> HttpClient::getLastResponseCookies() const
 {
+    QMutexLocker locker(&m_mutex);
     return m_lastResponseCookies;
 }
@@ -16,37 +16,40 @@
 #include <QSslError>
 #include <QEventLoop>
 #include <QMetaObject>
-
-/**
- * @brief Custom Cookie manager providing public access interface
- */
-class CustomCookieJar : public QNetworkCookieJar
-{
-public:
-    explicit CustomCookieJar(QObject *parent = nullptr) : QNetworkCookieJar(parent) {}
-
-    // Public interface
-    void setAllCookiesPublic(const QList<QNetworkCookie> &cookieList) {
-        setAllCookies(cookieList);
-    }
-
-    QList<QNetworkCookie> allCookiesPublic() const {
-        return allCookies();
-    }
-};
-
-
+#include <QFuture>
+#include <functional>
+#include <memory>
+#include "HttpResponse.h"
+#include "NetworkDispatcher.h"
+#include "HttpCache.h"
+#include "RetryPolicy.h"
+#include "BodySink.h"
+#include "SharedCookieStore.h"
 
 /**
  * @brief HTTP client class, wrapping QNetworkAccessManager
  * Provides GET/POST requests, Cookie management, User-Agent rotation, error handling and retry mechanism
- * Uses simple synchronous requests in main thread for reliability
+ * Async and synchronous requests are driven by the shared NetworkDispatcher thread;
+ * the client must outlive the requests it issues
  */
 class HttpClient : public QObject
 {
     Q_OBJECT
 
 public:
+    using ResponseCallback = std::function<void(const HttpResponse &)>;
+
+    /**
+     * @brief Response cache settings of one GET request
+     */
+    struct CachePolicy {
+        int ttl = HttpCache::UseServerHeaders;  // TTL in seconds or an HttpCache::TtlPolicy value
+        bool deferStore = false;                // Caller stores with storeInCache() once it has checked the content
+
+        CachePolicy() = default;
+        CachePolicy(int ttlSeconds, bool deferred = false) : ttl(ttlSeconds), deferStore(deferred) {}
+    };
+
     explicit HttpClient(QObject *parent = nullptr);
     ~HttpClient();
 
@@ -55,7 +58,31 @@ public:
     QNetworkReply* post(const QString &url, const QByteArray &data, const QJsonObject &headers = QJsonObject());
     QNetworkReply* post(const QString &url, const QJsonObject &formData, const QJsonObject &headers = QJsonObject());
 
-    // Thread-safe synchronous methods
+    // Asynchronous methods served by the shared network thread
+    QFuture<HttpResponse> getAsync(const QString &url, const QJsonObject &headers = QJsonObject());
+    QFuture<HttpResponse> getAsync(const QString &url, const QJsonObject &headers, const CachePolicy &cachePolicy);
+    QFuture<HttpResponse> postAsync(const QString &url, const QByteArray &data, const QJsonObject &headers = QJsonObject());
+
+    // Hedged GET: a duplicate is sent if the host has not answered by its p90 latency
+    // (LatencyTracker), and the first successful response wins. For latency-critical requests;
+    // there is no POST variant, a POST may not be idempotent.
+    QFuture<HttpResponse> getHedged(const QString &url, const QJsonObject &headers = QJsonObject());
+
+    // Callback variants: callback is invoked on the thread of context, dropped if context is destroyed.
+    // Cache hits complete without touching the network.
+    void getAsync(const QString &url, const QJsonObject &headers, QObject *context, ResponseCallback callback);
+    void getAsync(const QString &url, const QJsonObject &headers, const CachePolicy &cachePolicy,
+                  QObject *context, ResponseCallback callback);
+    void postAsync(const QString &url, const QByteArray &data, const QJsonObject &headers, QObject *context, ResponseCallback callback);
+
+    // Streaming GET: the body goes to sink as it arrives (on the network thread) and the
+    // response passed to callback has an empty body. Cache hits are played into the sink;
+    // stale entries are refetched in full rather than revalidated.
+    void getStreaming(const QString &url, const QJsonObject &headers, std::shared_ptr<BodySink> sink,
+                      QObject *context, ResponseCallback callback, const CachePolicy &cachePolicy = CachePolicy());
+
+    // Thread-safe synchronous methods (block the calling thread on the async API, never the network thread).
+    // Each call holds its thread for the whole request: use them on pool threads, not the GUI thread
     QString getSync(const QString &url, const QJsonObject &headers = QJsonObject(), bool *success = nullptr, QString *error = nullptr);
     QString postSync(const QString &url, const QByteArray &data, const QJsonObject &headers = QJsonObject(), bool *success = nullptr, QString *error = nullptr);
 
@@ -64,13 +91,44 @@ public:
 
     void setTimeout(int timeoutMs);
     void setMaxRetries(int maxRetries);
-    void setRetryDelay(int delayMs);
+    void setRetryDelay(int delayMs);     // Base of the exponential backoff
+
+    // Transport retries (GET only) with exponential backoff and full jitter, capped by RetryBudget
+    void setRetryPolicy(const RetryPolicy &policy);
+    RetryPolicy retryPolicy() const;
     void setUserAgents(const QStringList &userAgents);
     void addUserAgent(const QString &userAgent);
     void enableCookies(bool enable = true);
     void clearCookies();
 
-    void setCookie(const QString &name, const QString &value, const QString &domain = QString());
+    // Body cap: a request whose decoded body grows past maxBytes is aborted and fails with
+    // UnknownContentError (0 disables the cap). Pages too large to hold in memory are
+    // fetched with getStreaming() and consumed as they arrive.
+    void setMaxBodySize(qint64 maxBytes);
+    qint64 maxBodySize() const;
+
+    static const qint64 DEFAULT_MAX_BODY_SIZE = 32 * 1024 * 1024;
+
+    // Response cache (GET only); requests without a CachePolicy follow the server's headers
+    void setCacheEnabled(bool enable);
+
+    // Store a response fetched with CachePolicy::deferStore, after the caller validated its content
+    static void storeInCache(const QString &url, const HttpResponse &response, const CachePolicy &cachePolicy);
+
+    // Connection warm-up: resolve and connect to the URL's host before its first request
+    void prefetch(const QString &url);
+
+    // Fixture record/replay for offline, repeatable crawl benchmarks (process-wide).
+    // Recording captures every answered request into a FixtureArchive directory and
+    // writes its index in stopRecording(); replay sends all requests through tools/replay_server as an HTTP proxy.
+    static bool startRecording(const QString &archiveDirectory, QString *error = nullptr);
+    static void stopRecording();
+    static void setReplayServer(const QString &host, quint16 port);     // Empty host: back to live sites
+    static bool isReplaying();
+
+    // Cookies live in the process-wide SharedCookieStore: every client sees (and clears) the same set
+    // A cookie needs a domain to be matched against requests: without one it is rejected (false)
+    bool setCookie(const QString &name, const QString &value, const QString &domain = QString());
     QString getCookie(const QString &name, const QString &domain = QString()) const;
     void loadCookiesFromFile(const QString &filePath);
     void saveCookiesToFile(const QString &filePath);
@@ -112,18 +170,29 @@ private:
     CustomCookieJar *m_cookieJar;
 
     int m_timeout;
-    int m_maxRetries;
-    int m_retryDelay;
+    qint64 m_maxBodySize;
+    RetryPolicy m_retryPolicy;
     QStringList m_userAgents;
     bool m_cookiesEnabled;
+    bool m_cacheEnabled;
 
     QList<QNetworkReply*> m_activeReplies;
+    QAtomicInt m_pendingAsync;
     QHash<QNetworkReply*, RetryInfo*> m_retryMap;
     mutable QMutex m_mutex;
 
     // Store last response cookies for extraction
     QList<QNetworkCookie> m_lastResponseCookies;
 
+    // Async request plumbing
+    NetworkDispatcher::PendingRequest buildPendingRequest(const QByteArray &method, const QString &url, const QByteArray &data, const QJsonObject &headers);
+    void sendAsync(const QByteArray &method, const QString &url, const QByteArray &data, const QJsonObject &headers, ResponseCallback callback,
+                   bool hedged = false, std::shared_ptr<BodySink> sink = nullptr, const CachePolicy &cachePolicy = CachePolicy());
+    QFuture<HttpResponse> sendAsync(const QByteArray &method, const QString &url, const QByteArray &data, const QJsonObject &headers,
+                                    bool hedged = false, const CachePolicy &cachePolicy = CachePolicy());
+    void recordResponseCookies(const HttpResponse &response);
+    static ResponseCallback deliverTo(QObject *context, ResponseCallback callback);
+
     // Simple synchronous network operations
     QString performSyncRequest(const QString &method, const QString &url, const QByteArray &data, const QJsonObject &headers, bool *success, QString *error);
 
@@ -0,0 +1,75 @@
+#ifndef HTTPRESPONSE_H
+#define HTTPRESPONSE_H
+
+#include <QString>
+#include <QByteArray>
+#include <QUrl>
+#include <QList>
+#include <QPair>
+#include <QNetworkCookie>
+#include <QNetworkReply>
+#include <QMetaType>
+#include "CharsetDetector.h"
+
+/**
+ * @brief Where the time of one request went, in milliseconds
+ *
+ * Phases that did not happen (cached DNS, reused connection) are 0; phases
+ * that could not be observed are -1. Qt 5 reports no separate TCP-connected
+ * event, so connectMs covers TCP connect and TLS handshake together.
+ */
+struct RequestTiming {
+    qint64 queuedMs = 0;        // Waiting for a RateLimiter slot or a retry backoff
+    qint64 dnsMs = 0;           // Host lookup before sending, 0 if cached
+    qint64 connectMs = -1;      // TCP connect + TLS handshake; 0 on a reused connection, -1 for plain HTTP
+    qint64 ttfbMs = 0;          // Request sent (connection ready) until response headers
+    qint64 bodyMs = 0;          // Response headers until the last body byte
+    qint64 totalMs = 0;         // All of the above, end to end
+};
+
+/**
+ * @brief Result of a single HTTP request issued through HttpClient
+ *
+ * Value type so it can travel through QFuture and queued connections.
+ */
+struct HttpResponse {
+    bool success = false;                     // Transport succeeded (no QNetworkReply error)
+    int statusCode = 0;                       // HTTP status code, 0 if none was received
+    QNetworkReply::NetworkError networkError = QNetworkReply::NoError;
+    QString error;                            // Human readable error, empty on success
+    QUrl url;                                 // Final URL after redirects
+    QByteArray contentType;                   // Raw Content-Type header
+    QByteArray body;                          // Raw response body
+    QList<QNetworkCookie> cookies;            // Cookies set by this response
+    QList<QPair<QByteArray, QByteArray>> rawHeaders;  // All response headers
+    bool fromCache = false;                   // Served (or revalidated) from HttpCache
+    bool truncated = false;                   // Compressed body ended early; usable, never cached
+    qint64 transferSize = 0;                  // Bytes received on the wire, before Content-Encoding decoding
+    RequestTiming timing;                     // Phase breakdown of the network round trip
+
+    /**
+     * @brief Charset of the body from BOM, Content-Type or meta tags
+     */
+    QByteArray charset() const { return CharsetDetector::detect(body, contentType); }
+
+    /**
+     * @brief Response body decoded with its detected charset
+     */
+    QString text() const { return CharsetDetector::decode(body, charset()); }
+
+    /**
+     * @brief Value of a response header, matched case-insensitively
+     */
+    QByteArray header(const QByteArray &name) const {
+        for (const auto &pair : rawHeaders) {
+            if (pair.first.compare(name, Qt::CaseInsensitive) == 0) {
+                return pair.second;
+            }
+        }
+        return QByteArray();
+    }
+};
+
+Q_DECLARE_METATYPE(HttpResponse)
+
+#endif // HTTPRESPONSE_H
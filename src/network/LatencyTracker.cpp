@@ -0,0 +1,93 @@
+#include "LatencyTracker.h"
+#include <QMutexLocker>
+#include <algorithm>
+#include <cmath>
+
+LatencyTracker *LatencyTracker::instance()
+{
+    static LatencyTracker tracker;
+    return &tracker;
+}
+
+void LatencyTracker::record(const QString &host, qint64 latencyMs)
+{
+    const QString key = host.toLower();
+    if (key.isEmpty() || latencyMs < 0) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    Samples &samples = m_hosts[key];
+    const int value = int(qMin<qint64>(latencyMs, 10 * 60 * 1000));
+    if (samples.values.size() < sampleWindow) {
+        samples.values.append(value);
+    } else {
+        samples.values[samples.next] = value;
+        samples.next = (samples.next + 1) % sampleWindow;
+    }
+}
+
+int LatencyTracker::percentile(const QString &host, double percent) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_hosts.constFind(host.toLower());
+    if (it == m_hosts.constEnd()) {
+        return -1;
+    }
+    return percentileLocked(*it, percent);
+}
+
+int LatencyTracker::sampleCount(const QString &host) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hosts.value(host.toLower()).values.size();
+}
+
+int LatencyTracker::hedgeDelay(const QString &host, int fallbackMs) const
+{
+    const int p90 = percentile(host, 90);
+    if (p90 < 0) {
+        return fallbackMs;
+    }
+    // Below ~250ms a hedge mostly doubles load for no gain
+    return qBound(250, p90, fallbackMs);
+}
+
+int LatencyTracker::deadline(const QString &host, int fallbackMs) const
+{
+    int p90 = -1;
+    int p99 = -1;
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_hosts.constFind(host.toLower());
+        if (it != m_hosts.constEnd()) {
+            p90 = percentileLocked(*it, 90);
+            p99 = percentileLocked(*it, 99);
+        }
+    }
+    if (p99 < 0) {
+        return fallbackMs;
+    }
+
+    // Leave room for a hedge sent at p90 to complete, plus parsing
+    const int deadline = qMax(p99 * 2, p90 * 3) + 1000;
+    return qBound(qMin(5000, fallbackMs), deadline, fallbackMs);
+}
+
+void LatencyTracker::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hosts.clear();
+}
+
+int LatencyTracker::percentileLocked(const Samples &samples, double percent) const
+{
+    if (samples.values.size() < minSamples) {
+        return -1;
+    }
+
+    QVector<int> sorted = samples.values;
+    std::sort(sorted.begin(), sorted.end());
+    const double rank = qBound(0.0, percent, 100.0) / 100.0 * (sorted.size() - 1);
+    return sorted[int(std::ceil(rank))];
+}
@@ -0,0 +1,62 @@
+#ifndef LATENCYTRACKER_H
+#define LATENCYTRACKER_H
+
+#include <QString>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+
+/**
+ * @brief Recent request latencies per host, used for hedging and search deadlines
+ *
+ * Keeps the last sampleWindow latencies of successful network round trips
+ * (cache hits excluded) for every host. Percentiles are computed on demand;
+ * with fewer than minSamples entries a host has no history and callers fall
+ * back to fixed values. Thread-safe.
+ */
+class LatencyTracker
+{
+public:
+    static LatencyTracker *instance();
+
+    void record(const QString &host, qint64 latencyMs);
+
+    /**
+     * @brief Latency percentile for a host
+     * @param percent 0..100
+     * @return -1 without enough history
+     */
+    int percentile(const QString &host, double percent) const;
+
+    int sampleCount(const QString &host) const;
+
+    /**
+     * @brief When to send a duplicate request: the host's p90, clamped to a sane range
+     */
+    int hedgeDelay(const QString &host, int fallbackMs) const;
+
+    /**
+     * @brief When to give up on a host: well past its tail latency, never above fallbackMs
+     */
+    int deadline(const QString &host, int fallbackMs) const;
+
+    void clear();
+
+private:
+    LatencyTracker() = default;
+
+    struct Samples {
+        QVector<int> values;        // Ring buffer of the most recent latencies, ms
+        int next = 0;
+    };
+
+    int percentileLocked(const Samples &samples, double percent) const;
+
+    static const int sampleWindow = 64;
+    static const int minSamples = 5;
+
+    mutable QMutex m_mutex;
+    QHash<QString, Samples> m_hosts;
+};
+
+#endif // LATENCYTRACKER_H
@@ -0,0 +1,827 @@
+#include "NetworkDispatcher.h"
+#include "RateLimiter.h"
+#include "CircuitBreaker.h"
+#include "LatencyTracker.h"
+#include "NetworkMetrics.h"
+#include "DnsCache.h"
+#include "SharedCookieStore.h"
+#include <QCoreApplication>
+#include <QMetaObject>
+#include <QTimer>
+#include <QSslError>
+#include <QSslConfiguration>
+#include <QDebug>
+
+NetworkDispatcher *NetworkDispatcher::instance()
+{
+    // Intentionally never deleted: the network thread is stopped on aboutToQuit
+    static NetworkDispatcher *dispatcher = new NetworkDispatcher();
+    return dispatcher;
+}
+
+NetworkDispatcher::NetworkDispatcher()
+    : QObject(nullptr)
+    , m_manager(nullptr)
+    , m_pendingCount(0)
+    , m_nextDeferredId(0)
+    , m_transferBytes(0)
+    , m_decodedBytes(0)
+    , m_nextHedgeGroup(0)
+    , m_proxied(0)
+{
+    qRegisterMetaType<HttpResponse>("HttpResponse");
+
+    m_clock.start();
+    m_thread.setObjectName("HttpClientNetworkThread");
+    moveToThread(&m_thread);
+
+    // Receiver lives on m_thread, so initialization runs there before any queued request
+    connect(&m_thread, &QThread::started, this, &NetworkDispatcher::initializeManager);
+
+    if (QCoreApplication::instance()) {
+        connect(QCoreApplication::instance(), &QCoreApplication::aboutToQuit,
+                this, [this]() { shutdown(); }, Qt::DirectConnection);
+    }
+
+    m_thread.start();
+    qDebug() << "NetworkDispatcher: Network thread started";
+}
+
+NetworkDispatcher::~NetworkDispatcher()
+{
+    shutdown();
+}
+
+void NetworkDispatcher::initializeManager()
+{
+    m_manager = new QNetworkAccessManager(this);
+    // HttpClient attaches and records cookies itself (Manual); anything Qt handles on
+    // its own still goes to the shared store rather than a private default jar
+    m_manager->setCookieJar(new CustomCookieJar(m_manager));
+
+    // Same policy as HttpClient: novel sites frequently ship broken certificates
+    connect(m_manager, &QNetworkAccessManager::sslErrors,
+            this, [](QNetworkReply *reply, const QList<QSslError> &errors) {
+                qDebug() << "NetworkDispatcher: Ignoring" << errors.size() << "SSL errors for" << reply->url().toString();
+                reply->ignoreSslErrors();
+            });
+}
+
+void NetworkDispatcher::dispatch(const PendingRequest &request, ResponseCallback callback)
+{
+    if (!m_thread.isRunning()) {
+        HttpResponse response;
+        response.url = request.request.url();
+        response.networkError = QNetworkReply::OperationCanceledError;
+        response.error = "Network thread is not running";
+        if (callback) {
+            callback(response);
+        }
+        return;
+    }
+
+    m_pendingCount.ref();
+    if (!request.probe && request.attempt == 0) {
+        RetryBudget::instance()->recordRequest();
+    }
+
+    PendingRequest queued = request;
+    queued.submittedAt = m_clock.elapsed();
+    QMetaObject::invokeMethod(this, [this, queued, callback]() {
+        submit(queued, callback);
+    }, Qt::QueuedConnection);
+}
+
+void NetworkDispatcher::dispatchHedged(const PendingRequest &request, int hedgeAfterMs, ResponseCallback callback)
+{
+    // Two racing transfers cannot share one streaming consumer; a POST must not be sent twice
+    if (hedgeAfterMs <= 0 || !m_thread.isRunning() || request.bodySink || request.method != "GET") {
+        dispatch(request, callback);
+        return;
+    }
+
+    const quint64 groupId = m_nextHedgeGroup.fetchAndAddRelaxed(1) + 1;
+    PendingRequest primary = request;
+    primary.hedgeGroup = groupId;
+
+    // Queued ahead of the primary's submission, so the group exists before any answer;
+    // the hedge timer starts in sendRequest() once the primary leaves the limiter
+    QMetaObject::invokeMethod(this, [this, groupId, hedgeAfterMs, callback]() {
+        HedgeGroup &group = m_hedgeGroups[groupId];
+        group.callback = callback;
+        group.hedgeAfterMs = hedgeAfterMs;
+        group.outstanding = 1;
+    }, Qt::QueuedConnection);
+
+    dispatch(primary, [this, groupId](const HttpResponse &response) {
+        finishHedged(groupId, response);
+    });
+}
+
+void NetworkDispatcher::sendHedge(const PendingRequest &request, quint64 groupId)
+{
+    auto it = m_hedgeGroups.find(groupId);
+    if (it == m_hedgeGroups.end() || it->done) {
+        return;
+    }
+
+    // A duplicate to a failing host only adds load; so does one beyond the retry budget
+    const QString host = RateLimiter::hostKey(request.request.url());
+    if (CircuitBreaker::instance()->state(host) != CircuitBreaker::Closed
+        || !RetryBudget::instance()->tryAcquire()) {
+        return;
+    }
+
+    PendingRequest hedge = request;
+    hedge.hedge = true;
+    hedge.retryPolicy = RetryPolicy(0);
+    hedge.submittedAt = m_clock.elapsed();
+    it->outstanding++;
+
+    qDebug() << "NetworkDispatcher: No answer from" << host << "yet, hedging" << request.request.url().toString();
+    m_pendingCount.ref();
+    submit(hedge, [this, groupId](const HttpResponse &response) {
+        finishHedged(groupId, response);
+    });
+}
+
+void NetworkDispatcher::finishHedged(quint64 groupId, const HttpResponse &response)
+{
+    auto it = m_hedgeGroups.find(groupId);
+    if (it == m_hedgeGroups.end()) {
+        return;
+    }
+
+    it->outstanding--;
+    if (it->done) {
+        if (it->outstanding <= 0) {
+            m_hedgeGroups.erase(it);
+        }
+        return;
+    }
+    if (!response.success && it->outstanding > 0) {
+        return;     // The other request may still succeed
+    }
+
+    it->done = true;
+    const ResponseCallback callback = it->callback;
+    if (it->outstanding <= 0) {
+        m_hedgeGroups.erase(it);
+    } else {
+        // May re-enter finishHedged for the aborted request; `it` is not used past this point
+        cancelHedgeGroup(groupId);
+    }
+
+    if (callback) {
+        callback(response);
+    }
+}
+
+void NetworkDispatcher::cancelHedgeGroup(quint64 groupId)
+{
+    // Only a duplicate still waiting for its limiter slot is dropped; a deferred
+    // original keeps its place and its late answer is discarded by finishHedged()
+    QList<ResponseCallback> waiting;
+    for (auto it = m_deferred.begin(); it != m_deferred.end();) {
+        if (it->request.hedgeGroup == groupId && it->request.hedge) {
+            waiting.append(it->callback);
+            it = m_deferred.erase(it);
+            m_pendingCount.deref();
+        } else {
+            ++it;
+        }
+    }
+
+    QList<QNetworkReply*> inFlight;
+    for (auto it = m_active.constBegin(); it != m_active.constEnd(); ++it) {
+        if (it->request.hedgeGroup == groupId) {
+            inFlight.append(it.key());
+        }
+    }
+    for (QNetworkReply *reply : inFlight) {
+        reply->abort();
+    }
+
+    HttpResponse cancelled;
+    cancelled.networkError = QNetworkReply::OperationCanceledError;
+    cancelled.error = "Superseded by hedged request";
+    for (const ResponseCallback &callback : waiting) {
+        if (callback) {
+            callback(cancelled);
+        }
+    }
+}
+
+void NetworkDispatcher::submit(const PendingRequest &request, const ResponseCallback &callback)
+{
+    const QString host = RateLimiter::hostKey(request.request.url());
+
+    // A host that keeps failing is not worth a connection attempt, let alone a timeout
+    if (!request.probe && !CircuitBreaker::instance()->allowRequest(host)) {
+        HttpResponse response;
+        response.url = request.request.url();
+        response.networkError = QNetworkReply::ServiceUnavailableError;
+        response.error = QString("Circuit open for %1, failing fast").arg(host);
+        m_pendingCount.deref();
+        if (callback) {
+            callback(response);
+        }
+        return;
+    }
+
+    const int delay = request.rateLimited ? RateLimiter::instance()->reserve(request.request.url()) : 0;
+    if (delay > 0) {
+        deferRequest(request, callback, delay);
+    } else {
+        startRequest(request, callback);
+    }
+}
+
+void NetworkDispatcher::warmUp(const QUrl &url)
+{
+    if (!url.isValid() || url.host().isEmpty() || !m_thread.isRunning()) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(this, [this, url]() {
+        startWarmUp(url);
+    }, Qt::QueuedConnection);
+}
+
+void NetworkDispatcher::setProxy(const QNetworkProxy &proxy)
+{
+    m_proxied.storeRelease(proxy.type() == QNetworkProxy::NoProxy ? 0 : 1);
+    QMetaObject::invokeMethod(this, [this, proxy]() {
+        if (m_manager) {
+            m_manager->setProxy(proxy);
+        }
+        qDebug() << "NetworkDispatcher: Proxy set to" << proxy.hostName() << proxy.port();
+    }, Qt::QueuedConnection);
+}
+
+void NetworkDispatcher::startWarmUp(const QUrl &url)
+{
+    if (m_proxied.loadAcquire()) {
+        return;
+    }
+
+    const QString host = url.host().toLower();
+    const bool encrypted = url.scheme().compare("https", Qt::CaseInsensitive) == 0;
+    const quint16 port = quint16(url.port(encrypted ? 443 : 80));
+    const QString key = QString("%1:%2").arg(host).arg(port);
+
+    // A connection opened moments ago is still idle in the pool; another would be wasted
+    const qint64 now = m_clock.elapsed();
+    auto it = m_warmedAt.constFind(key);
+    if (it != m_warmedAt.constEnd() && now - *it < 30000) {
+        return;
+    }
+    m_warmedAt.insert(key, now);
+
+    DnsCache::instance()->resolve(host, this, [this, host, port, encrypted](bool resolved) {
+        if (!resolved) {
+            return;
+        }
+
+        if (encrypted) {
+            QSslConfiguration config = QSslConfiguration::defaultConfiguration();
+            if (isHttp2Allowed(host)) {
+                config.setAllowedNextProtocols({QSslConfiguration::ALPNProtocolHTTP2,
+                                                QSslConfiguration::NextProtocolHttp1_1});
+            }
+            m_manager->connectToHostEncrypted(host, port, config);
+        } else {
+            m_manager->connectToHost(host, port);
+        }
+        qDebug() << "NetworkDispatcher: Warming up connection to" << host << port;
+    });
+}
+
+int NetworkDispatcher::pendingRequestCount() const
+{
+    return m_pendingCount.loadAcquire();
+}
+
+qint64 NetworkDispatcher::totalTransferBytes() const
+{
+    return m_transferBytes.loadAcquire();
+}
+
+qint64 NetworkDispatcher::totalDecodedBytes() const
+{
+    return m_decodedBytes.loadAcquire();
+}
+
+void NetworkDispatcher::setHttp2Allowed(const QString &host, bool allowed)
+{
+    const QString key = host.toLower();
+    if (key.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_protocolMutex);
+    if (allowed) {
+        m_http2Hosts.insert(key);
+    } else {
+        m_http2Hosts.remove(key);
+    }
+}
+
+void NetworkDispatcher::clearHttp2Hosts()
+{
+    // Hosts that fell back to HTTP/1.1 stay there: the server has not changed
+    QMutexLocker locker(&m_protocolMutex);
+    m_http2Hosts.clear();
+}
+
+bool NetworkDispatcher::isHttp2Allowed(const QString &host) const
+{
+    QString candidate = host.toLower();
+
+    QMutexLocker locker(&m_protocolMutex);
+    if (m_http1OnlyHosts.contains(candidate)) {
+        return false;
+    }
+
+    // A source registered as www.example.com also covers example.com's other subdomains
+    while (!candidate.isEmpty()) {
+        if (m_http2Hosts.contains(candidate)) {
+            return true;
+        }
+        const int dot = candidate.indexOf('.');
+        if (dot < 0 || candidate.indexOf('.', dot + 1) < 0) {
+            break;
+        }
+        candidate = candidate.mid(dot + 1);
+    }
+    for (const QString &allowed : m_http2Hosts) {
+        if (allowed.endsWith(QLatin1Char('.') + candidate)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+NetworkDispatcher::ProtocolStats NetworkDispatcher::protocolStats(const QString &host) const
+{
+    QMutexLocker locker(&m_protocolMutex);
+    return m_protocolStats.value(host.toLower());
+}
+
+QHash<QString, NetworkDispatcher::ProtocolStats> NetworkDispatcher::allProtocolStats() const
+{
+    QMutexLocker locker(&m_protocolMutex);
+    return m_protocolStats;
+}
+
+void NetworkDispatcher::shutdown()
+{
+    if (!m_thread.isRunning()) {
+        return;
+    }
+
+    QMetaObject::invokeMethod(this, [this]() {
+        const QList<QNetworkReply*> replies = m_active.keys();
+        for (QNetworkReply *reply : replies) {
+            reply->abort();
+        }
+
+        // Requests still waiting for a rate limiter slot would otherwise never complete
+        const QList<DeferredRequest> deferred = m_deferred.values();
+        m_deferred.clear();
+        for (const DeferredRequest &pending : deferred) {
+            HttpResponse response;
+            response.url = pending.request.request.url();
+            response.networkError = QNetworkReply::OperationCanceledError;
+            response.error = "Network thread is shutting down";
+            m_pendingCount.deref();
+            if (pending.callback) {
+                pending.callback(response);
+            }
+        }
+    }, Qt::BlockingQueuedConnection);
+
+    m_thread.quit();
+    m_thread.wait(3000);
+    qDebug() << "NetworkDispatcher: Network thread stopped";
+}
+
+void NetworkDispatcher::deferRequest(const PendingRequest &request, const ResponseCallback &callback, int delayMs, bool resubmit)
+{
+    const quint64 id = ++m_nextDeferredId;
+    m_deferred.insert(id, DeferredRequest{request, callback, resubmit});
+
+    QTimer::singleShot(delayMs, this, [this, id]() {
+        auto it = m_deferred.find(id);
+        if (it == m_deferred.end()) {
+            return;
+        }
+        DeferredRequest deferred = it.value();
+        m_deferred.erase(it);
+        if (deferred.resubmit) {
+            submit(deferred.request, deferred.callback);
+        } else {
+            startRequest(deferred.request, deferred.callback);
+        }
+    });
+}
+
+void NetworkDispatcher::startRequest(const PendingRequest &request, const ResponseCallback &callback)
+{
+    RequestTiming timing;
+    const qint64 now = m_clock.elapsed();
+    timing.queuedMs = request.submittedAt >= 0 ? now - request.submittedAt : 0;
+
+    // Resolve through DnsCache first: the lookup gets timed, and QNetworkAccessManager
+    // then finds the address in Qt's host cache instead of resolving it again
+    const QString lookupHost = request.request.url().host();
+    if (lookupHost.isEmpty() || m_proxied.loadAcquire() || DnsCache::instance()->lookup(lookupHost, nullptr)) {
+        sendRequest(request, callback, timing);
+        return;
+    }
+
+    DnsCache::instance()->resolve(lookupHost, this, [this, request, callback, timing, now](bool) {
+        RequestTiming resolved = timing;
+        resolved.dnsMs = m_clock.elapsed() - now;
+        sendRequest(request, callback, resolved);
+    });
+}
+
+void NetworkDispatcher::sendRequest(const PendingRequest &request, const ResponseCallback &callback, const RequestTiming &timing)
+{
+    const QString host = request.request.url().host().toLower();
+    const bool useHttp2 = !request.hedge && isHttp2Allowed(host);
+
+    // Concurrent requests to an HTTP/2 host share one multiplexed connection of m_manager
+    QNetworkRequest networkRequest = request.request;
+    networkRequest.setAttribute(QNetworkRequest::Http2AllowedAttribute, useHttp2);
+
+    QNetworkReply *reply = nullptr;
+    if (request.method == "POST") {
+        reply = m_manager->post(networkRequest, request.data);
+    } else {
+        reply = m_manager->get(networkRequest);
+    }
+
+    if (!reply) {
+        HttpResponse response;
+        response.url = request.request.url();
+        response.networkError = QNetworkReply::UnknownNetworkError;
+        response.error = "Failed to create network request";
+        m_pendingCount.deref();
+        if (callback) {
+            callback(response);
+        }
+        return;
+    }
+
+    // The hedge delay counts from here: time spent behind the limiter is not the host being slow
+    if (request.hedgeGroup != 0 && !request.hedge) {
+        auto group = m_hedgeGroups.find(request.hedgeGroup);
+        if (group != m_hedgeGroups.end() && !group->done && !group->hedgeScheduled) {
+            group->hedgeScheduled = true;
+            const quint64 groupId = request.hedgeGroup;
+            QTimer::singleShot(group->hedgeAfterMs, this, [this, request, groupId]() {
+                sendHedge(request, groupId);
+            });
+        }
+    }
+
+    ActiveRequest &active = m_active[reply];
+    active.request = request;
+    active.callback = callback;
+    active.triedHttp2 = useHttp2;
+    // Qt leaves the body compressed only when the caller negotiated the encoding itself
+    active.decodeBody = request.request.hasRawHeader("Accept-Encoding");
+    active.timing = timing;
+    active.sentAt = m_clock.elapsed();
+
+    // Qt emits encrypted only when a new TLS session was set up for this reply
+    connect(reply, &QNetworkReply::encrypted, this, [this, host, reply]() {
+        auto it = m_active.find(reply);
+        if (it != m_active.end()) {
+            it->encryptedAt = m_clock.elapsed();
+        }
+        QMutexLocker locker(&m_protocolMutex);
+        m_protocolStats[host].tlsHandshakes++;
+    });
+    connect(reply, &QNetworkReply::metaDataChanged, this, [this, reply]() {
+        auto it = m_active.find(reply);
+        if (it == m_active.end()) {
+            return;
+        }
+        if (it->headersAt < 0) {
+            it->headersAt = m_clock.elapsed();
+        }
+
+        // The encoded length never exceeds the decoded one: refuse oversized bodies up front
+        const qint64 maxBody = it->request.maxBodyBytes;
+        const QVariant length = reply->header(QNetworkRequest::ContentLengthHeader);
+        if (maxBody > 0 && length.isValid() && length.toLongLong() > maxBody) {
+            it->tooLarge = true;
+            reply->abort();
+        }
+    });
+    connect(reply, &QNetworkReply::readyRead, this, [this, reply]() { onReplyReadyRead(reply); });
+    connect(reply, &QNetworkReply::finished, this, [this, reply]() { onReplyFinished(reply); });
+
+    if (request.timeoutMs > 0) {
+        QTimer *timeoutTimer = new QTimer(reply);
+        timeoutTimer->setSingleShot(true);
+        connect(timeoutTimer, &QTimer::timeout, this, [this, reply]() {
+            auto it = m_active.find(reply);
+            if (it != m_active.end() && !reply->isFinished()) {
+                it->timedOut = true;
+                reply->abort();
+            }
+        });
+        timeoutTimer->start(request.timeoutMs);
+    }
+}
+
+void NetworkDispatcher::onReplyReadyRead(QNetworkReply *reply)
+{
+    auto it = m_active.find(reply);
+    if (it == m_active.end()) {
+        return;
+    }
+
+    appendBody(reply, *it, reply->readAll());
+    if (it->tooLarge) {
+        reply->abort();
+    }
+}
+
+void NetworkDispatcher::appendBody(QNetworkReply *reply, ActiveRequest &active, const QByteArray &chunk)
+{
+    if (chunk.isEmpty()) {
+        return;
+    }
+
+    active.transferBytes += chunk.size();
+
+    if (active.decodeBody && !active.decoder) {
+        active.decoder = std::make_shared<ContentDecoder>(reply->rawHeader("Content-Encoding"));
+    }
+
+    if (active.decoder) {
+        QByteArray decoded;
+        active.decoder->decode(chunk, &decoded);
+        consumeBody(reply, active, decoded);
+    } else {
+        consumeBody(reply, active, chunk);
+    }
+}
+
+void NetworkDispatcher::consumeBody(QNetworkReply *reply, ActiveRequest &active, const QByteArray &decoded)
+{
+    if (active.tooLarge || decoded.isEmpty()) {
+        return;
+    }
+
+    const qint64 received = active.streamedBytes + active.body.size() + decoded.size();
+    if (active.request.maxBodyBytes > 0 && received > active.request.maxBodyBytes) {
+        // The caller aborts the reply; nothing past the cap is kept
+        active.tooLarge = true;
+        return;
+    }
+
+    if (active.request.bodySink) {
+        writeToSink(reply, active, decoded);
+    } else {
+        active.body.append(decoded);
+    }
+}
+
+void NetworkDispatcher::writeToSink(QNetworkReply *reply, ActiveRequest &active, const QByteArray &decoded)
+{
+    if (!active.sinkStarted) {
+        active.request.bodySink->begin(reply->rawHeader("Content-Type"));
+        active.sinkStarted = true;
+    }
+    if (!decoded.isEmpty()) {
+        active.request.bodySink->write(decoded.constData(), decoded.size());
+        active.streamedBytes += decoded.size();
+    }
+}
+
+bool NetworkDispatcher::shouldFallBackToHttp1(QNetworkReply *reply, const ActiveRequest &active) const
+{
+    if (!active.triedHttp2 || active.timedOut
+        || reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).isValid()) {
+        return false;
+    }
+
+    // Failures before any HTTP status arrived that point at a broken HTTP/2 peer
+    switch (reply->error()) {
+    case QNetworkReply::ProtocolFailure:
+    case QNetworkReply::ProtocolUnknownError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void NetworkDispatcher::onReplyFinished(QNetworkReply *reply)
+{
+    ActiveRequest active = m_active.take(reply);
+    const QString host = reply->request().url().host().toLower();
+
+    if (shouldFallBackToHttp1(reply, active)) {
+        qDebug() << "NetworkDispatcher: HTTP/2 failed for" << host << "(" << reply->errorString()
+                 << "), retrying over HTTP/1.1";
+        {
+            QMutexLocker locker(&m_protocolMutex);
+            m_http1OnlyHosts.insert(host);
+            m_protocolStats[host].http2Fallbacks++;
+        }
+        reply->deleteLater();
+        // The retry is another request to the host: it waits for its RateLimiter slot
+        submit(active.request, active.callback);
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_protocolMutex);
+        ProtocolStats &stats = m_protocolStats[host];
+        if (reply->attribute(QNetworkRequest::Http2WasUsedAttribute).toBool()) {
+            stats.http2Responses++;
+        } else {
+            stats.http1Responses++;
+        }
+    }
+    QString decodeError;
+    bool truncated = false;
+    if (!active.tooLarge) {
+        appendBody(reply, active, reply->readAll());
+    }
+    if (active.decoder && !active.tooLarge) {
+        QByteArray tail;
+        if (!active.decoder->finish(&tail)) {
+            truncated = active.decoder->isTruncated();
+            decodeError = active.decoder->errorString();
+        }
+        consumeBody(reply, active, tail);
+    }
+
+    const qint64 decodedBytes = active.streamedBytes + active.body.size();
+    m_transferBytes.fetchAndAddRelaxed(active.transferBytes);
+    m_decodedBytes.fetchAndAddRelaxed(decodedBytes);
+
+    HttpResponse response;
+    response.statusCode = reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+    response.url = reply->url();
+    response.contentType = reply->rawHeader("Content-Type");
+    response.rawHeaders = reply->rawHeaderPairs();
+    response.transferSize = active.transferBytes;
+
+    const qint64 finishedAt = m_clock.elapsed();
+    const qint64 connectionReadyAt = active.encryptedAt >= 0 ? active.encryptedAt : active.sentAt;
+    const qint64 headersAt = active.headersAt >= 0 ? active.headersAt : finishedAt;
+    RequestTiming &timing = response.timing;
+    timing = active.timing;
+    if (active.encryptedAt >= 0) {
+        timing.connectMs = active.encryptedAt - active.sentAt;
+    } else if (reply->url().scheme().compare("https", Qt::CaseInsensitive) == 0) {
+        timing.connectMs = 0;   // Reused TLS connection
+    }
+    timing.ttfbMs = qMax<qint64>(0, headersAt - connectionReadyAt);
+    timing.bodyMs = finishedAt - headersAt;
+    timing.totalMs = timing.queuedMs + timing.dnsMs + (finishedAt - active.sentAt);
+
+    QVariant cookieVar = reply->header(QNetworkRequest::SetCookieHeader);
+    if (cookieVar.isValid()) {
+        response.cookies = qvariant_cast<QList<QNetworkCookie>>(cookieVar);
+    }
+
+    // Server asked us to slow down: push this host's schedule back for every caller
+    if (response.statusCode == 429 || response.statusCode == 503) {
+        bool ok = false;
+        const int retryAfter = reply->rawHeader("Retry-After").trimmed().toInt(&ok);
+        const int backOffMs = (ok && retryAfter > 0) ? qMin(retryAfter, 300) * 1000 : 5000;
+        RateLimiter::instance()->backOff(RateLimiter::hostKey(reply->request().url()), backOffMs);
+    }
+
+    if (active.timedOut) {
+        response.networkError = QNetworkReply::TimeoutError;
+        response.error = "Request timeout";
+    } else if (active.tooLarge) {
+        // Not retryable: the page would be just as large next time
+        response.networkError = QNetworkReply::UnknownContentError;
+        response.error = QString("Response body exceeds %1 bytes").arg(active.request.maxBodyBytes);
+    } else if (reply->error() != QNetworkReply::NoError) {
+        response.networkError = reply->error();
+        response.error = reply->errorString();
+    } else if (!decodeError.isEmpty()) {
+        response.networkError = QNetworkReply::ProtocolFailure;
+        response.error = QString("Failed to decode response body: %1").arg(decodeError);
+    } else {
+        response.success = true;
+        response.truncated = truncated;
+        response.body = active.body;
+    }
+
+    qDebug() << "NetworkDispatcher: Finished" << reply->request().url().toString()
+             << "status:" << response.statusCode
+             << "bytes:" << decodedBytes << "wire:" << active.transferBytes
+             << "total:" << timing.totalMs << "ms (queued" << timing.queuedMs << "dns" << timing.dnsMs
+             << "connect" << timing.connectMs << "ttfb" << timing.ttfbMs << "body" << timing.bodyMs << ")"
+             << (response.success ? "" : response.error);
+
+    reply->deleteLater();
+    recordOutcome(host, reply->request().url(), response);
+    NetworkMetrics::instance()->record(host, response, decodedBytes);
+    if (response.success && !active.request.probe) {
+        LatencyTracker::instance()->record(host, finishedAt - active.sentAt);
+    }
+
+    const PendingRequest &sent = active.request;
+    if (!response.success && !sent.probe && RetryPolicy::isRetryable(response)
+        && sent.retryPolicy.canRetry(sent.attempt)
+        && CircuitBreaker::instance()->state(host) == CircuitBreaker::Closed
+        && RetryBudget::instance()->tryAcquire()) {
+        PendingRequest retry = sent;
+        retry.attempt++;
+        retry.submittedAt = m_clock.elapsed();
+        const int delay = sent.retryPolicy.backoffDelay(sent.attempt, response);
+        qDebug() << "NetworkDispatcher: Retrying" << retry.request.url().toString()
+                 << "attempt" << retry.attempt << "of" << sent.retryPolicy.maxRetries()
+                 << "in" << delay << "ms";
+        deferRequest(retry, active.callback, delay, true);
+        return;
+    }
+
+    m_pendingCount.deref();
+
+    if (active.request.bodySink) {
+        // An empty body still gets a begin() so end() always closes an attempt
+        if (!active.sinkStarted && response.success) {
+            writeToSink(reply, active, QByteArray());
+        }
+        active.request.bodySink->end(response.success && active.sinkStarted);
+    }
+
+    if (active.callback) {
+        active.callback(response);
+    }
+}
+
+void NetworkDispatcher::recordOutcome(const QString &host, const QUrl &url, const HttpResponse &response)
+{
+    CircuitBreaker *breaker = CircuitBreaker::instance();
+
+    // An inconclusive probe (e.g. an SSL failure) must not leave the half-open slot taken
+    const bool failed = RetryPolicy::isRetryable(response)
+        || (response.statusCode == 0 && breaker->state(host) == CircuitBreaker::HalfOpen);
+
+    if (failed) {
+        if (breaker->recordFailure(host)) {
+            scheduleProbe(host, url);
+        }
+    } else if (response.success || response.statusCode > 0) {
+        // Any HTTP answer below 500 proves the host is up, even a 404
+        breaker->recordSuccess(host);
+        m_probeRounds.remove(host);
+    }
+}
+
+void NetworkDispatcher::scheduleProbe(const QString &host, const QUrl &url)
+{
+    // Background probing stops after a few rounds (about ten minutes of
+    // doubling cool-downs); after that the next real request is the probe
+    const int maxRounds = 6;
+    int &rounds = m_probeRounds[host];
+    if (rounds >= maxRounds) {
+        qDebug() << "NetworkDispatcher: Giving up background probes for" << host;
+        return;
+    }
+    rounds++;
+
+    QUrl probeUrl;
+    probeUrl.setScheme(url.scheme());
+    probeUrl.setHost(url.host());
+    probeUrl.setPort(url.port());
+    probeUrl.setPath("/");
+
+    const int delay = CircuitBreaker::instance()->remainingOpenMs(host);
+    QTimer::singleShot(delay, this, [this, host, probeUrl]() {
+        // Skip if a real request already took the half-open slot
+        if (!m_thread.isRunning() || !CircuitBreaker::instance()->allowRequest(host)) {
+            return;
+        }
+
+        PendingRequest probe;
+        probe.method = "GET";
+        probe.request.setUrl(probeUrl);
+        probe.request.setRawHeader("User-Agent", "curl/7.68.0");
+        probe.timeoutMs = 10000;
+        probe.rateLimited = false;
+        probe.probe = true;
+
+        qDebug() << "NetworkDispatcher: Probing" << host;
+        m_pendingCount.ref();
+        startRequest(probe, nullptr);
+    });
+}
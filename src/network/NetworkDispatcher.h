@@ -0,0 +1,216 @@
+#ifndef NETWORKDISPATCHER_H
+#define NETWORKDISPATCHER_H
+
+#include <QObject>
+#include <QThread>
+#include <QHash>
+#include <QSet>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QNetworkProxy>
+#include <functional>
+#include <memory>
+#include "HttpResponse.h"
+#include "ContentDecoder.h"
+#include "RetryPolicy.h"
+#include "BodySink.h"
+
+/**
+ * @brief Process-wide network event loop shared by all HttpClient instances
+ *
+ * Owns one dedicated thread running one QNetworkAccessManager. Requests can be
+ * submitted from any thread; they are marshalled onto the network thread and
+ * completed there, so callers never need a nested QEventLoop to wait for a reply.
+ * Requests are paced per host by RateLimiter; a request whose host has no free
+ * slot waits on a timer, never on a sleeping thread. Hosts whose CircuitBreaker
+ * is open fail fast and are probed in the background until they recover.
+ * Every reply carries a RequestTiming breakdown, aggregated in NetworkMetrics.
+ * Bodies are capped per request and can stream to a BodySink, so a large page
+ * is processed as it arrives instead of held in memory whole.
+ */
+class NetworkDispatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    using ResponseCallback = std::function<void(const HttpResponse &)>;
+
+    /**
+     * @brief Per-host protocol and connection counters
+     */
+    struct ProtocolStats {
+        qint64 http2Responses = 0;      // Replies served over a multiplexed HTTP/2 connection
+        qint64 http1Responses = 0;      // Replies served over HTTP/1.1
+        qint64 http2Fallbacks = 0;      // HTTP/2 attempts retried over HTTP/1.1
+        qint64 tlsHandshakes = 0;       // New TLS sessions (one per opened connection)
+    };
+
+    /**
+     * @brief Fully prepared request handed to the network thread
+     */
+    struct PendingRequest {
+        QByteArray method;          // "GET" or "POST"
+        QNetworkRequest request;    // URL, headers and attributes
+        QByteArray data;            // Request body for POST
+        int timeoutMs = 15000;      // Whole-request timeout
+        bool rateLimited = true;    // Paced through RateLimiter before sending
+        RetryPolicy retryPolicy{0}; // Transport retries for transient failures, none by default
+        int attempt = 0;            // Retries already made
+        bool probe = false;         // Circuit breaker probe: bypasses the breaker, never retried
+        quint64 hedgeGroup = 0;     // Set by dispatchHedged for the original and its duplicate
+        bool hedge = false;         // The duplicate: HTTP/1.1 only, so it gets its own connection
+        qint64 submittedAt = -1;    // Dispatcher clock when queued, for RequestTiming::queuedMs
+        std::shared_ptr<BodySink> bodySink;     // Takes the body as it arrives instead of HttpResponse::body
+        qint64 maxBodyBytes = 0;                // Abort past this many decoded body bytes, 0 for no cap
+    };
+
+    static NetworkDispatcher *instance();
+
+    /**
+     * @brief Submit a request; callback runs on the network thread when it completes
+     *
+     * The callback must not block: it runs on the shared network thread.
+     */
+    void dispatch(const PendingRequest &request, ResponseCallback callback);
+
+    /**
+     * @brief Like dispatch, but send a duplicate if no answer arrived after hedgeAfterMs
+     *
+     * The delay counts from when the original is actually sent, not from any time
+     * it spent waiting for the rate limiter. The duplicate waits for its own
+     * limiter slot and uses HTTP/1.1, so it opens its own connection instead of
+     * queueing behind a stalled one. The first successful response wins and the
+     * other request is aborted; the callback runs once. Duplicates draw from
+     * RetryBudget and are not sent to a failing host. Only GETs are hedged, and
+     * requests with a BodySink never are.
+     */
+    void dispatchHedged(const PendingRequest &request, int hedgeAfterMs, ResponseCallback callback);
+
+    /**
+     * @brief Number of requests submitted but not yet completed
+     */
+    int pendingRequestCount() const;
+
+    /**
+     * @brief Body bytes received on the wire since startup (compressed size)
+     */
+    qint64 totalTransferBytes() const;
+
+    /**
+     * @brief Body bytes delivered to callers since startup (decoded size)
+     */
+    qint64 totalDecodedBytes() const;
+
+    /**
+     * @brief Allow HTTP/2 for a host (and its subdomains), as declared by its book source
+     *
+     * Hosts whose HTTP/2 attempt fails at the protocol level are remembered and
+     * served over HTTP/1.1 for the rest of the session.
+     */
+    void setHttp2Allowed(const QString &host, bool allowed);
+    bool isHttp2Allowed(const QString &host) const;
+    void clearHttp2Hosts();
+
+    /**
+     * @brief Resolve a URL's host and open a connection (TCP, plus TLS for https) ahead of use
+     *
+     * Fire-and-forget; the idle connection is picked up by the next request to
+     * the same host. Hosts warmed within the last 30 seconds are skipped.
+     */
+    void warmUp(const QUrl &url);
+
+    /**
+     * @brief Route every request through an HTTP proxy, e.g. tools/replay_server
+     *
+     * While a proxy is set, hosts are neither resolved nor warmed up locally.
+     * QNetworkProxy::NoProxy restores direct connections.
+     */
+    void setProxy(const QNetworkProxy &proxy);
+
+    ProtocolStats protocolStats(const QString &host) const;
+    QHash<QString, ProtocolStats> allProtocolStats() const;
+
+    /**
+     * @brief Stop the network thread, aborting requests still in flight
+     */
+    void shutdown();
+
+private:
+    NetworkDispatcher();
+    ~NetworkDispatcher();
+
+    struct DeferredRequest {
+        PendingRequest request;
+        ResponseCallback callback;
+        bool resubmit = false;      // Retry: goes through breaker and limiter again when due
+    };
+
+    struct HedgeGroup {
+        ResponseCallback callback;
+        int hedgeAfterMs = 0;
+        int outstanding = 0;        // Requests of the group not yet answered
+        bool hedgeScheduled = false;    // Timer started when the original was sent
+        bool done = false;          // Callback already delivered
+    };
+
+    struct ActiveRequest {
+        PendingRequest request;                     // Kept for the HTTP/1.1 retry
+        ResponseCallback callback;
+        bool triedHttp2 = false;
+        QByteArray body;                            // Decoded body
+        qint64 transferBytes = 0;                   // Body bytes as received
+        bool decodeBody = false;                    // Content-Encoding is ours to undo
+        std::shared_ptr<ContentDecoder> decoder;    // Created from the first chunk's headers
+        bool sinkStarted = false;                   // BodySink::begin() called for this attempt
+        qint64 streamedBytes = 0;                   // Decoded bytes handed to the BodySink
+        bool tooLarge = false;                      // maxBodyBytes exceeded, transfer aborted
+        bool timedOut = false;
+        RequestTiming timing;                       // Queue and DNS phases, completed on finish
+        qint64 sentAt = 0;                          // m_clock ms of the phase boundaries
+        qint64 encryptedAt = -1;
+        qint64 headersAt = -1;
+    };
+
+    void initializeManager();
+    void startWarmUp(const QUrl &url);
+    void submit(const PendingRequest &request, const ResponseCallback &callback);
+    void deferRequest(const PendingRequest &request, const ResponseCallback &callback, int delayMs, bool resubmit = false);
+    void startRequest(const PendingRequest &request, const ResponseCallback &callback);
+    void sendRequest(const PendingRequest &request, const ResponseCallback &callback, const RequestTiming &timing);
+    void onReplyReadyRead(QNetworkReply *reply);
+    void appendBody(QNetworkReply *reply, ActiveRequest &active, const QByteArray &chunk);
+    void consumeBody(QNetworkReply *reply, ActiveRequest &active, const QByteArray &decoded);
+    void writeToSink(QNetworkReply *reply, ActiveRequest &active, const QByteArray &decoded);
+    void onReplyFinished(QNetworkReply *reply);
+    bool shouldFallBackToHttp1(QNetworkReply *reply, const ActiveRequest &active) const;
+    void recordOutcome(const QString &host, const QUrl &url, const HttpResponse &response);
+    void sendHedge(const PendingRequest &request, quint64 groupId);
+    void finishHedged(quint64 groupId, const HttpResponse &response);
+    void cancelHedgeGroup(quint64 groupId);
+    void scheduleProbe(const QString &host, const QUrl &url);
+
+    QThread m_thread;
+    QNetworkAccessManager *m_manager;       // Lives on m_thread
+    QHash<QNetworkReply*, ActiveRequest> m_active;  // Touched only on m_thread
+    QHash<quint64, DeferredRequest> m_deferred;     // Waiting for a RateLimiter slot, m_thread only
+    quint64 m_nextDeferredId;
+    QHash<QString, qint64> m_warmedAt;              // "host:port" -> m_clock ms, m_thread only
+    QHash<QString, int> m_probeRounds;              // Background probes sent per open host, m_thread only
+    QHash<quint64, HedgeGroup> m_hedgeGroups;       // m_thread only
+    QAtomicInteger<quint64> m_nextHedgeGroup;
+    QAtomicInt m_proxied;                           // A proxy is set: skip local DNS and warm-up
+    QElapsedTimer m_clock;
+    QAtomicInt m_pendingCount;
+
+    mutable QMutex m_protocolMutex;                 // Guards the HTTP/2 policy and stats below
+    QSet<QString> m_http2Hosts;
+    QSet<QString> m_http1OnlyHosts;                 // HTTP/2 failed here this session
+    QHash<QString, ProtocolStats> m_protocolStats;
+    QAtomicInteger<qint64> m_transferBytes;
+    QAtomicInteger<qint64> m_decodedBytes;
+};
+
+#endif // NETWORKDISPATCHER_H
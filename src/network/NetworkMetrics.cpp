@@ -0,0 +1,193 @@
+#include "NetworkMetrics.h"
+#include <QMutexLocker>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QDir>
+#include <QSaveFile>
+#include <QDebug>
+
+NetworkMetrics::Histogram::Histogram()
+    : m_buckets(bucketBounds().size() + 1, 0)
+    , m_count(0)
+    , m_sum(0)
+    , m_max(0)
+{
+}
+
+const QVector<qint64> &NetworkMetrics::Histogram::bucketBounds()
+{
+    static const QVector<qint64> bounds = {
+        5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000, 10000, 30000
+    };
+    return bounds;
+}
+
+void NetworkMetrics::Histogram::add(qint64 valueMs)
+{
+    if (valueMs < 0) {
+        return;     // Phase not observed
+    }
+
+    const QVector<qint64> &bounds = bucketBounds();
+    int bucket = 0;
+    while (bucket < bounds.size() && valueMs > bounds[bucket]) {
+        ++bucket;
+    }
+    m_buckets[bucket]++;
+    m_count++;
+    m_sum += valueMs;
+    m_max = qMax(m_max, valueMs);
+}
+
+qint64 NetworkMetrics::Histogram::percentile(double percent) const
+{
+    if (m_count == 0) {
+        return -1;
+    }
+
+    const qint64 rank = qMax<qint64>(1, qint64(qBound(0.0, percent, 100.0) / 100.0 * m_count + 0.5));
+    const QVector<qint64> &bounds = bucketBounds();
+    qint64 seen = 0;
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        seen += m_buckets[i];
+        if (seen >= rank) {
+            return i < bounds.size() ? qMin(bounds[i], m_max) : m_max;
+        }
+    }
+    return m_max;
+}
+
+QJsonObject NetworkMetrics::Histogram::toJson() const
+{
+    QJsonObject json;
+    json["count"] = m_count;
+    json["sum"] = m_sum;
+    json["max"] = m_max;
+    json["mean"] = mean();
+    json["p50"] = percentile(50);
+    json["p90"] = percentile(90);
+    json["p99"] = percentile(99);
+
+    // Cumulative-style buckets keyed by upper bound, "+Inf" for the overflow
+    QJsonArray buckets;
+    const QVector<qint64> &bounds = bucketBounds();
+    for (int i = 0; i < m_buckets.size(); ++i) {
+        QJsonObject bucket;
+        bucket["le"] = i < bounds.size() ? QJsonValue(bounds[i]) : QJsonValue("+Inf");
+        bucket["count"] = m_buckets[i];
+        buckets.append(bucket);
+    }
+    json["buckets"] = buckets;
+    return json;
+}
+
+NetworkMetrics *NetworkMetrics::instance()
+{
+    static NetworkMetrics metrics;
+    return &metrics;
+}
+
+void NetworkMetrics::record(const QString &host, const HttpResponse &response, qint64 decodedBytes)
+{
+    const QString key = host.toLower();
+    if (key.isEmpty()) {
+        return;
+    }
+
+    const RequestTiming &timing = response.timing;
+
+    QMutexLocker locker(&m_mutex);
+    HostMetrics &metrics = m_hosts[key];
+    metrics.requests++;
+    if (!response.success) {
+        metrics.failures++;
+    }
+    metrics.transferBytes += response.transferSize;
+    metrics.decodedBytes += decodedBytes;
+
+    metrics.queued.add(timing.queuedMs);
+    metrics.dns.add(timing.dnsMs);
+    if (timing.connectMs > 0) {
+        metrics.connect.add(timing.connectMs);
+    }
+    metrics.ttfb.add(timing.ttfbMs);
+    metrics.body.add(timing.bodyMs);
+    metrics.total.add(timing.totalMs);
+}
+
+QStringList NetworkMetrics::hosts() const
+{
+    QMutexLocker locker(&m_mutex);
+    QStringList hosts = m_hosts.keys();
+    hosts.sort();
+    return hosts;
+}
+
+NetworkMetrics::HostMetrics NetworkMetrics::hostMetrics(const QString &host) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hosts.value(host.toLower());
+}
+
+QJsonObject NetworkMetrics::toJson() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    QJsonObject hosts;
+    for (auto it = m_hosts.constBegin(); it != m_hosts.constEnd(); ++it) {
+        const HostMetrics &metrics = it.value();
+        QJsonObject host;
+        host["requests"] = metrics.requests;
+        host["failures"] = metrics.failures;
+        host["transferBytes"] = metrics.transferBytes;
+        host["decodedBytes"] = metrics.decodedBytes;
+
+        QJsonObject phases;
+        phases["queued"] = metrics.queued.toJson();
+        phases["dns"] = metrics.dns.toJson();
+        phases["connect"] = metrics.connect.toJson();
+        phases["ttfb"] = metrics.ttfb.toJson();
+        phases["body"] = metrics.body.toJson();
+        phases["total"] = metrics.total.toJson();
+        host["phasesMs"] = phases;
+
+        hosts[it.key()] = host;
+    }
+
+    QJsonObject json;
+    json["generatedAt"] = QDateTime::currentDateTimeUtc().toString(Qt::ISODate);
+    json["hosts"] = hosts;
+    return json;
+}
+
+bool NetworkMetrics::dumpToFile(const QString &filePath, QString *error) const
+{
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    file.write(QJsonDocument(toJson()).toJson(QJsonDocument::Indented));
+    if (!file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    qDebug() << "NetworkMetrics: Dumped metrics to" << filePath;
+    return true;
+}
+
+void NetworkMetrics::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_hosts.clear();
+}
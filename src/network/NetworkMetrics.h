@@ -0,0 +1,90 @@
+#ifndef NETWORKMETRICS_H
+#define NETWORKMETRICS_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+#include <QMutex>
+#include <QJsonObject>
+#include "HttpResponse.h"
+
+/**
+ * @brief Per-host aggregation of RequestTiming, fed by NetworkDispatcher
+ *
+ * Every completed request adds its phase timings to fixed-bucket histograms
+ * of its host, together with request, failure and byte counters. The data
+ * can be queried per host or dumped as JSON. Thread-safe.
+ */
+class NetworkMetrics
+{
+public:
+    /**
+     * @brief Latency histogram with fixed, roughly logarithmic bucket bounds
+     */
+    class Histogram
+    {
+    public:
+        Histogram();
+
+        void add(qint64 valueMs);
+
+        qint64 count() const { return m_count; }
+        qint64 sum() const { return m_sum; }
+        qint64 maxValue() const { return m_max; }
+        double mean() const { return m_count > 0 ? double(m_sum) / m_count : 0.0; }
+
+        /**
+         * @brief Upper bound of the bucket holding the given percentile, -1 if empty
+         */
+        qint64 percentile(double percent) const;
+
+        QJsonObject toJson() const;
+
+        static const QVector<qint64> &bucketBounds();
+
+    private:
+        QVector<qint64> m_buckets;      // One more than bucketBounds(): the overflow bucket
+        qint64 m_count;
+        qint64 m_sum;
+        qint64 m_max;
+    };
+
+    struct HostMetrics {
+        qint64 requests = 0;
+        qint64 failures = 0;
+        qint64 transferBytes = 0;       // Body bytes on the wire
+        qint64 decodedBytes = 0;        // Body bytes after Content-Encoding decoding
+        Histogram queued;
+        Histogram dns;
+        Histogram connect;              // Only new connections
+        Histogram ttfb;
+        Histogram body;
+        Histogram total;
+    };
+
+    static NetworkMetrics *instance();
+
+    void record(const QString &host, const HttpResponse &response, qint64 decodedBytes);
+
+    QStringList hosts() const;
+    HostMetrics hostMetrics(const QString &host) const;
+
+    QJsonObject toJson() const;
+
+    /**
+     * @brief Write toJson() to a file
+     * @return false with error set if the file could not be written
+     */
+    bool dumpToFile(const QString &filePath, QString *error = nullptr) const;
+
+    void reset();
+
+private:
+    NetworkMetrics() = default;
+
+    mutable QMutex m_mutex;
+    QHash<QString, HostMetrics> m_hosts;
+};
+
+#endif // NETWORKMETRICS_H
@@ -0,0 +1,180 @@
+#include "RateLimiter.h"
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QDebug>
+
+RateLimiter *RateLimiter::instance()
+{
+    static RateLimiter limiter;
+    return &limiter;
+}
+
+RateLimiter::RateLimiter()
+    : m_enabled(true)
+{
+    m_clock.start();
+}
+
+void RateLimiter::setEnabled(bool enabled)
+{
+    QMutexLocker locker(&m_mutex);
+    m_enabled = enabled;
+}
+
+bool RateLimiter::isEnabled() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_enabled;
+}
+
+void RateLimiter::setDefaultPolicy(const HostPolicy &policy)
+{
+    QMutexLocker locker(&m_mutex);
+    m_defaultPolicy = policy;
+}
+
+RateLimiter::HostPolicy RateLimiter::defaultPolicy() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_defaultPolicy;
+}
+
+void RateLimiter::setHostPolicy(const QString &host, const HostPolicy &policy)
+{
+    if (host.isEmpty()) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_policies.insert(host.toLower(), policy);
+}
+
+RateLimiter::HostPolicy RateLimiter::hostPolicy(const QString &host) const
+{
+    QMutexLocker locker(&m_mutex);
+    return policyLocked(host.toLower());
+}
+
+void RateLimiter::clearHostPolicies()
+{
+    QMutexLocker locker(&m_mutex);
+    m_policies.clear();
+}
+
+bool RateLimiter::ownHostPolicy(const QString &host, HostPolicy *policy) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_policies.constFind(host.toLower());
+    if (it == m_policies.constEnd()) {
+        return false;
+    }
+    if (policy) {
+        *policy = *it;
+    }
+    return true;
+}
+
+void RateLimiter::removeHostPolicy(const QString &host)
+{
+    QMutexLocker locker(&m_mutex);
+    m_policies.remove(host.toLower());
+}
+
+int RateLimiter::reserve(const QUrl &url)
+{
+    const QString host = hostKey(url);
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled || host.isEmpty()) {
+        return 0;
+    }
+
+    const HostPolicy policy = policyLocked(host);
+    const qint64 now = m_clock.elapsed();
+    const qint64 tolerance = qint64(qMax(0, policy.burst - 1)) * policy.minIntervalMs;
+
+    HostState &state = m_states[host];
+    const qint64 slot = qMax(now, state.arrivalTime - tolerance);
+    state.arrivalTime = qMax(state.arrivalTime, now) + drawInterval(policy);
+
+    const int wait = int(slot - now);
+    if (wait > 0) {
+        qDebug() << "RateLimiter: Delaying request to" << host << "by" << wait << "ms";
+    }
+    return wait;
+}
+
+int RateLimiter::delayFor(const QString &host) const
+{
+    const QString key = host.toLower();
+
+    QMutexLocker locker(&m_mutex);
+    if (!m_enabled || key.isEmpty()) {
+        return 0;
+    }
+
+    auto it = m_states.constFind(key);
+    if (it == m_states.constEnd()) {
+        return 0;
+    }
+
+    const HostPolicy policy = policyLocked(key);
+    const qint64 tolerance = qint64(qMax(0, policy.burst - 1)) * policy.minIntervalMs;
+    return int(qMax<qint64>(0, it->arrivalTime - tolerance - m_clock.elapsed()));
+}
+
+void RateLimiter::backOff(const QString &host, int delayMs)
+{
+    const QString key = host.toLower();
+    if (key.isEmpty() || delayMs <= 0) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    HostState &state = m_states[key];
+    state.arrivalTime = qMax(state.arrivalTime, m_clock.elapsed()) + delayMs;
+    qDebug() << "RateLimiter: Backing off" << key << "for" << delayMs << "ms";
+}
+
+QString RateLimiter::hostKey(const QUrl &url)
+{
+    return url.host().toLower();
+}
+
+RateLimiter::HostPolicy RateLimiter::policyLocked(const QString &host) const
+{
+    // Walk up the domain so a rule registered for www.example.com also covers m.example.com
+    // and a rule for example.com covers every subdomain
+    QString candidate = host;
+    while (!candidate.isEmpty()) {
+        auto it = m_policies.constFind(candidate);
+        if (it != m_policies.constEnd()) {
+            return *it;
+        }
+        const int dot = candidate.indexOf('.');
+        if (dot < 0 || candidate.indexOf('.', dot + 1) < 0) {
+            break;
+        }
+        candidate = candidate.mid(dot + 1);
+    }
+
+    // Sibling subdomains: www.example.com registered, chapter served from m.example.com
+    const QString parent = host.mid(host.indexOf('.') + 1);
+    for (auto it = m_policies.constBegin(); it != m_policies.constEnd(); ++it) {
+        if (it.key().endsWith(QLatin1Char('.') + parent) && parent.contains('.')) {
+            return it.value();
+        }
+    }
+
+    return m_defaultPolicy;
+}
+
+int RateLimiter::drawInterval(const HostPolicy &policy)
+{
+    const int low = qMax(0, policy.minIntervalMs);
+    const int high = qMax(low, policy.maxIntervalMs);
+    if (high == low) {
+        return low;
+    }
+    return low + int(QRandomGenerator::global()->bounded(high - low + 1));
+}
@@ -0,0 +1,93 @@
+#ifndef RATELIMITER_H
+#define RATELIMITER_H
+
+#include <QString>
+#include <QUrl>
+#include <QHash>
+#include <QMutex>
+#include <QElapsedTimer>
+
+/**
+ * @brief Process-wide per-host request pacing shared by search and download
+ *
+ * Each host gets a token bucket (implemented as GCRA: one "theoretical
+ * arrival time" per host). Every reservation advances the host's schedule by
+ * an interval drawn uniformly from [minIntervalMs, maxIntervalMs], so requests
+ * never follow a fixed rhythm. Reservations never block: they return how long
+ * the caller should wait, and callers schedule the send with a timer.
+ * Thread-safe.
+ */
+class RateLimiter
+{
+public:
+    /**
+     * @brief Pacing applied to one host
+     */
+    struct HostPolicy {
+        int minIntervalMs = 200;    // Lower bound of the spacing between two requests
+        int maxIntervalMs = 400;    // Upper bound; the actual spacing is jittered in between
+        int burst = 1;              // Requests allowed back to back after an idle period
+    };
+
+    static RateLimiter *instance();
+
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /**
+     * @brief Policy for hosts without an explicit one (crawl min/max from NovelConfig)
+     */
+    void setDefaultPolicy(const HostPolicy &policy);
+    HostPolicy defaultPolicy() const;
+
+    /**
+     * @brief Policy for a host; also applies to its subdomains without their own policy
+     */
+    void setHostPolicy(const QString &host, const HostPolicy &policy);
+    HostPolicy hostPolicy(const QString &host) const;
+    void clearHostPolicies();
+
+    /**
+     * @brief Policy set for exactly this host, without the walk up its domain
+     * @return False if the host has none of its own
+     */
+    bool ownHostPolicy(const QString &host, HostPolicy *policy) const;
+    void removeHostPolicy(const QString &host);
+
+    /**
+     * @brief Claim the next slot for a request to this URL's host
+     * @return Milliseconds the caller must wait before sending, 0 to send now
+     */
+    int reserve(const QUrl &url);
+
+    /**
+     * @brief Milliseconds until the host's next slot, without claiming it
+     */
+    int delayFor(const QString &host) const;
+
+    /**
+     * @brief Push the host's schedule back, e.g. after 429/503 or repeated failures
+     */
+    void backOff(const QString &host, int delayMs);
+
+    static QString hostKey(const QUrl &url);
+
+private:
+    RateLimiter();
+
+    struct HostState {
+        qint64 arrivalTime = 0;     // Theoretical arrival time on m_clock, ms
+    };
+
+    HostPolicy policyLocked(const QString &host) const;
+    static int drawInterval(const HostPolicy &policy);
+
+    mutable QMutex m_mutex;
+    bool m_enabled;
+    QElapsedTimer m_clock;
+    HostPolicy m_defaultPolicy;
+    QHash<QString, HostPolicy> m_policies;
+    QHash<QString, HostState> m_states;
+};
+
+#endif // RATELIMITER_H
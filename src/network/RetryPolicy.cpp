@@ -0,0 +1,125 @@
+#include "RetryPolicy.h"
+#include <QMutexLocker>
+#include <QRandomGenerator>
+#include <QDebug>
+
+RetryPolicy::RetryPolicy(int maxRetries, int baseDelayMs, int maxDelayMs)
+    : m_maxRetries(qMax(0, maxRetries))
+    , m_baseDelayMs(qMax(1, baseDelayMs))
+    , m_maxDelayMs(qMax(m_baseDelayMs, maxDelayMs))
+{
+}
+
+void RetryPolicy::setMaxRetries(int maxRetries)
+{
+    m_maxRetries = qMax(0, maxRetries);
+}
+
+void RetryPolicy::setBaseDelayMs(int delayMs)
+{
+    m_baseDelayMs = qMax(1, delayMs);
+    m_maxDelayMs = qMax(m_baseDelayMs, m_maxDelayMs);
+}
+
+void RetryPolicy::setMaxDelayMs(int delayMs)
+{
+    m_maxDelayMs = qMax(m_baseDelayMs, delayMs);
+}
+
+int RetryPolicy::backoffDelay(int attempt) const
+{
+    // Cap the shift so the exponent cannot overflow before the min() applies
+    const int shift = qBound(0, attempt, 20);
+    const qint64 ceiling = qMin<qint64>(m_maxDelayMs, qint64(m_baseDelayMs) << shift);
+    return QRandomGenerator::global()->bounded(int(ceiling) + 1);
+}
+
+int RetryPolicy::backoffDelay(int attempt, const HttpResponse &response) const
+{
+    int delay = backoffDelay(attempt);
+
+    bool ok = false;
+    const int retryAfter = response.header("Retry-After").trimmed().toInt(&ok);
+    if (ok && retryAfter > 0) {
+        delay = qMax(delay, qMin(retryAfter * 1000, m_maxDelayMs));
+    }
+    return delay;
+}
+
+bool RetryPolicy::isRetryable(const HttpResponse &response)
+{
+    if (response.statusCode == 408 || response.statusCode == 429 || response.statusCode >= 500) {
+        return true;
+    }
+    if (response.statusCode > 0) {
+        return false;
+    }
+
+    switch (response.networkError) {
+    case QNetworkReply::TimeoutError:
+    case QNetworkReply::ConnectionRefusedError:
+    case QNetworkReply::RemoteHostClosedError:
+    case QNetworkReply::HostNotFoundError:
+    case QNetworkReply::TemporaryNetworkFailureError:
+    case QNetworkReply::NetworkSessionFailedError:
+    case QNetworkReply::ProxyConnectionClosedError:
+    case QNetworkReply::ProxyTimeoutError:
+    case QNetworkReply::UnknownNetworkError:
+        return true;
+    default:
+        // Includes OperationCanceledError (shutdown) and ServiceUnavailableError (circuit open)
+        return false;
+    }
+}
+
+RetryBudget *RetryBudget::instance()
+{
+    static RetryBudget budget;
+    return &budget;
+}
+
+RetryBudget::RetryBudget()
+    : m_lastRefill(0)
+    , m_ratio(0.2)
+    , m_minPerSecond(1.0)
+    , m_maxTokens(20.0)
+{
+    m_clock.start();
+    m_tokens = m_maxTokens;
+}
+
+void RetryBudget::configure(double ratio, double minRetriesPerSecond, double maxTokens)
+{
+    QMutexLocker locker(&m_mutex);
+    m_ratio = qMax(0.0, ratio);
+    m_minPerSecond = qMax(0.0, minRetriesPerSecond);
+    m_maxTokens = qMax(1.0, maxTokens);
+    m_tokens = qMin(m_tokens, m_maxTokens);
+}
+
+void RetryBudget::recordRequest()
+{
+    QMutexLocker locker(&m_mutex);
+    refillLocked();
+    m_tokens = qMin(m_maxTokens, m_tokens + m_ratio);
+}
+
+bool RetryBudget::tryAcquire()
+{
+    QMutexLocker locker(&m_mutex);
+    refillLocked();
+    if (m_tokens < 1.0) {
+        qDebug() << "RetryBudget: Budget exhausted, not retrying";
+        return false;
+    }
+    m_tokens -= 1.0;
+    return true;
+}
+
+void RetryBudget::refillLocked()
+{
+    const qint64 now = m_clock.elapsed();
+    const double seconds = (now - m_lastRefill) / 1000.0;
+    m_lastRefill = now;
+    m_tokens = qMin(m_maxTokens, m_tokens + seconds * m_minPerSecond);
+}
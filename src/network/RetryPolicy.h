@@ -0,0 +1,93 @@
+#ifndef RETRYPOLICY_H
+#define RETRYPOLICY_H
+
+#include <QMutex>
+#include <QElapsedTimer>
+#include "HttpResponse.h"
+
+/**
+ * @brief Retry schedule shared by HttpClient and ChapterDownloader
+ *
+ * Delays grow exponentially from baseDelayMs and are drawn with "full jitter"
+ * (uniform in [0, min(maxDelayMs, baseDelayMs * 2^attempt)]), so workers that
+ * failed together do not come back together. Value type.
+ */
+class RetryPolicy
+{
+public:
+    explicit RetryPolicy(int maxRetries = 2, int baseDelayMs = 500, int maxDelayMs = 30000);
+
+    int maxRetries() const { return m_maxRetries; }
+    int baseDelayMs() const { return m_baseDelayMs; }
+    int maxDelayMs() const { return m_maxDelayMs; }
+
+    void setMaxRetries(int maxRetries);
+    void setBaseDelayMs(int delayMs);
+    void setMaxDelayMs(int delayMs);
+
+    /**
+     * @brief Whether another attempt is allowed after `attempt` retries
+     */
+    bool canRetry(int attempt) const { return attempt < m_maxRetries; }
+
+    /**
+     * @brief Jittered delay before retry number `attempt` (0-based)
+     */
+    int backoffDelay(int attempt) const;
+
+    /**
+     * @brief Delay for a failed response, honouring Retry-After when the server sent one
+     */
+    int backoffDelay(int attempt, const HttpResponse &response) const;
+
+    /**
+     * @brief Transient failures worth retrying: timeouts, connection errors, 408, 429 and 5xx
+     *
+     * Fail-fast responses from an open CircuitBreaker are not retryable.
+     */
+    static bool isRetryable(const HttpResponse &response);
+
+private:
+    int m_maxRetries;
+    int m_baseDelayMs;
+    int m_maxDelayMs;
+};
+
+/**
+ * @brief Process-wide cap on retries as a share of first attempts
+ *
+ * Every first attempt deposits `ratio` tokens, every retry withdraws one, and a
+ * small floor refills over time so a quiet client can still retry. When a site
+ * starts failing everything, retries stop at roughly ratio * traffic instead
+ * of multiplying it. Thread-safe.
+ */
+class RetryBudget
+{
+public:
+    static RetryBudget *instance();
+
+    void recordRequest();
+
+    /**
+     * @brief Take one retry token
+     * @return false if the budget is exhausted and the failure should be returned as-is
+     */
+    bool tryAcquire();
+
+    void configure(double ratio, double minRetriesPerSecond, double maxTokens);
+
+private:
+    RetryBudget();
+
+    void refillLocked();
+
+    QMutex m_mutex;
+    QElapsedTimer m_clock;
+    qint64 m_lastRefill;
+    double m_tokens;
+    double m_ratio;
+    double m_minPerSecond;
+    double m_maxTokens;
+};
+
+#endif // RETRYPOLICY_H
@@ -0,0 +1,281 @@
+#include "SharedCookieStore.h"
+#include <QMutexLocker>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QFile>
+#include <QDir>
+#include <QDebug>
+#include <algorithm>
+
+SharedCookieStore *SharedCookieStore::instance()
+{
+    static SharedCookieStore store;
+    return &store;
+}
+
+QString SharedCookieStore::bucketKey(const QString &domain)
+{
+    QString key = domain.toLower();
+    if (key.startsWith('.')) {
+        key.remove(0, 1);
+    }
+    return key;
+}
+
+SharedCookieStore::Stripe &SharedCookieStore::stripeFor(const QString &key)
+{
+    return m_stripes[qHash(key) % STRIPE_COUNT];
+}
+
+const SharedCookieStore::Stripe &SharedCookieStore::stripeFor(const QString &key) const
+{
+    return m_stripes[qHash(key) % STRIPE_COUNT];
+}
+
+bool SharedCookieStore::domainMatches(const QNetworkCookie &cookie, const QString &host)
+{
+    const QString domain = cookie.domain().toLower();
+    if (!domain.startsWith('.')) {
+        return host == domain;      // Host-only cookie
+    }
+    return host == domain.mid(1) || host.endsWith(domain);
+}
+
+bool SharedCookieStore::pathMatches(const QNetworkCookie &cookie, const QString &path)
+{
+    const QString cookiePath = cookie.path().isEmpty() ? QStringLiteral("/") : cookie.path();
+    const QString requestPath = path.isEmpty() ? QStringLiteral("/") : path;
+    if (!requestPath.startsWith(cookiePath)) {
+        return false;
+    }
+    // "/foo" matches "/foo/bar" but not "/foobar"
+    return requestPath.size() == cookiePath.size() || cookiePath.endsWith('/')
+        || requestPath.at(cookiePath.size()) == '/';
+}
+
+bool SharedCookieStore::isExpired(const QNetworkCookie &cookie, const QDateTime &now)
+{
+    return !cookie.isSessionCookie() && cookie.expirationDate() <= now;
+}
+
+QList<QNetworkCookie> SharedCookieStore::cookiesForUrl(const QUrl &url) const
+{
+    QList<QNetworkCookie> result;
+    const QString host = url.host().toLower();
+    if (host.isEmpty()) {
+        return result;
+    }
+
+    const bool secure = url.scheme().compare("https", Qt::CaseInsensitive) == 0;
+    const QString path = url.path();
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+
+    // Walk the host and its parent domains; each lives in its own bucket
+    QString candidate = host;
+    while (!candidate.isEmpty()) {
+        const Stripe &stripe = stripeFor(candidate);
+        {
+            QMutexLocker locker(&stripe.mutex);
+            const auto it = stripe.byDomain.constFind(candidate);
+            if (it != stripe.byDomain.constEnd()) {
+                for (const QNetworkCookie &cookie : it.value()) {
+                    if ((!cookie.isSecure() || secure) && domainMatches(cookie, host)
+                        && pathMatches(cookie, path) && !isExpired(cookie, now)) {
+                        result.append(cookie);
+                    }
+                }
+            }
+        }
+
+        const int dot = candidate.indexOf('.');
+        candidate = dot < 0 ? QString() : candidate.mid(dot + 1);
+    }
+
+    std::stable_sort(result.begin(), result.end(), [](const QNetworkCookie &a, const QNetworkCookie &b) {
+        return a.path().size() > b.path().size();
+    });
+    return result;
+}
+
+QByteArray SharedCookieStore::value(const QUrl &url, const QByteArray &name) const
+{
+    for (const QNetworkCookie &cookie : cookiesForUrl(url)) {
+        if (cookie.name() == name) {
+            return cookie.value();
+        }
+    }
+    return QByteArray();
+}
+
+int SharedCookieStore::setCookiesFromUrl(const QList<QNetworkCookie> &cookies, const QUrl &url)
+{
+    const QString host = url.host().toLower();
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    int stored = 0;
+
+    for (QNetworkCookie cookie : cookies) {
+        cookie.normalize(url);
+
+        // Refuse cookies for other sites and for bare top-level domains
+        const QString key = bucketKey(cookie.domain());
+        if (!domainMatches(cookie, host) || (cookie.domain().startsWith('.') && !key.contains('.'))) {
+            qDebug() << "SharedCookieStore: Rejecting cookie" << cookie.name() << "for domain" << cookie.domain()
+                     << "from" << host;
+            continue;
+        }
+
+        Stripe &stripe = stripeFor(key);
+        QMutexLocker locker(&stripe.mutex);
+        storeLocked(stripe, key, cookie, now);
+        stored++;
+    }
+    return stored;
+}
+
+bool SharedCookieStore::insert(const QNetworkCookie &cookie)
+{
+    if (cookie.domain().isEmpty()) {
+        qWarning() << "SharedCookieStore: Rejecting cookie without domain" << cookie.name();
+        return false;
+    }
+
+    QNetworkCookie normalized = cookie;
+    if (normalized.path().isEmpty()) {
+        normalized.setPath("/");
+    }
+
+    const QString key = bucketKey(normalized.domain());
+    Stripe &stripe = stripeFor(key);
+    QMutexLocker locker(&stripe.mutex);
+    storeLocked(stripe, key, normalized, QDateTime::currentDateTimeUtc());
+    return true;
+}
+
+void SharedCookieStore::storeLocked(Stripe &stripe, const QString &key, const QNetworkCookie &cookie, const QDateTime &now)
+{
+    QList<QNetworkCookie> &bucket = stripe.byDomain[key];
+    for (int i = 0; i < bucket.size(); ++i) {
+        if (bucket[i].hasSameIdentifier(cookie)) {
+            bucket.removeAt(i);
+            break;
+        }
+    }
+
+    // Servers delete cookies by sending them already expired
+    if (!isExpired(cookie, now)) {
+        bucket.append(cookie);
+    }
+    if (bucket.isEmpty()) {
+        stripe.byDomain.remove(key);
+    }
+}
+
+QList<QNetworkCookie> SharedCookieStore::allCookies() const
+{
+    QList<QNetworkCookie> cookies;
+    for (const Stripe &stripe : m_stripes) {
+        QMutexLocker locker(&stripe.mutex);
+        for (const QList<QNetworkCookie> &bucket : stripe.byDomain) {
+            cookies.append(bucket);
+        }
+    }
+    return cookies;
+}
+
+void SharedCookieStore::clear()
+{
+    for (Stripe &stripe : m_stripes) {
+        QMutexLocker locker(&stripe.mutex);
+        stripe.byDomain.clear();
+    }
+}
+
+bool SharedCookieStore::load(const QString &filePath, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    const QJsonDocument doc = QJsonDocument::fromJson(file.readAll());
+    if (!doc.isArray()) {
+        if (error) {
+            *error = QString("%1 is not a cookie array").arg(filePath);
+        }
+        return false;
+    }
+
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    int loaded = 0;
+    for (const QJsonValue &value : doc.array()) {
+        const QJsonObject json = value.toObject();
+        QNetworkCookie cookie(json["name"].toString().toUtf8(), json["value"].toString().toUtf8());
+        cookie.setDomain(json["domain"].toString());
+        cookie.setPath(json["path"].toString("/"));
+        cookie.setSecure(json["secure"].toBool());
+        cookie.setHttpOnly(json["httpOnly"].toBool());
+        if (json.contains("expires")) {
+            cookie.setExpirationDate(QDateTime::fromString(json["expires"].toString(), Qt::ISODate));
+        }
+
+        if (cookie.name().isEmpty() || cookie.domain().isEmpty() || isExpired(cookie, now)) {
+            continue;
+        }
+        insert(cookie);
+        loaded++;
+    }
+
+    qDebug() << "SharedCookieStore: Loaded" << loaded << "cookies from" << filePath;
+    return true;
+}
+
+bool SharedCookieStore::save(const QString &filePath, QString *error) const
+{
+    const QDateTime now = QDateTime::currentDateTimeUtc();
+    QJsonArray cookieArray;
+    for (const QNetworkCookie &cookie : allCookies()) {
+        if (isExpired(cookie, now)) {
+            continue;
+        }
+        QJsonObject cookieObj;
+        cookieObj["name"] = QString::fromUtf8(cookie.name());
+        cookieObj["value"] = QString::fromUtf8(cookie.value());
+        cookieObj["domain"] = cookie.domain();
+        cookieObj["path"] = cookie.path();
+        if (cookie.isSecure()) {
+            cookieObj["secure"] = true;
+        }
+        if (cookie.isHttpOnly()) {
+            cookieObj["httpOnly"] = true;
+        }
+        if (!cookie.isSessionCookie()) {
+            cookieObj["expires"] = cookie.expirationDate().toUTC().toString(Qt::ISODate);
+        }
+        cookieArray.append(cookieObj);
+    }
+
+    QDir().mkpath(QFileInfo(filePath).absolutePath());
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+    file.write(QJsonDocument(cookieArray).toJson());
+    if (!file.commit()) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    qDebug() << "SharedCookieStore: Saved" << cookieArray.size() << "cookies to" << filePath;
+    return true;
+}
@@ -0,0 +1,121 @@
+#ifndef SHAREDCOOKIESTORE_H
+#define SHAREDCOOKIESTORE_H
+
+#include <QString>
+#include <QUrl>
+#include <QHash>
+#include <QList>
+#include <QMutex>
+#include <QNetworkCookie>
+#include <QNetworkCookieJar>
+#include <QDateTime>
+
+/**
+ * @brief Process-wide cookie store shared by every HttpClient
+ *
+ * Session cookies set during a search (anti-bot tokens such as waf_sc) are
+ * seen by the download workers' clients too, so they are not challenged
+ * again. Cookies are bucketed by domain; the buckets are spread over a fixed
+ * set of lock stripes, so clients working on different sites rarely contend.
+ * Thread-safe. Domain and path matching follows RFC 6265 in the form
+ * QNetworkCookie::normalize() produces: a leading dot marks a domain cookie,
+ * no dot a host-only cookie.
+ */
+class SharedCookieStore
+{
+public:
+    static SharedCookieStore *instance();
+
+    /**
+     * @brief Cookies to send with a request to the URL, longest path first
+     */
+    QList<QNetworkCookie> cookiesForUrl(const QUrl &url) const;
+
+    /**
+     * @brief Value of a named cookie that would be sent to the URL, empty if none
+     */
+    QByteArray value(const QUrl &url, const QByteArray &name) const;
+
+    /**
+     * @brief Store cookies received from the URL
+     *
+     * Missing domain and path are filled in from the URL; cookies for a
+     * domain the URL does not belong to are ignored. An expired cookie
+     * deletes the stored one with the same name, domain and path.
+     * @return Number of cookies stored
+     */
+    int setCookiesFromUrl(const QList<QNetworkCookie> &cookies, const QUrl &url);
+
+    /**
+     * @brief Store a cookie as is, replacing name/domain/path matches
+     * @return false if the cookie has no domain and was not stored
+     */
+    bool insert(const QNetworkCookie &cookie);
+
+    QList<QNetworkCookie> allCookies() const;
+    void clear();
+
+    /**
+     * @brief Merge cookies from a JSON file written by save(); expired ones are skipped
+     */
+    bool load(const QString &filePath, QString *error = nullptr);
+
+    /**
+     * @brief Write all unexpired cookies as JSON, session cookies included
+     */
+    bool save(const QString &filePath, QString *error = nullptr) const;
+
+private:
+    SharedCookieStore() = default;
+
+    static const int STRIPE_COUNT = 16;
+
+    struct Stripe {
+        mutable QMutex mutex;
+        QHash<QString, QList<QNetworkCookie>> byDomain;     // Domain without leading dot -> cookies
+    };
+
+    static QString bucketKey(const QString &domain);
+    static bool domainMatches(const QNetworkCookie &cookie, const QString &host);
+    static bool pathMatches(const QNetworkCookie &cookie, const QString &path);
+    static bool isExpired(const QNetworkCookie &cookie, const QDateTime &now);
+    Stripe &stripeFor(const QString &key);
+    const Stripe &stripeFor(const QString &key) const;
+    void storeLocked(Stripe &stripe, const QString &key, const QNetworkCookie &cookie, const QDateTime &now);
+
+    Stripe m_stripes[STRIPE_COUNT];
+};
+
+/**
+ * @brief Cookie jar view of SharedCookieStore for a QNetworkAccessManager
+ *
+ * Installed on HttpClient's own manager and on NetworkDispatcher's shared one,
+ * so no request keeps cookies in a private jar of its manager.
+ */
+class CustomCookieJar : public QNetworkCookieJar
+{
+public:
+    explicit CustomCookieJar(QObject *parent = nullptr) : QNetworkCookieJar(parent) {}
+
+    QList<QNetworkCookie> cookiesForUrl(const QUrl &url) const override {
+        return SharedCookieStore::instance()->cookiesForUrl(url);
+    }
+
+    bool setCookiesFromUrl(const QList<QNetworkCookie> &cookieList, const QUrl &url) override {
+        return SharedCookieStore::instance()->setCookiesFromUrl(cookieList, url) > 0;
+    }
+
+    // Public interface
+    void setAllCookiesPublic(const QList<QNetworkCookie> &cookieList) {
+        SharedCookieStore::instance()->clear();
+        for (const QNetworkCookie &cookie : cookieList) {
+            SharedCookieStore::instance()->insert(cookie);
+        }
+    }
+
+    QList<QNetworkCookie> allCookiesPublic() const {
+        return SharedCookieStore::instance()->allCookies();
+    }
+};
+
+#endif // SHAREDCOOKIESTORE_H
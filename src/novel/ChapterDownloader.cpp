@@ -1,6 +1,10 @@
 #include "ChapterDownloader.h"
 #include "../network/HttpClient.h"
 #include "../parser/ContentParser.h"
+#include "../parser/ParserPool.h"
+#include "../network/RateLimiter.h"
+#include "../network/RetryPolicy.h"
+#include "../network/CircuitBreaker.h"
 #include <QDebug>
 #include <QUuid>
 #include <QThread>
@@ -14,8 +18,21 @@
 #include <QRegularExpression>
 #include <QNetworkReply>
 #include <QMutexLocker>
+#include <QSet>
 #include <QTextCodec>
 
+namespace {
+
+// Chapter pages are stored only once they parsed to content, so a placeholder
+// or anti-bot page is not served from the cache for the rule's whole TTL
+HttpClient::CachePolicy chapterCachePolicy(const BookSource &bookSource)
+{
+    const int ttl = bookSource.chapterRule() ? bookSource.chapterRule()->cacheTtl() : int(HttpCache::UseServerHeaders);
+    return HttpClient::CachePolicy(ttl, true);
+}
+
+} // namespace
+
 ChapterDownloader::ChapterDownloader(QObject* parent)
     : QObject(parent)
     , m_httpClient(nullptr)
@@ -26,6 +43,11 @@ ChapterDownloader::ChapterDownloader(QObject* parent)
     , m_activeDownloads(0)
     , m_currentInterval(1000)
     , m_consecutiveFailures(0)
+    , m_pacingSaved(false)
+    , m_pacingHostHadPolicy(false)
+    , m_scheduledRetries(0)
+    , m_runId(0)
+    , m_moreTasksExpected(0)
     , m_config()  // Explicitly initialize with default values
 {
     // Register DownloadTask for cross-thread signal/slot communication
@@ -80,6 +102,7 @@ void ChapterDownloader::setDownloadConfig(const DownloadConfig& config)
         emitDebugMessage(QString("ThreadPool maxThreadCount set to: %1").arg(config.maxConcurrent));
     }
     m_currentInterval = config.requestInterval;
+    applyPacing();
 
     emitDebugMessage(QString("Download config updated: concurrent=%1, interval=%2ms")
         .arg(config.maxConcurrent)
@@ -110,6 +133,13 @@ QString ChapterDownloader::addDownloadTask(const Chapter& chapter, const BookSou
         .arg(chapter.title())
         .arg(task.taskId));
 
+    // Tasks added to a running download start without waiting for a completion
+    const bool idleSlot = m_isDownloading && m_activeDownloads < m_config.maxConcurrent;
+    locker.unlock();
+    if (idleSlot) {
+        scheduleNextTask();
+    }
+
     return task.taskId;
 }
 
@@ -167,11 +197,30 @@ void ChapterDownloader::clearAllTasks()
 
     m_taskQueue.clear();
     m_allTasks.clear();
+    m_moreTasksExpected.storeRelease(0);
     updateStats();
+    if (!m_isDownloading) {
+        restorePacing();
+    }
 
     emitDebugMessage("Cleared all download tasks");
 }
 
+void ChapterDownloader::setMoreTasksExpected(bool expected)
+{
+    m_moreTasksExpected.storeRelease(expected ? 1 : 0);
+    if (expected || !m_isDownloading) {
+        return;
+    }
+
+    QMutexLocker locker(&m_taskMutex);
+    const bool drained = m_taskQueue.isEmpty() && m_activeDownloads == 0 && m_scheduledRetries == 0;
+    locker.unlock();
+    if (drained) {
+        stopDownload();
+    }
+}
+
 void ChapterDownloader::startDownload()
 {
     if (m_isDownloading) {
@@ -193,6 +242,8 @@ void ChapterDownloader::startDownload()
     m_isPaused = false;
     m_activeDownloads = 0;
     m_consecutiveFailures = 0;
+    m_scheduledRetries = 0;
+    m_runId++;
     m_downloadTimer.start();
 
     updateStats();
@@ -200,10 +251,7 @@ void ChapterDownloader::startDownload()
 
     emitDebugMessage(QString("Started download, total %1 tasks").arg(m_stats.totalTasks));
 
-    int tasksToStart = qMin(m_config.maxConcurrent, m_taskQueue.size());
-    for (int i = 0; i < tasksToStart; ++i) {
-        processNextTask();
-    }
+    processNextTask();
 }
 
 void ChapterDownloader::pauseDownload()
@@ -254,6 +302,7 @@ void ChapterDownloader::stopDownload()
         m_threadPool->waitForDone(3000);
     }
 
+    restorePacing();
     updateStats();
 
     qDebug() << "=== ChapterDownloader::stopDownload ===";
@@ -269,39 +318,45 @@ void ChapterDownloader::stopDownload()
 
 void ChapterDownloader::processNextTask()
 {
-    if (!m_isDownloading || m_isPaused) {
-        return;
-    }
-
-    QMutexLocker locker(&m_taskMutex);
+    // Every free slot is filled at once: tasks added while a run is going only
+    // restart the one interval timer, and requests to one host are spaced by
+    // the RateLimiter on the network thread anyway
+    while (m_isDownloading && !m_isPaused) {
+        QMutexLocker locker(&m_taskMutex);
+
+        if (m_taskQueue.isEmpty()) {
+            // Check if all tasks are completed
+            if (m_activeDownloads == 0 && m_scheduledRetries == 0 && !m_moreTasksExpected.loadAcquire()) {
+                locker.unlock();
+                stopDownload();
+            }
+            return;
+        }
 
-    if (m_taskQueue.isEmpty()) {
-        // Check if all tasks are completed
-        if (m_activeDownloads == 0) {
-            locker.unlock();
-            stopDownload();
+        if (m_activeDownloads >= m_config.maxConcurrent) {
+            return;
         }
-        return;
-    }
 
-    if (m_activeDownloads >= m_config.maxConcurrent) {
-        return;
-    }
+        DownloadTask task = m_taskQueue.dequeue();
+        task.status = DownloadStatus::Downloading;
+
+        // Update task in the all tasks list
+        for (int i = 0; i < m_allTasks.size(); ++i) {
+            if (m_allTasks[i].taskId == task.taskId) {
+                m_allTasks[i] = task;
+                break;
+            }
+        }
 
-    DownloadTask task = m_taskQueue.dequeue();
-    task.status = DownloadStatus::Downloading;
+        m_activeDownloads++;
+        locker.unlock();
 
-    // Update task in the all tasks list
-    for (int i = 0; i < m_allTasks.size(); ++i) {
-        if (m_allTasks[i].taskId == task.taskId) {
-            m_allTasks[i] = task;
-            break;
-        }
+        startTask(task);
     }
+}
 
-    m_activeDownloads++;
-    locker.unlock();
-
+void ChapterDownloader::startTask(const DownloadTask &task)
+{
     // Use new thread-safe architecture
     qDebug() << "=== PROCESSING TASK ===";
     qDebug() << "maxConcurrent:" << m_config.maxConcurrent;
@@ -309,7 +364,7 @@ void ChapterDownloader::processNextTask()
     qDebug() << "chapterSaveDir:" << m_config.chapterSaveDir;
 
     if (m_config.maxConcurrent == 1) {
-        // Single-threaded mode: execute synchronously in main thread
+        // Single-threaded mode: runs on this thread, continued by reply callbacks
         qDebug() << "=== USING SINGLE-THREADED MODE ===";
         emitDebugMessage(QString("Executing task synchronously: %1").arg(task.taskId));
         executeSyncDownload(task);
@@ -353,9 +408,13 @@ void ChapterDownloader::onTaskCompleted(const QString& taskId, const DownloadTas
     DownloadTask* task = findTask(taskId);
     if (task) {
         *task = completedTask;
-        m_recentDownloadTimes.append(completedTask.downloadTime);
-        if (m_recentDownloadTimes.size() > 10) {
-            m_recentDownloadTimes.removeFirst();
+        // Server response time only: downloadTime also counts our own pacing wait and parsing,
+        // which would make slower pacing look like a slower server. Cache hits carry no timing.
+        if (completedTask.timing.totalMs > 0) {
+            m_recentServerTimes.append(completedTask.timing.ttfbMs);
+            if (m_recentServerTimes.size() > 10) {
+                m_recentServerTimes.removeFirst();
+            }
         }
     }
 
@@ -397,7 +456,7 @@ void ChapterDownloader::onTaskCompleted(const QString& taskId, const DownloadTas
         qDebug() << "=== Scheduling next task ===";
         scheduleNextTask();
     }
-    else if (m_taskQueue.isEmpty() && m_activeDownloads == 0) {
+    else if (m_taskQueue.isEmpty() && m_activeDownloads == 0 && m_scheduledRetries == 0 && !m_moreTasksExpected.loadAcquire()) {
         qDebug() << "=== All tasks completed, calling stopDownload ===";
         // All tasks completed
         stopDownload();
@@ -422,11 +481,39 @@ void ChapterDownloader::onTaskFailed(const QString& taskId, const QString& error
         // Check if retry is needed
         if (task->retryCount < m_config.maxRetries) {
             task->status = DownloadStatus::Pending;
-            m_taskQueue.enqueue(*task);
 
-            emitDebugMessage(QString("Task retry: %1 (attempt %2)")
+            // Back off exponentially with jitter instead of re-queueing at once, and
+            // never before the host's circuit breaker would let the request through
+            const QString host = RateLimiter::hostKey(QUrl(task->chapter.url()));
+            const RetryPolicy policy(m_config.maxRetries, qMax(500, m_currentInterval), 60000);
+            const int delay = qMax(policy.backoffDelay(task->retryCount - 1),
+                                   CircuitBreaker::instance()->remainingOpenMs(host));
+
+            const DownloadTask retryTask = *task;
+            const int runId = m_runId;
+            m_scheduledRetries++;
+            QTimer::singleShot(delay, this, [this, retryTask, runId]() {
+                QMutexLocker locker(&m_taskMutex);
+                if (runId != m_runId) {
+                    return;     // A stopped run's retry must not leak into the next one
+                }
+                m_scheduledRetries--;
+                if (!m_isDownloading) {
+                    return;
+                }
+                m_taskQueue.enqueue(retryTask);
+                const bool canStart = m_activeDownloads < m_config.maxConcurrent;
+                locker.unlock();
+
+                if (canStart) {
+                    scheduleNextTask();
+                }
+            });
+
+            emitDebugMessage(QString("Task retry: %1 (attempt %2, in %3ms)")
                 .arg(task->chapter.title())
-                .arg(task->retryCount));
+                .arg(task->retryCount)
+                .arg(delay));
         }
         else {
             emitDebugMessage(QString("Task failed: %1 - %2")
@@ -447,6 +534,8 @@ void ChapterDownloader::onTaskFailed(const QString& taskId, const QString& error
     // If too many consecutive failures, increase request interval
     if (m_consecutiveFailures >= 3 && m_config.enableSmartInterval) {
         m_currentInterval = qMin(m_currentInterval * 2, 10000);
+        applyPacing();
+        RateLimiter::instance()->backOff(m_pacingHost, m_currentInterval);
         emitDebugMessage(QString("Consecutive failures, adjusted interval to %1ms").arg(m_currentInterval));
     }
 
@@ -454,7 +543,7 @@ void ChapterDownloader::onTaskFailed(const QString& taskId, const QString& error
     if (!m_taskQueue.isEmpty() && m_activeDownloads < m_config.maxConcurrent) {
         scheduleNextTask();
     }
-    else if (m_taskQueue.isEmpty() && m_activeDownloads == 0) {
+    else if (m_taskQueue.isEmpty() && m_activeDownloads == 0 && m_scheduledRetries == 0 && !m_moreTasksExpected.loadAcquire()) {
         // All tasks completed
         stopDownload();
     }
@@ -467,30 +556,84 @@ void ChapterDownloader::scheduleNextTask()
     }
 
     if (m_intervalTimer) {
-        m_intervalTimer->start(m_currentInterval);
+        // Wake up when the next task's host has a free slot instead of blocking in the request
+        int delay = 0;
+        {
+            QMutexLocker locker(&m_taskMutex);
+            if (!m_taskQueue.isEmpty()) {
+                delay = RateLimiter::instance()->delayFor(RateLimiter::hostKey(QUrl(m_taskQueue.head().chapter.url())));
+            }
+        }
+        m_intervalTimer->start(delay);
     }
 }
 
 void ChapterDownloader::adjustRequestInterval()
 {
-    // Adjust interval based on recent download times
-    if (m_recentDownloadTimes.size() >= 5) {
+    // Adjust interval based on how long the server took to start answering recently
+    if (m_recentServerTimes.size() >= 5) {
         qint64 avgTime = 0;
-        for (qint64 time : m_recentDownloadTimes) {
+        for (qint64 time : m_recentServerTimes) {
             avgTime += time;
         }
-        avgTime /= m_recentDownloadTimes.size();
+        avgTime /= m_recentServerTimes.size();
 
-        // If average download time is too long, increase interval
-        if (avgTime > 5000) {
+        // A slow time-to-first-byte means the server is struggling: back off
+        if (avgTime > 2000) {
             m_currentInterval = qMin(m_currentInterval + 500, 5000);
         }
-        else if (avgTime < 1000) {
+        else if (avgTime < 500) {
             m_currentInterval = qMax(m_currentInterval - 200, m_config.requestInterval);
         }
 
-        m_recentDownloadTimes.clear();
+        emitDebugMessage(QString("Average server TTFB %1ms, request interval %2ms")
+            .arg(avgTime).arg(m_currentInterval));
+
+        m_recentServerTimes.clear();
+        applyPacing();
+    }
+}
+
+void ChapterDownloader::applyPacing()
+{
+    if (m_pacingHost.isEmpty()) {
+        return;
+    }
+
+    // Feed the smart interval into the shared limiter so search and every worker slow down together
+    savePacing();
+    RateLimiter *limiter = RateLimiter::instance();
+    RateLimiter::HostPolicy policy = limiter->hostPolicy(m_pacingHost);
+    const int spread = qMax(0, policy.maxIntervalMs - policy.minIntervalMs);
+    policy.minIntervalMs = m_currentInterval;
+    policy.maxIntervalMs = m_currentInterval + spread;
+    limiter->setHostPolicy(m_pacingHost, policy);
+}
+
+void ChapterDownloader::savePacing()
+{
+    if (m_pacingSaved || m_pacingHost.isEmpty()) {
+        return;
     }
+    m_pacingHostHadPolicy = RateLimiter::instance()->ownHostPolicy(m_pacingHost, &m_savedPacingPolicy);
+    m_pacingSaved = true;
+}
+
+void ChapterDownloader::restorePacing()
+{
+    if (!m_pacingSaved) {
+        return;
+    }
+    m_pacingSaved = false;
+
+    RateLimiter *limiter = RateLimiter::instance();
+    if (m_pacingHostHadPolicy) {
+        limiter->setHostPolicy(m_pacingHost, m_savedPacingPolicy);
+    } else {
+        limiter->removeHostPolicy(m_pacingHost);
+    }
+    m_currentInterval = m_config.requestInterval;
+    emitDebugMessage(QString("Restored request pacing of %1").arg(m_pacingHost));
 }
 
 QString ChapterDownloader::generateTaskId() const
@@ -546,9 +689,6 @@ void ChapterDownloader::emitDebugMessage(const QString& message)
 
 void ChapterDownloader::executeSyncDownload(const DownloadTask &task)
 {
-    QElapsedTimer timer;
-    timer.start();
-
     emitDebugMessage(QString("Starting sync download: %1 - %2").arg(task.taskId).arg(task.chapter.title()));
 
     // Validate required components
@@ -567,67 +707,123 @@ void ChapterDownloader::executeSyncDownload(const DownloadTask &task)
         return;
     }
 
-    // Use HttpClient synchronously to get chapter HTML
-    bool success = false;
-    QString error;
-    QString chapterHtml = m_httpClient->getSync(task.chapter.url(), QJsonObject(), &success, &error);
+    auto download = std::make_shared<SyncDownload>();
+    download->task = task;
+    download->runId = m_runId;
+    download->timer.start();
+    download->visited.insert(task.chapter.url());
+    fetchSyncPage(download, task.chapter.url());
+}
+
+void ChapterDownloader::fetchSyncPage(const std::shared_ptr<SyncDownload> &download, const QString &pageUrl)
+{
+    // The reply comes back as a queued call on this thread, so the GUI keeps running
+    // while it is in flight; requests to one host are paced by the RateLimiter
+    m_httpClient->getAsync(pageUrl, QJsonObject(), chapterCachePolicy(download->task.bookSource), this,
+                           [this, download, pageUrl](const HttpResponse &response) {
+        onSyncPageFetched(download, pageUrl, response);
+    });
+}
 
-    if (!success || chapterHtml.isEmpty()) {
-        QString errorMsg = QString("Failed to download chapter: %1").arg(error);
-        emitDebugMessage(QString("Sync download failed: %1").arg(errorMsg));
-        onTaskFailed(task.taskId, errorMsg);
+void ChapterDownloader::onSyncPageFetched(const std::shared_ptr<SyncDownload> &download, const QString &pageUrl,
+                                          const HttpResponse &response)
+{
+    // startDownload() reset the counters this task was part of
+    if (download->runId != m_runId) {
         return;
     }
 
-    emitDebugMessage(QString("Chapter HTML downloaded, length: %1").arg(chapterHtml.length()));
+    const DownloadTask &task = download->task;
+    const bool firstPage = download->pages.isEmpty();
 
-    // Parse chapter content using ContentParser with pagination support
-    QString chapterContent;
-    if (task.bookSource.chapterRule()) {
-        const ChapterRule* chapterRule = task.bookSource.chapterRule();
-
-        // Check if pagination is enabled for this chapter
-        if (chapterRule->pagination() && !chapterRule->nextPage().isEmpty()) {
-            chapterContent = downloadPaginatedChapterContent(chapterHtml, *chapterRule, task.chapter.url());
+    if (!response.success || response.body.isEmpty()) {
+        if (firstPage) {
+            QString errorMsg = QString("Failed to download chapter: %1").arg(response.error);
+            emitDebugMessage(QString("Sync download failed: %1").arg(errorMsg));
+            onTaskFailed(task.taskId, errorMsg);
         } else {
-            chapterContent = m_contentParser->parseChapterContent(chapterHtml, *chapterRule);
+            emitDebugMessage(QString("Failed to download next page: %1 - %2").arg(pageUrl).arg(response.error));
+            finishSyncDownload(download);
         }
+        return;
+    }
+
+    if (firstPage) {
+        download->timing = response.timing;
+        emitDebugMessage(QString("Chapter HTML downloaded, size: %1, charset: %2")
+                         .arg(response.body.size()).arg(QString::fromLatin1(response.charset())));
+    }
+
+    // Parse chapter content using ContentParser with pagination support
+    const ChapterRule *chapterRule = task.bookSource.chapterRule();
+    const bool paginated = chapterRule && chapterRule->pagination() && !chapterRule->nextPage().isEmpty();
+    QString pageContent;
+    QString nextPageUrl;
+    if (paginated) {
+        pageContent = m_contentParser->parseChapterPage(response.text(), *chapterRule, pageUrl, &nextPageUrl);
+    } else if (chapterRule) {
+        pageContent = m_contentParser->parseChapterContent(response.body, response.charset(), *chapterRule);
     } else {
         // Simple HTML cleanup as fallback
-        chapterContent = chapterHtml;
-        chapterContent.remove(QRegularExpression("<[^>]*>"));
-        chapterContent = chapterContent.trimmed();
+        pageContent = response.text();
+        pageContent.remove(QRegularExpression("<[^>]*>"));
+        pageContent = pageContent.trimmed();
     }
 
-    if (chapterContent.isEmpty()) {
-        QString error = "Parsed chapter content is empty";
-        emitDebugMessage(QString("Sync download failed: %1").arg(error));
-        onTaskFailed(task.taskId, error);
+    if (pageContent.isEmpty()) {
+        if (firstPage) {
+            QString error = "Parsed chapter content is empty";
+            emitDebugMessage(QString("Sync download failed: %1").arg(error));
+            onTaskFailed(task.taskId, error);
+        } else {
+            emitDebugMessage(QString("No content found on page %1, stopping pagination").arg(download->pages.size() + 1));
+            finishSyncDownload(download);
+        }
         return;
     }
+    HttpClient::storeInCache(pageUrl, response, chapterCachePolicy(task.bookSource));
+    download->pages.append(pageContent);
 
-    // Create completed task
-    DownloadTask completedTask = task;
-    completedTask.status = DownloadStatus::Completed;
-    completedTask.content = chapterContent;
-    completedTask.downloadTime = timer.elapsed();
+    if (!paginated || nextPageUrl.isEmpty() || download->visited.contains(nextPageUrl)) {
+        finishSyncDownload(download);
+        return;
+    }
+    if (download->pages.size() >= m_config.maxChapterPages) {
+        emitDebugMessage(QString("Reached maximum page limit (%1), stopping pagination").arg(m_config.maxChapterPages));
+        finishSyncDownload(download);
+        return;
+    }
 
-    emitDebugMessage(QString("Sync download completed: %1 - Content length: %2, Time: %3ms")
-                     .arg(task.taskId).arg(chapterContent.length()).arg(completedTask.downloadTime));
+    // On "_N" sub-pages the last page's next link goes to the next chapter
+    const bool subPage = ContentParser::chapterSubPageNumber(task.chapter.url(), nextPageUrl) > 0;
+    if (download->numberedSubPages && !subPage) {
+        emitDebugMessage(QString("Next link leaves the chapter, pagination complete: %1").arg(nextPageUrl));
+        finishSyncDownload(download);
+        return;
+    }
+    download->numberedSubPages = download->numberedSubPages || subPage;
 
-    // Emit completion signal
-    qDebug() << "=== executeSyncDownload calling onTaskCompleted ===";
-    qDebug() << "Task ID:" << task.taskId;
-    qDebug() << "Content length:" << completedTask.content.length();
+    emitDebugMessage(QString("Found next page URL: %1").arg(nextPageUrl));
+    download->visited.insert(nextPageUrl);
+    fetchSyncPage(download, nextPageUrl);
+}
 
-    onTaskCompleted(task.taskId, completedTask);
+void ChapterDownloader::finishSyncDownload(const std::shared_ptr<SyncDownload> &download)
+{
+    const QString chapterContent = ContentParser::stitchChapterPages(download->pages);
 
-    qDebug() << "=== onTaskCompleted call finished ===";
+    // Create completed task
+    DownloadTask completedTask = download->task;
+    completedTask.status = DownloadStatus::Completed;
+    completedTask.content = chapterContent;
+    completedTask.downloadTime = download->timer.elapsed();
+    completedTask.timing = download->timing;
 
-    // Add delay between requests to avoid being blocked
-    if (m_config.requestInterval > 0) {
-        QThread::msleep(m_config.requestInterval);
-    }
+    emitDebugMessage(QString("Sync download completed: %1 - Pages: %2, Content length: %3, Time: %4ms")
+                     .arg(completedTask.taskId).arg(download->pages.size())
+                     .arg(chapterContent.length()).arg(completedTask.downloadTime));
+
+    onTaskCompleted(completedTask.taskId, completedTask);
 }
 
 DownloadTask ChapterDownloader::getDownloadTask(const QString& taskId) const
@@ -732,9 +928,9 @@ void ThreadSafeDownloadWorker::run()
     }
 
     // Download chapter content using thread-safe method
-    QString downloadedContent = downloadChapterContent(task.chapter.url());
+    HttpResponse downloaded = downloadChapterContent(task.chapter.url());
 
-    if (downloadedContent.isEmpty()) {
+    if (!downloaded.success || downloaded.body.isEmpty()) {
         task.status = DownloadStatus::Failed;
         task.error = "Failed to download chapter content";
         task.downloadTime = timer.elapsed();
@@ -743,7 +939,7 @@ void ThreadSafeDownloadWorker::run()
     }
 
     // Parse chapter content using thread-safe method
-    QString parsedContent = parseChapterContent(downloadedContent);
+    QString parsedContent = parseChapterContent(downloaded);
 
     if (parsedContent.isEmpty()) {
         task.status = DownloadStatus::Failed;
@@ -752,6 +948,7 @@ void ThreadSafeDownloadWorker::run()
         emit taskFailed(task.taskId, task.error);
         return;
     }
+    HttpClient::storeInCache(task.chapter.url(), downloaded, chapterCachePolicy(m_bookSource));
 
     // Save individual chapter file if enabled
     qDebug() << "=== CHECKING CHAPTER SAVE CONFIG ===";
@@ -770,47 +967,57 @@ void ThreadSafeDownloadWorker::run()
     task.status = DownloadStatus::Completed;
     task.content = parsedContent;
     task.downloadTime = timer.elapsed();
+    task.timing = downloaded.timing;
 
     emit taskCompleted(task.taskId, task);
 }
 
-QString ThreadSafeDownloadWorker::downloadChapterContent(const QString &url)
+void ThreadSafeDownloadWorker::configureHttpClient(HttpClient &httpClient) const
+{
+    // One quick transport retry; longer outages are retried by ChapterDownloader with backoff
+    httpClient.setMaxRetries(1);
+    // A chapter page is tens of KB; the cap bounds peak memory at threads x 8 MB
+    httpClient.setMaxBodySize(8 * 1024 * 1024);
+}
+
+HttpResponse ThreadSafeDownloadWorker::downloadChapterContent(const QString &url)
 {
     // Create thread-local HttpClient for thread safety
     HttpClient httpClient;
+    configureHttpClient(httpClient);
 
-    // Use HttpClient's synchronous method (same as single-threaded mode)
-    bool success = false;
-    QString error;
-    QString result = httpClient.getSync(url, QJsonObject(), &success, &error);
+    // Pool thread waits on the future; the reply is driven by the shared network thread
+    HttpResponse response = httpClient.getAsync(url, QJsonObject(), chapterCachePolicy(m_bookSource)).result();
 
-    if (!success) {
-        qDebug() << "ThreadSafeDownloadWorker: Download failed:" << error;
-        return QString();
+    if (!response.success) {
+        qDebug() << "ThreadSafeDownloadWorker: Download failed:" << response.error;
     }
 
-    return result;
+    return response;
 }
 
-QString ThreadSafeDownloadWorker::parseChapterContent(const QString &html)
+QString ThreadSafeDownloadWorker::parseChapterContent(const HttpResponse &response)
 {
-    if (html.isEmpty()) {
+    if (response.body.isEmpty()) {
         return QString();
     }
 
-    // Create thread-local ContentParser for thread safety
-    ContentParser parser;
+    // Thread-local ContentParser, kept for the pool thread's lifetime instead of built per chapter
+    ContentParser &parser = *ParserPool::threadContentParser();
 
     // Use the same parsing logic as single-threaded mode
     QString chapterContent;
     if (m_bookSource.chapterRule()) {
         const ChapterRule* chapterRule = m_bookSource.chapterRule();
 
-        // For now, use simple parsing (pagination support can be added later)
-        chapterContent = parser.parseChapterContent(html, *chapterRule);
+        if (chapterRule->pagination() && !chapterRule->nextPage().isEmpty()) {
+            chapterContent = downloadPaginatedChapter(parser, response, *chapterRule);
+        } else {
+            chapterContent = parser.parseChapterContent(response.body, response.charset(), *chapterRule);
+        }
     } else {
         // Simple HTML cleanup as fallback
-        chapterContent = html;
+        chapterContent = response.text();
         chapterContent.remove(QRegularExpression("<[^>]*>"));
         chapterContent = chapterContent.trimmed();
     }
@@ -818,6 +1025,82 @@ QString ThreadSafeDownloadWorker::parseChapterContent(const QString &html)
     return chapterContent;
 }
 
+QString ThreadSafeDownloadWorker::downloadPaginatedChapter(ContentParser &parser, const HttpResponse &firstPage, const ChapterRule &rule)
+{
+    const QString chapterUrl = m_task.chapter.url();
+
+    QString nextPageUrl;
+    const QString firstContent = parser.parseChapterPage(firstPage.text(), rule, chapterUrl, &nextPageUrl);
+    if (firstContent.isEmpty()) {
+        return QString();
+    }
+
+    QStringList pages{firstContent};
+    QSet<QString> visited{chapterUrl};
+    bool numberedSubPages = false;
+    int span = 1;
+
+    HttpClient httpClient;
+    configureHttpClient(httpClient);
+
+    while (!nextPageUrl.isEmpty() && !visited.contains(nextPageUrl) && pages.size() < m_config.maxChapterPages) {
+        // On "_N" sub-pages the last page's next link goes to the next chapter
+        const int nextNumber = ContentParser::chapterSubPageNumber(chapterUrl, nextPageUrl);
+        if (numberedSubPages && nextNumber == 0) {
+            break;
+        }
+        numberedSubPages = nextNumber > 0;
+
+        // Numbered sub-pages are requested before the previous page links them,
+        // doubling the lookahead while the chapter keeps going
+        QStringList batch{nextPageUrl};
+        if (numberedSubPages) {
+            for (int i = 1; i < span && pages.size() + batch.size() < m_config.maxChapterPages; ++i) {
+                batch.append(ContentParser::chapterSubPageUrl(chapterUrl, nextNumber + i));
+            }
+            span = qMin(span * 2, qMax(1, m_config.subPagePrefetch));
+        }
+
+        // Requests to one host are still paced by the RateLimiter on the network thread
+        QList<QFuture<HttpResponse>> replies;
+        for (const QString &url : batch) {
+            replies.append(httpClient.getAsync(url, QJsonObject(), chapterCachePolicy(m_bookSource)));
+        }
+
+        // A speculative page is kept only if the page before it linked to it
+        QString expectedUrl = nextPageUrl;
+        for (int i = 0; i < batch.size(); ++i) {
+            const HttpResponse response = replies[i].result();    // Every reply is awaited before the client goes
+            if (expectedUrl.isEmpty() || batch.at(i) != expectedUrl || visited.contains(expectedUrl)) {
+                continue;
+            }
+            if (!response.success || response.body.isEmpty()) {
+                // A linked page is missing: fail the chapter so it is retried instead of truncated
+                qDebug() << "ThreadSafeDownloadWorker: Chapter page failed:" << batch.at(i) << response.error;
+                for (int j = i + 1; j < replies.size(); ++j) {
+                    replies[j].waitForFinished();
+                }
+                return QString();
+            }
+
+            QString pageNext;
+            const QString pageContent = parser.parseChapterPage(response.text(), rule, batch.at(i), &pageNext);
+            visited.insert(batch.at(i));
+            if (pageContent.isEmpty()) {
+                expectedUrl.clear();
+                continue;
+            }
+            HttpClient::storeInCache(batch.at(i), response, chapterCachePolicy(m_bookSource));
+            pages.append(pageContent);
+            expectedUrl = pageNext;
+        }
+        nextPageUrl = expectedUrl;
+    }
+
+    qDebug() << "ThreadSafeDownloadWorker: Stitched" << pages.size() << "pages of" << m_task.chapter.title();
+    return ContentParser::stitchChapterPages(pages);
+}
+
 void ThreadSafeDownloadWorker::saveChapterToFile(const Chapter &chapter, const QString &content)
 {
     if (content.isEmpty() || m_config.chapterSaveDir.isEmpty()) {
@@ -865,6 +1148,12 @@ void ChapterDownloader::applyBookSourceConfig(const BookSource &bookSource)
     emitDebugMessage(QString("=== applyBookSourceConfig for source: %1 (ID: %2) ===").arg(bookSource.name()).arg(bookSource.id()));
     emitDebugMessage(QString("Current maxConcurrent before apply: %1").arg(m_config.maxConcurrent));
 
+    const QString pacingHost = RateLimiter::hostKey(QUrl(bookSource.url()));
+    if (pacingHost != m_pacingHost) {
+        restorePacing();
+        m_pacingHost = pacingHost;
+    }
+
     if (!bookSource.crawlRule()) {
         emitDebugMessage("No crawl rule found, keeping current config");
         return;
@@ -878,12 +1167,19 @@ void ChapterDownloader::applyBookSourceConfig(const BookSource &bookSource)
         emitDebugMessage(QString("Applied book source thread config: %1").arg(crawlRule->threads()));
     }
 
-    // Apply interval configuration
-    int requestInterval = calculateRequestInterval(bookSource);
-    if (requestInterval > 0) {
-        m_config.requestInterval = requestInterval;
-        m_currentInterval = requestInterval;
-        emitDebugMessage(QString("Applied book source interval config: %1ms").arg(requestInterval));
+    // Apply interval configuration: the crawl rule's range becomes the host's jitter window
+    if (crawlRule->minInterval() > 0) {
+        m_config.requestInterval = crawlRule->minInterval();
+        m_currentInterval = crawlRule->minInterval();
+
+        savePacing();
+        RateLimiter::HostPolicy policy = RateLimiter::instance()->hostPolicy(m_pacingHost);
+        policy.minIntervalMs = crawlRule->minInterval();
+        policy.maxIntervalMs = qMax(crawlRule->minInterval(), crawlRule->maxInterval());
+        RateLimiter::instance()->setHostPolicy(m_pacingHost, policy);
+
+        emitDebugMessage(QString("Applied book source interval config: %1-%2ms for %3")
+            .arg(policy.minIntervalMs).arg(policy.maxIntervalMs).arg(m_pacingHost));
     }
 
     // Apply retry configuration
@@ -905,31 +1201,6 @@ void ChapterDownloader::applyBookSourceConfig(const BookSource &bookSource)
     }
 }
 
-int ChapterDownloader::calculateRequestInterval(const BookSource &bookSource)
-{
-    if (!bookSource.crawlRule()) {
-        return m_config.requestInterval;
-    }
-
-    const CrawlRule* crawlRule = bookSource.crawlRule();
-
-    // Use minInterval as base, with some randomization
-    int minInterval = crawlRule->minInterval();
-    int maxInterval = crawlRule->maxInterval();
-
-    if (minInterval <= 0) {
-        return m_config.requestInterval;
-    }
-
-    // Add randomization to avoid detection
-    int range = maxInterval - minInterval;
-    if (range > 0) {
-        return minInterval + (qrand() % range);
-    }
-
-    return minInterval;
-}
-
 bool ChapterDownloader::isSpecialBookSource(int sourceId)
 {
     // Only truly problematic book sources that need special timeout handling
@@ -941,75 +1212,3 @@ bool ChapterDownloader::isSpecialBookSource(int sourceId)
     return specialSources.contains(sourceId);
 }
 
-QString ChapterDownloader::downloadPaginatedChapterContent(const QString &firstPageHtml, const ChapterRule &rule, const QString &baseUrl)
-{
-    QString allContent;
-    QString currentHtml = firstPageHtml;
-    QString currentBaseUrl = baseUrl;
-    int pageCount = 1;
-    int maxPages = 20; // Safety limit for chapter content
-
-    emitDebugMessage(QString("Starting paginated chapter content download from: %1").arg(baseUrl));
-
-    while (!currentHtml.isEmpty() && pageCount <= maxPages) {
-        emitDebugMessage(QString("Processing page %1 of chapter content").arg(pageCount));
-
-        // Parse content from current page
-        QString pageContent = m_contentParser->parseChapterContentSinglePage(currentHtml, rule);
-
-        if (pageContent.isEmpty()) {
-            emitDebugMessage(QString("No content found on page %1, stopping pagination").arg(pageCount));
-            break;
-        }
-
-        // Append content with separator
-        if (!allContent.isEmpty()) {
-            allContent += "\n\n";
-        }
-        allContent += pageContent;
-
-        emitDebugMessage(QString("Added content from page %1, total length: %2").arg(pageCount).arg(allContent.length()));
-
-        // Find next page URL
-        QString nextPageUrl = m_contentParser->parseNextPageUrl(currentHtml, rule.nextPage(), currentBaseUrl);
-
-        if (nextPageUrl.isEmpty()) {
-            emitDebugMessage("No next page URL found, pagination complete");
-            break;
-        }
-
-        if (nextPageUrl == currentBaseUrl) {
-            emitDebugMessage("Next page URL is same as current, stopping to prevent infinite loop");
-            break;
-        }
-
-        emitDebugMessage(QString("Found next page URL: %1").arg(nextPageUrl));
-
-        // Apply request interval for pagination
-        if (m_config.requestInterval > 0) {
-            QThread::msleep(m_config.requestInterval);
-        }
-
-        // Download next page
-        bool success = false;
-        QString error;
-        QString nextPageHtml = m_httpClient->getSync(nextPageUrl, QJsonObject(), &success, &error);
-
-        if (!success || nextPageHtml.isEmpty()) {
-            emitDebugMessage(QString("Failed to download next page: %1 - %2").arg(nextPageUrl).arg(error));
-            break;
-        }
-
-        currentHtml = nextPageHtml;
-        currentBaseUrl = nextPageUrl;
-        pageCount++;
-    }
-
-    if (pageCount > maxPages) {
-        emitDebugMessage(QString("Reached maximum page limit (%1), stopping pagination").arg(maxPages));
-    }
-
-    emitDebugMessage(QString("Paginated chapter content download completed, total pages: %1, total length: %2").arg(pageCount).arg(allContent.length()));
-    return allContent;
-}
-
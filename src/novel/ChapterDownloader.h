@@ -4,6 +4,7 @@
 #include <QObject>
 #include <QQueue>
 #include <QMutex>
+#include <QAtomicInt>
 #include <QTimer>
 #include <QThreadPool>
 #include <QRunnable>
@@ -11,7 +12,11 @@
 #include <QElapsedTimer>
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QSet>
+#include <memory>
 #include "NovelModels.h"
+#include "../network/HttpResponse.h"
+#include "../network/RateLimiter.h"
 
 class HttpClient;
 class ContentParser;
@@ -41,6 +46,7 @@ struct DownloadTask {
     QString error;            // Error message
     int retryCount;           // Retry count
     qint64 downloadTime;      // Download time (milliseconds)
+    RequestTiming timing;     // Network phases of the chapter request, zero for cache hits
     
     DownloadTask() : status(DownloadStatus::Pending), retryCount(0), downloadTime(0) {}
 };
@@ -50,7 +56,7 @@ struct DownloadTask {
  */
 struct DownloadConfig {
     int maxConcurrent = 2;        // Maximum concurrent downloads (conservative start)
-    int requestInterval = 1000;   // Request interval (milliseconds)
+    int requestInterval = 1000;   // Minimum spacing between requests to one host (milliseconds), enforced by RateLimiter
     int timeout = 15000;          // Timeout duration (milliseconds)
     int maxRetries = 2;           // Maximum retry attempts
     bool enableSmartInterval = true; // Enable smart interval adjustment
@@ -60,6 +66,8 @@ struct DownloadConfig {
     bool saveIndividualChapters = false; // Save each chapter as individual file
     QString chapterSaveDir;       // Directory for individual chapter files
     bool enableAutoMerge = true;  // Auto merge chapter files after download
+    int maxChapterPages = 20;     // Safety limit for pages of one chapter
+    int subPagePrefetch = 4;      // "_N" chapter sub-pages requested at once ahead of their links
 };
 
 /**
@@ -106,6 +114,15 @@ public:
     bool removeDownloadTask(const QString &taskId);
     void clearAllTasks();
 
+    /**
+     * @brief Keep the run open for tasks still being discovered
+     *
+     * While set, an empty queue does not finish the download; tasks added
+     * meanwhile start at once. Clearing it finishes the run if nothing is
+     * left to do.
+     */
+    void setMoreTasksExpected(bool expected);
+
     // Download control
     void startDownload();
     void pauseDownload();
@@ -194,20 +211,35 @@ private:
     QString generateTaskId() const;
     void updateStats();
     void scheduleNextTask();
+    void startTask(const DownloadTask &task);
     void adjustRequestInterval();
+    void applyPacing();
+    void savePacing();
+    void restorePacing();
     DownloadTask* findTask(const QString &taskId);
     void setError(const QString &error);
     void emitDebugMessage(const QString &message);
+
+    // Single-threaded mode: the chapter and its pages are fetched one after another
+    // with callbacks on this thread, which never blocks on a reply
+    struct SyncDownload {
+        DownloadTask task;
+        int runId = 0;
+        QElapsedTimer timer;
+        RequestTiming timing;           // Of the first page
+        QStringList pages;
+        QSet<QString> visited;
+        bool numberedSubPages = false;
+    };
     void executeSyncDownload(const DownloadTask &task);
+    void fetchSyncPage(const std::shared_ptr<SyncDownload> &download, const QString &pageUrl);
+    void onSyncPageFetched(const std::shared_ptr<SyncDownload> &download, const QString &pageUrl, const HttpResponse &response);
+    void finishSyncDownload(const std::shared_ptr<SyncDownload> &download);
 
     // Special book source handling
     void applyBookSourceConfig(const BookSource &bookSource);
-    int calculateRequestInterval(const BookSource &bookSource);
     bool isSpecialBookSource(int sourceId);
 
-    // Pagination support
-    QString downloadPaginatedChapterContent(const QString &firstPageHtml, const ChapterRule &rule, const QString &baseUrl);
-
     // Member variables
     HttpClient *m_httpClient;
     ContentParser *m_contentParser;
@@ -231,9 +263,20 @@ private:
     DownloadStats m_stats;
 
     // Smart interval adjustment
-    QList<qint64> m_recentDownloadTimes;
+    QList<qint64> m_recentServerTimes;      // Time-to-first-byte of recent chapter requests
     int m_currentInterval;
     int m_consecutiveFailures;
+    QString m_pacingHost;                   // Host whose RateLimiter policy follows m_currentInterval
+    // The limiter is process-wide: the host's own policy from before the run is put
+    // back when it ends, so search and later downloads do not inherit its back-off
+    bool m_pacingSaved;
+    bool m_pacingHostHadPolicy;
+    RateLimiter::HostPolicy m_savedPacingPolicy;
+
+    // Failed tasks waiting out their retry backoff before re-entering m_taskQueue
+    int m_scheduledRetries;
+    int m_runId;                            // Incremented per startDownload, invalidates stale retries
+    QAtomicInt m_moreTasksExpected;         // Tasks are still being added, e.g. from later TOC pages; set from the GUI thread
 };
 
 /**
@@ -260,8 +303,10 @@ private:
     BookSource m_bookSource;
 
     // Thread-local components (created in run())
-    QString downloadChapterContent(const QString &url);
-    QString parseChapterContent(const QString &html);
+    void configureHttpClient(HttpClient &httpClient) const;
+    HttpResponse downloadChapterContent(const QString &url);
+    QString parseChapterContent(const HttpResponse &response);
+    QString downloadPaginatedChapter(ContentParser &parser, const HttpResponse &firstPage, const ChapterRule &rule);
     void saveChapterToFile(const Chapter &chapter, const QString &content);
 };
 
@@ -1,5 +1,6 @@
 #include "FileGenerator.h"
 #include "ChapterDownloader.h"
+#include "../parser/TextNormalizer.h"
 #include <QDebug>
 #include <QFile>
 #include <QFileInfo>
@@ -378,25 +379,18 @@ QString FileGenerator::convertToMarkdown(const QList<Chapter> &chapters, const Q
 
 QString FileGenerator::cleanChapterContent(const QString &content) const
 {
-    QString cleaned = content;
-
-    cleaned = cleanHtmlTags(cleaned);
-
-    QStringList adPatterns = {
-        "www\\..*?\\.com",
-        "\\(.*?www\\..*?\\.com.*?\\)"
+    static const QRegularExpression adPatterns[] = {
+        QRegularExpression("www\\..*?\\.com", QRegularExpression::CaseInsensitiveOption),
+        QRegularExpression("\\(.*?www\\..*?\\.com.*?\\)", QRegularExpression::CaseInsensitiveOption)
     };
 
-    for (const QString &pattern : adPatterns) {
-        cleaned.remove(QRegularExpression(pattern, QRegularExpression::CaseInsensitiveOption));
+    QString cleaned = content;
+    for (const QRegularExpression &pattern : adPatterns) {
+        cleaned.remove(pattern);
     }
 
-    cleaned.replace(QRegularExpression("\\s+"), " ");
-    cleaned.replace(QRegularExpression("\\s*\\n\\s*"), "\n");
-
-    cleaned = cleaned.trimmed();
-
-    return cleaned;
+    // Same normalization the parser applies, so already clean text passes through unchanged
+    return TextNormalizer::normalize(cleaned, TextNormalizer::ChapterText);
 }
 
 QString FileGenerator::formatChapterTitle(const Chapter &chapter) const
@@ -442,22 +436,6 @@ QString FileGenerator::getChapterSeparatorString() const
     }
 }
 
-QString FileGenerator::cleanHtmlTags(const QString &content) const
-{
-    QString cleaned = content;
-
-    cleaned.remove(QRegularExpression("<[^>]*>"));
-
-    cleaned.replace("&nbsp;", " ");
-    cleaned.replace("&lt;", "<");
-    cleaned.replace("&gt;", ">");
-    cleaned.replace("&amp;", "&");
-    cleaned.replace("&quot;", "\"");
-    cleaned.replace("&#39;", "'");
-
-    return cleaned;
-}
-
 QString FileGenerator::formatParagraphs(const QString &content) const
 {
     QStringList lines = content.split('\n');
@@ -124,7 +124,6 @@ private:
     QString getChapterSeparatorString() const;
     QString encodeText(const QString &text, TextEncoding encoding) const;
     QTextCodec* getTextCodec(TextEncoding encoding) const;
-    QString cleanHtmlTags(const QString &content) const;
     QString formatParagraphs(const QString &content) const;
     QString wrapLines(const QString &content, int maxLength) const;
     void updateStats(const GenerationStats &stats);
@@ -324,6 +324,7 @@ void SearchRule::fromJson(const QJsonObject &json)
 
 BookRule::BookRule()
     : m_timeout(15)
+    , m_cacheTtl(3600)
 {
 }
 
@@ -332,6 +333,7 @@ QJsonObject BookRule::toJson() const
     QJsonObject json;
     json["baseUri"] = m_baseUri;
     json["timeout"] = m_timeout;
+    json["cacheTtl"] = m_cacheTtl;
     json["url"] = m_url;
     json["bookName"] = m_bookName;
     json["author"] = m_author;
@@ -349,6 +351,7 @@ void BookRule::fromJson(const QJsonObject &json)
 {
     m_baseUri = json["baseUri"].toString();
     m_timeout = json["timeout"].toInt(15);
+    m_cacheTtl = json["cacheTtl"].toInt(3600);
     m_url = json["url"].toString();
     m_bookName = json["bookName"].toString();
     m_author = json["author"].toString();
@@ -365,6 +368,7 @@ void BookRule::fromJson(const QJsonObject &json)
 
 TocRule::TocRule()
     : m_timeout(30)
+    , m_cacheTtl(600)
     , m_isDesc(false)
     , m_pagination(false)
 {
@@ -375,6 +379,7 @@ QJsonObject TocRule::toJson() const
     QJsonObject json;
     json["baseUri"] = m_baseUri;
     json["timeout"] = m_timeout;
+    json["cacheTtl"] = m_cacheTtl;
     json["url"] = m_url;
     json["list"] = m_list;
     json["item"] = m_item;
@@ -388,6 +393,7 @@ void TocRule::fromJson(const QJsonObject &json)
 {
     m_baseUri = json["baseUri"].toString();
     m_timeout = json["timeout"].toInt(30);
+    m_cacheTtl = json["cacheTtl"].toInt(600);
     m_url = json["url"].toString();
     m_list = json["list"].toString();
     m_item = json["item"].toString();
@@ -400,6 +406,7 @@ void TocRule::fromJson(const QJsonObject &json)
 
 ChapterRule::ChapterRule()
     : m_timeout(10)
+    , m_cacheTtl(30 * 24 * 3600)
     , m_paragraphTagClosed(false)
     , m_pagination(false)
 {
@@ -410,6 +417,7 @@ QJsonObject ChapterRule::toJson() const
     QJsonObject json;
     json["baseUri"] = m_baseUri;
     json["timeout"] = m_timeout;
+    json["cacheTtl"] = m_cacheTtl;
     json["title"] = m_title;
     json["content"] = m_content;
     json["paragraphTagClosed"] = m_paragraphTagClosed;
@@ -427,6 +435,7 @@ void ChapterRule::fromJson(const QJsonObject &json)
 {
     m_baseUri = json["baseUri"].toString();
     m_timeout = json["timeout"].toInt(10);
+    m_cacheTtl = json["cacheTtl"].toInt(30 * 24 * 3600);
     m_title = json["title"].toString();
     m_content = json["content"].toString();
     m_paragraphTagClosed = json["paragraphTagClosed"].toBool(false);
@@ -479,6 +488,7 @@ BookSource::BookSource()
     : m_id(-1)
     , m_needProxy(false)
     , m_disabled(false)
+    , m_http2(false)
 {
 }
 
@@ -490,6 +500,7 @@ BookSource::BookSource(const BookSource &other)
     , m_language(other.m_language)
     , m_needProxy(other.m_needProxy)
     , m_disabled(other.m_disabled)
+    , m_http2(other.m_http2)
     , m_searchRule(other.m_searchRule)
     , m_bookRule(other.m_bookRule)
     , m_tocRule(other.m_tocRule)
@@ -508,6 +519,7 @@ BookSource& BookSource::operator=(const BookSource &other)
         m_language = other.m_language;
         m_needProxy = other.m_needProxy;
         m_disabled = other.m_disabled;
+        m_http2 = other.m_http2;
         m_searchRule = other.m_searchRule;
         m_bookRule = other.m_bookRule;
         m_tocRule = other.m_tocRule;
@@ -547,6 +559,7 @@ QJsonObject BookSource::toJson() const
     json["language"] = m_language;
     json["needProxy"] = m_needProxy;
     json["disabled"] = m_disabled;
+    json["http2"] = m_http2;
 
 
     if (hasSearch()) {
@@ -570,6 +583,7 @@ void BookSource::fromJson(const QJsonObject &json)
     m_language = json["language"].toString();
     m_needProxy = json["needProxy"].toBool(false);
     m_disabled = json["disabled"].toBool(false);
+    m_http2 = json["http2"].toBool(false);
 
 
     if (json.contains("search")) {
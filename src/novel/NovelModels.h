@@ -255,6 +255,7 @@ public:
     // Getters
     QString baseUri() const { return m_baseUri; }
     int timeout() const { return m_timeout; }
+    int cacheTtl() const { return m_cacheTtl; }
     QString url() const { return m_url; }
     QString bookName() const { return m_bookName; }
     QString author() const { return m_author; }
@@ -269,6 +270,7 @@ public:
     // Setters
     void setBaseUri(const QString &baseUri) { m_baseUri = baseUri; }
     void setTimeout(int timeout) { m_timeout = timeout; }
+    void setCacheTtl(int seconds) { m_cacheTtl = seconds; }
     void setUrl(const QString &url) { m_url = url; }
     void setBookName(const QString &bookName) { m_bookName = bookName; }
     void setAuthor(const QString &author) { m_author = author; }
@@ -287,6 +289,7 @@ public:
 private:
     QString m_baseUri;
     int m_timeout;
+    int m_cacheTtl;            // HTTP cache TTL in seconds (-1 immutable, -2 server headers)
     QString m_url;
     QString m_bookName;
     QString m_author;
@@ -310,6 +313,7 @@ public:
     // Getters
     QString baseUri() const { return m_baseUri; }
     int timeout() const { return m_timeout; }
+    int cacheTtl() const { return m_cacheTtl; }
     QString url() const { return m_url; }
     QString list() const { return m_list; }
     QString item() const { return m_item; }
@@ -320,6 +324,7 @@ public:
     // Setters
     void setBaseUri(const QString &baseUri) { m_baseUri = baseUri; }
     void setTimeout(int timeout) { m_timeout = timeout; }
+    void setCacheTtl(int seconds) { m_cacheTtl = seconds; }
     void setUrl(const QString &url) { m_url = url; }
     void setList(const QString &list) { m_list = list; }
     void setItem(const QString &item) { m_item = item; }
@@ -334,6 +339,7 @@ public:
 private:
     QString m_baseUri;
     int m_timeout;
+    int m_cacheTtl;            // HTTP cache TTL in seconds, short: TOCs grow
     QString m_url;
     QString m_list;
     QString m_item;
@@ -353,6 +359,7 @@ public:
     // Getters
     QString baseUri() const { return m_baseUri; }
     int timeout() const { return m_timeout; }
+    int cacheTtl() const { return m_cacheTtl; }
     QString title() const { return m_title; }
     QString content() const { return m_content; }
     bool paragraphTagClosed() const { return m_paragraphTagClosed; }
@@ -367,6 +374,7 @@ public:
     // Setters
     void setBaseUri(const QString &baseUri) { m_baseUri = baseUri; }
     void setTimeout(int timeout) { m_timeout = timeout; }
+    void setCacheTtl(int seconds) { m_cacheTtl = seconds; }
     void setTitle(const QString &title) { m_title = title; }
     void setContent(const QString &content) { m_content = content; }
     void setParagraphTagClosed(bool closed) { m_paragraphTagClosed = closed; }
@@ -385,6 +393,7 @@ public:
 private:
     QString m_baseUri;
     int m_timeout;
+    int m_cacheTtl;            // HTTP cache TTL in seconds, 30 days: chapters are rarely revised
     QString m_title;
     QString m_content;
     bool m_paragraphTagClosed;
@@ -453,6 +462,7 @@ public:
     QString language() const { return m_language; }
     bool needProxy() const { return m_needProxy; }
     bool disabled() const { return m_disabled; }
+    bool http2() const { return m_http2; }
 
     void setId(int id) { m_id = id; }
     void setUrl(const QString &url) { m_url = url; }
@@ -461,6 +471,7 @@ public:
     void setLanguage(const QString &language) { m_language = language; }
     void setNeedProxy(bool needProxy) { m_needProxy = needProxy; }
     void setDisabled(bool disabled) { m_disabled = disabled; }
+    void setHttp2(bool http2) { m_http2 = http2; }
 
     // Rule access
     SearchRule* searchRule() { return &m_searchRule; }
@@ -496,6 +507,7 @@ private:
     QString m_language;
     bool m_needProxy;
     bool m_disabled;
+    bool m_http2;       // Try HTTP/2 for this site, falling back to HTTP/1.1
 
     // Rules
     SearchRule m_searchRule;
@@ -4,9 +4,20 @@
 #include "../network/HttpClient.h"
 #include "../parser/ContentParser.h"
 #include "../parser/RuleManager.h"
+#include "../parser/HtmlStreamSink.h"
+#include "../parser/TocStreamSink.h"
 #include "ChapterDownloader.h"
 #include "FileGenerator.h"
 #include "../config/settings.h"
+#include "../network/HttpResponse.h"
+#include "../network/HttpCache.h"
+#include "../network/RateLimiter.h"
+#include "../network/NetworkDispatcher.h"
+#include "../network/DnsCache.h"
+#include "../network/LatencyTracker.h"
+#include "../network/NetworkMetrics.h"
+#include "../network/SharedCookieStore.h"
+#include "../parser/ContentFilter.h"
 #include <QApplication>
 #include <QStandardPaths>
 #include <QDir>
@@ -15,6 +26,20 @@
 #include <QFile>
 #include <QTextStream>
 #include <QDateTime>
+#include <QFutureWatcher>
+
+namespace {
+
+// TOC pages grow as chapters are published: cached for the rule's short TTL
+HttpClient::CachePolicy tocCachePolicy(const BookSource *bookSource)
+{
+    if (!bookSource || !bookSource->tocRule()) {
+        return HttpClient::CachePolicy();
+    }
+    return HttpClient::CachePolicy(bookSource->tocRule()->cacheTtl());
+}
+
+} // namespace
 
 NovelSearchManager::NovelSearchManager(Settings* settings, QObject *parent)
     : QObject(parent)
@@ -34,6 +59,14 @@ NovelSearchManager::NovelSearchManager(Settings* settings, QObject *parent)
     , m_searchTimeoutTimer(nullptr)
     , m_currentSearchIndex(0)
     , m_sequentialTimer(nullptr)
+    , m_searchGeneration(0)
+    , m_pendingStartChapter(1)
+    , m_pendingEndChapter(-1)
+    , m_pendingDownloadMode(0)
+    , m_downloadGeneration(0)
+    , m_tocPagesMerged(0)
+    , m_tocPagesInFlight(0)
+    , m_tocChapterCount(0)
 {
     qDebug() << "NovelSearchManager constructor started";
 
@@ -43,6 +76,24 @@ NovelSearchManager::NovelSearchManager(Settings* settings, QObject *parent)
 
     setupComponents();
     setupConnections();
+
+    // Anti-bot session cookies survive restarts, so the first search is not challenged again
+    const QString cookiePath = cookieStorePath();
+    if (QFile::exists(cookiePath)) {
+        QString cookieError;
+        if (!SharedCookieStore::instance()->load(cookiePath, &cookieError)) {
+            qDebug() << "Failed to load cookies:" << cookieError;
+        }
+    }
+
+    // Slogans removed from every source's chapters, on top of each rule's filterTxt
+    const QString adFilterPath = adFilterDictionaryPath();
+    if (QFile::exists(adFilterPath)) {
+        QString filterError;
+        if (!ContentFilter::loadSharedDictionary(adFilterPath, &filterError)) {
+            qDebug() << "Failed to load ad filters:" << filterError;
+        }
+    }
     // Note: Do not load book sources here to avoid duplicate loading
     // Book sources will be loaded when NovelConfig is set
 
@@ -70,9 +121,24 @@ NovelSearchManager::~NovelSearchManager()
         m_sequentialTimer->deleteLater();
     }
 
+    QString cookieError;
+    if (!SharedCookieStore::instance()->save(cookieStorePath(), &cookieError)) {
+        qDebug() << "Failed to save cookies:" << cookieError;
+    }
+
     qDebug() << "NovelSearchManager destroyed";
 }
 
+QString NovelSearchManager::cookieStorePath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/cookies.json";
+}
+
+QString NovelSearchManager::adFilterDictionaryPath()
+{
+    return QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation) + "/ad_filters.txt";
+}
+
 // Deprecated linkView methods removed - NovelSearchViewEnhanced is connected directly in MainWindow
 
 void NovelSearchManager::setNovelConfig(NovelConfig* config)
@@ -84,11 +150,13 @@ void NovelSearchManager::setNovelConfig(NovelConfig* config)
     if (m_novelConfig) {
         connect(m_novelConfig, &NovelConfig::configChanged, this, [this]() {
             qDebug() << "NovelConfig changed, reloading book sources...";
+            applyNetworkConfig();
             loadBookSources();
         });
 
         // Load book sources for the first time with current config
         qDebug() << "Loading book sources with NovelConfig for the first time...";
+        applyNetworkConfig();
         loadBookSources();
     }
 }
@@ -98,6 +166,26 @@ QList<BookSource> NovelSearchManager::getAvailableSources() const
     return m_availableSources;
 }
 
+void NovelSearchManager::applyNetworkConfig()
+{
+    if (!m_novelConfig) {
+        return;
+    }
+
+    HttpCache *cache = HttpCache::instance();
+    cache->setEnabled(m_novelConfig->getHttpCacheEnabled());
+    cache->setMaximumSize(qint64(m_novelConfig->getHttpCacheMaxSize()) * 1024 * 1024);
+    qDebug() << "HTTP cache:" << (cache->isEnabled() ? "enabled" : "disabled")
+             << "max size" << m_novelConfig->getHttpCacheMaxSize() << "MB";
+
+    // Hosts without a crawl rule are paced with the global crawl interval range
+    RateLimiter::HostPolicy pacing;
+    pacing.minIntervalMs = qMax(0, m_novelConfig->getCrawlMinInterval());
+    pacing.maxIntervalMs = qMax(pacing.minIntervalMs, m_novelConfig->getCrawlMaxInterval());
+    RateLimiter::instance()->setDefaultPolicy(pacing);
+    qDebug() << "Default crawl pacing:" << pacing.minIntervalMs << "-" << pacing.maxIntervalMs << "ms";
+}
+
 void NovelSearchManager::setupComponents()
 {
     qDebug() << "NovelSearchManager::setupComponents - Starting component initialization...";
@@ -139,6 +227,13 @@ void NovelSearchManager::setupConnections()
     
     // Simplified signal connections - using simulation mode
     qDebug() << "Using simulation mode for search and download";
+
+    // Queued: RuleManager emits these with its mutex held
+    if (m_ruleManager) {
+        connect(m_ruleManager, &RuleManager::sourceAdded, this, &NovelSearchManager::refreshHttp2Hosts, Qt::QueuedConnection);
+        connect(m_ruleManager, &RuleManager::sourceUpdated, this, &NovelSearchManager::refreshHttp2Hosts, Qt::QueuedConnection);
+        connect(m_ruleManager, &RuleManager::sourceRemoved, this, &NovelSearchManager::refreshHttp2Hosts, Qt::QueuedConnection);
+    }
     
     qDebug() << "Signal-slot connections setup completed";
 }
@@ -225,6 +320,25 @@ void NovelSearchManager::loadBookSources()
     // Get searchable sources
     m_availableSources = m_ruleManager->getSearchableSources();
 
+    // Register each source's crawl interval with the shared limiter so search and download agree
+    RateLimiter::instance()->clearHostPolicies();
+    for (const BookSource& source : m_availableSources) {
+        const CrawlRule* crawlRule = source.crawlRule();
+        const QString host = RateLimiter::hostKey(QUrl(source.url()));
+        if (host.isEmpty()) {
+            continue;
+        }
+        if (!crawlRule || crawlRule->minInterval() <= 0) {
+            continue;
+        }
+        RateLimiter::HostPolicy policy;
+        policy.minIntervalMs = crawlRule->minInterval();
+        policy.maxIntervalMs = qMax(crawlRule->minInterval(), crawlRule->maxInterval());
+        RateLimiter::instance()->setHostPolicy(host, policy);
+    }
+
+    refreshHttp2Hosts();
+
     qDebug() << "Found" << m_availableSources.size() << "searchable sources";
     for (const BookSource& source : m_availableSources) {
         qDebug() << "Available source:" << source.name() << "ID:" << source.id();
@@ -233,6 +347,21 @@ void NovelSearchManager::loadBookSources()
     qDebug() << "Book source loading completed successfully";
 }
 
+void NovelSearchManager::refreshHttp2Hosts()
+{
+    // Rebuilt from the current sources, so a removed or edited source stops negotiating HTTP/2
+    NetworkDispatcher *dispatcher = NetworkDispatcher::instance();
+    dispatcher->clearHttp2Hosts();
+    if (!m_ruleManager) {
+        return;
+    }
+    for (const BookSource &source : m_ruleManager->getSearchableSources()) {
+        if (source.http2()) {
+            dispatcher->setHttp2Allowed(RateLimiter::hostKey(QUrl(source.url())), true);
+        }
+    }
+}
+
 void NovelSearchManager::startSearch(const QString &keyword, int sourceId)
 {
     if (m_isSearching) {
@@ -257,6 +386,7 @@ void NovelSearchManager::startSearch(const QString &keyword, int sourceId)
         QMutexLocker locker(&m_searchMutex);
 
         m_isSearching = true;
+        ++m_searchGeneration;
         m_currentKeyword = keyword;
         m_searchResultsBySource.clear();
         m_completedSources.clear();
@@ -306,10 +436,10 @@ void NovelSearchManager::startSingleSourceSearch(const QString &keyword, int sou
         emit searchProgress("Searching " + source->name() + "...", 0, 1);
     }
 
-    // Set up timeout timer
+    // Set up timeout timer; sources with latency history get a deadline just past their tail
     QTimer* timer = new QTimer(this);
     timer->setSingleShot(true);
-    timer->setInterval(12000); // 12 seconds timeout
+    timer->setInterval(searchDeadline(*source, 15000));
     m_sourceTimeoutTimers[sourceId] = timer;
 
     connect(timer, &QTimer::timeout, this, [this, sourceId]() {
@@ -349,29 +479,15 @@ void NovelSearchManager::startSingleSourceSearch(const QString &keyword, int sou
         m_searcher->setContentParser(m_parser);
         m_searcher->setRuleManager(m_ruleManager);
 
-        // Perform synchronous search
-        QList<SearchResult> results = m_searcher->searchSingleSourceSync(keyword, sourceId);
-
-        if (!results.isEmpty()) {
-            qDebug() << "Search completed successfully, found" << results.size() << "results";
-            onSearchCompleted(results, sourceId);
-        } else {
-            QString error = m_searcher->getLastError();
-            if (error.isEmpty()) {
-                error = "No results found";
-            }
-            qDebug() << "Search failed:" << error;
-
-            // Check if we're in sequential search mode
-            qDebug() << "DEBUG: Before calling failed handler - m_isSearching:" << m_isSearching;
-            if (!m_searchQueue.isEmpty() && m_currentSearchIndex < m_searchQueue.size()) {
-                qDebug() << "DEBUG: Calling onSequentialSearchFailed";
-                onSequentialSearchFailed(error, sourceId);
-            } else {
-                qDebug() << "DEBUG: Calling onSearchFailed";
-                onSearchFailed(error, sourceId);
-            }
-        }
+        // Run the search on the searcher's worker thread; the GUI thread keeps
+        // processing events (including the timeout timer) until it finishes
+        const quint64 generation = m_searchGeneration;
+        auto *watcher = new QFutureWatcher<QList<SearchResult>>(this);
+        connect(watcher, &QFutureWatcher<QList<SearchResult>>::finished, this, [this, watcher, sourceId, generation]() {
+            watcher->deleteLater();
+            onSingleSourceSearchFinished(watcher->result(), sourceId, generation);
+        });
+        watcher->setFuture(m_searcher->searchSingleSource(keyword, sourceId));
     } else {
         qDebug() << "NovelSearcher not available, search failed";
 
@@ -384,6 +500,38 @@ void NovelSearchManager::startSingleSourceSearch(const QString &keyword, int sou
     }
 }
 
+void NovelSearchManager::onSingleSourceSearchFinished(const QList<SearchResult> &results, int sourceId, quint64 generation)
+{
+    // Search was cancelled, restarted or already timed out for this source
+    if (generation != m_searchGeneration || !m_isSearching) {
+        qDebug() << "Ignoring stale search result for source" << sourceId;
+        return;
+    }
+    if (!m_searchQueue.isEmpty() && m_currentSearchIndex < m_searchQueue.size()
+        && m_searchQueue[m_currentSearchIndex].id() != sourceId) {
+        qDebug() << "Ignoring late search result for source" << sourceId << "- sequential search has moved on";
+        return;
+    }
+
+    if (!results.isEmpty()) {
+        qDebug() << "Search completed successfully, found" << results.size() << "results";
+        onSearchCompleted(results, sourceId);
+    } else {
+        QString error = m_searcher->getLastError();
+        if (error.isEmpty()) {
+            error = "No results found";
+        }
+        qDebug() << "Search failed:" << error;
+
+        // Check if we're in sequential search mode
+        if (!m_searchQueue.isEmpty() && m_currentSearchIndex < m_searchQueue.size()) {
+            onSequentialSearchFailed(error, sourceId);
+        } else {
+            onSearchFailed(error, sourceId);
+        }
+    }
+}
+
 void NovelSearchManager::startMultiSourceSearch(const QString &keyword)
 {
     // Redirect to sequential search for better user experience
@@ -411,7 +559,7 @@ void NovelSearchManager::startConcurrentSearch(const QString &keyword)
         // Set up timeout timer for each source
         QTimer* timer = new QTimer(this);
         timer->setSingleShot(true);
-        timer->setInterval(12000); // 12 seconds timeout
+        timer->setInterval(searchDeadline(m_availableSources[i], 15000));
         m_sourceTimeoutTimers[m_availableSources[i].id()] = timer;
 
         int currentSourceId = m_availableSources[i].id();
@@ -527,20 +675,7 @@ void NovelSearchManager::searchNextSource()
                        .arg(m_searchQueue.size()),
                        m_currentSearchIndex + 1, m_searchQueue.size());
 
-    // Set up timeout timer for current source
-    QTimer* timer = new QTimer(this);
-    timer->setSingleShot(true);
-    timer->setInterval(15000); // 15 seconds timeout
-    m_sourceTimeoutTimers[currentSource.id()] = timer;
-
-    int currentSourceId = currentSource.id();
-    connect(timer, &QTimer::timeout, this, [this, currentSourceId]() {
-        onSearchTimeout(currentSourceId);
-    });
-
-    timer->start();
-
-    // Start single source search
+    // Start single source search (it arms the source's timeout timer)
     startSingleSourceSearch(m_currentKeyword, currentSource.id());
 }
 
@@ -552,6 +687,7 @@ void NovelSearchManager::onSequentialSearchCompleted(const QList<SearchResult> &
     // Add results to accumulated results
     if (!results.isEmpty()) {
         m_accumulatedResults.append(results);
+        warmUpResultHosts(results);
 
         // Emit real-time results update
         emit searchResultsUpdated(results, sourceId);
@@ -583,9 +719,11 @@ void NovelSearchManager::onSequentialSearchCompleted(const QList<SearchResult> &
     m_sequentialTimer = new QTimer(this);
     m_sequentialTimer->setSingleShot(true);
 
-    qDebug() << "onSequentialSearchCompleted: Scheduling next source search in 1 second";
+    // Sources live on different hosts; per-host politeness is enforced by RateLimiter,
+    // so the next source starts on the next event loop turn
+    qDebug() << "onSequentialSearchCompleted: Scheduling next source search";
     connect(m_sequentialTimer, &QTimer::timeout, this, &NovelSearchManager::searchNextSource);
-    m_sequentialTimer->start(1000); // 1 second delay
+    m_sequentialTimer->start(0);
 }
 
 void NovelSearchManager::cancelSearch()
@@ -654,7 +792,6 @@ void NovelSearchManager::startDownload(const SearchResult &result, int startChap
     qDebug() << "=== STEP 4: Getting chapter list ===";
 
     QString tocUrl = result.bookUrl();
-    QString tocHtml;
 
     // Check if toc has a separate URL
     if (bookSource->tocRule() && !bookSource->tocRule()->url().isEmpty()) {
@@ -674,23 +811,80 @@ void NovelSearchManager::startDownload(const SearchResult &result, int startChap
         }
     }
 
-    // Get chapter list page HTML
-    bool success = false;
-    QString error;
-    tocHtml = m_httpClient->getSync(tocUrl, QJsonObject(), &success, &error);
+    // Fetch the chapter list page asynchronously so the GUI thread keeps running;
+    // the pipeline continues in onChapterListPageFetched()
+    m_pendingStartChapter = startChapter;
+    m_pendingEndChapter = endChapter;
+    m_pendingDownloadMode = mode;
+    const quint64 generation = ++m_downloadGeneration;
+
+    // Single-page TOCs are parsed while they download; paginated ones page by page as they arrive
+    const TocRule *tocRule = bookSource->tocRule();
+    m_tocPageUrls.clear();
+    if (tocRule && !(tocRule->pagination() && !tocRule->nextPage().isEmpty())
+        && StreamingTocExtractor::isStreamable(tocRule->item())) {
+        // Simple item selectors are matched on the token stream: no document, and
+        // chapter downloads start while a huge list is still arriving
+        auto sink = std::make_shared<TocStreamSink>(*tocRule, tocUrl);
+        sink->setBatchCallback([this, tocUrl, generation](const QList<Chapter> &chapters) {
+            QMetaObject::invokeMethod(this, [this, chapters, tocUrl, generation]() {
+                onTocChaptersStreamed(chapters, tocUrl, generation);
+            }, Qt::QueuedConnection);
+        });
+        m_httpClient->getStreaming(tocUrl, QJsonObject(), sink, this, [this, sink, tocUrl, generation](const HttpResponse &response) {
+            onTocStreamFinished(response, sink, tocUrl, generation);
+        }, tocCachePolicy(bookSource));
+    } else if (tocRule && !(tocRule->pagination() && !tocRule->nextPage().isEmpty())) {
+        auto sink = std::make_shared<HtmlStreamSink>();
+        m_httpClient->getStreaming(tocUrl, QJsonObject(), sink, this, [this, sink, tocUrl, generation](const HttpResponse &response) {
+            onChapterListPageFetched(response, sink, tocUrl, generation);
+        }, tocCachePolicy(bookSource));
+    } else {
+        m_httpClient->getAsync(tocUrl, QJsonObject(), tocCachePolicy(bookSource), this, [this, tocUrl, generation](const HttpResponse &response) {
+            onChapterListPageFetched(response, nullptr, tocUrl, generation);
+        });
+    }
 
-    if (!success || tocHtml.isEmpty()) {
-        QString errorMsg = QString("Failed to get chapter list page: %1").arg(error);
+    qDebug() << "Chapter list request queued:" << tocUrl;
+}
+
+void NovelSearchManager::onChapterListPageFetched(const HttpResponse &response, const std::shared_ptr<HtmlStreamSink> &streamed,
+                                                  const QString &tocUrl, quint64 generation)
+{
+    // Download was cancelled or restarted while the page was in flight
+    if (generation != m_downloadGeneration || !m_isDownloading || !m_currentBookSource) {
+        qDebug() << "Ignoring stale chapter list response for" << tocUrl;
+        return;
+    }
+
+    const BookSource* bookSource = m_currentBookSource;
+
+    QMutexLocker locker(&m_downloadMutex);
+
+    const bool haveBody = streamed ? streamed->isComplete() && streamed->bytesReceived() > 0 : !response.body.isEmpty();
+    if (!response.success || !haveBody) {
+        QString reason = response.error;
+        if (response.success && streamed) {
+            reason = streamed->errorString();
+        }
+        QString errorMsg = QString("Failed to get chapter list page: %1").arg(reason);
         qDebug() << errorMsg;
         resetDownloadState();
         emit downloadFailed(errorMsg);
         return;
     }
 
-    qDebug() << "Chapter list page downloaded, HTML length:" << tocHtml.length();
-
     // Parse chapter list using ContentParser and book source rules
-    QList<Chapter> allChapters = m_parser->parseChapterList(tocHtml, *bookSource, tocUrl);
+    QList<Chapter> allChapters;
+    QStringList tocPageUrls;
+    if (streamed) {
+        qDebug() << "Chapter list page streamed, size:" << streamed->bytesReceived() << "charset:" << streamed->charset();
+        allChapters = m_parser->parseChapterList(streamed->parser(), *bookSource->tocRule(), tocUrl);
+    } else {
+        const QByteArray tocCharset = response.charset();
+        qDebug() << "Chapter list page downloaded, size:" << response.body.size() << "charset:" << tocCharset;
+        allChapters = m_parser->parseTocPage(response.body, tocCharset, *bookSource->tocRule(), tocUrl, &tocPageUrls);
+    }
 
     if (allChapters.isEmpty()) {
         QString errorMsg = "No chapters found in book";
@@ -700,55 +894,315 @@ void NovelSearchManager::startDownload(const SearchResult &result, int startChap
         return;
     }
 
-    qDebug() << "Found" << allChapters.size() << "chapters total";
+    qDebug() << "Found" << allChapters.size() << "chapters on the first chapter list page,"
+             << tocPageUrls.size() << "more pages linked";
 
-    // === STEP 5: Filter Chapters Based on Download Mode ===
-    QList<Chapter> chaptersToDownload;
+    beginTocWalk(tocUrl);
 
-    switch (mode) {
-    case 0: // ChapterRange
-        if (endChapter == -1) {
-            // Download from startChapter to end
-            for (int i = startChapter - 1; i < allChapters.size(); ++i) {
-                chaptersToDownload.append(allChapters[i]);
-            }
-        } else {
-            // Download specific range
-            for (int i = startChapter - 1; i < qMin(endChapter, allChapters.size()); ++i) {
-                chaptersToDownload.append(allChapters[i]);
-            }
+    // === STEP 6: Queue Chapters Page by Page ===
+    // Pages linked up front are fetched concurrently; chapter downloads start
+    // from the first page while the rest of the list is still arriving
+    m_tocPageChapters.insert(0, allChapters);
+    const QList<Chapter> selected = mergeTocPages();
+    fetchTocPages(tocPageUrls, generation);
+    const bool walkDone = m_tocPagesInFlight == 0;
+
+    // Queued outside the lock: a downloader that starts at once may report back into it
+    locker.unlock();
+    queueChapterDownloads(selected);
+    if (walkDone && generation == m_downloadGeneration && m_isDownloading) {
+        finishTocWalk();
+    }
+}
+
+void NovelSearchManager::onTocChaptersStreamed(const QList<Chapter> &chapters, const QString &tocUrl, quint64 generation)
+{
+    if (generation != m_downloadGeneration || !m_isDownloading || !m_currentBookSource) {
+        return;
+    }
+
+    QMutexLocker locker(&m_downloadMutex);
+
+    // Downloads start with the first batch, while the rest of the page is still arriving
+    if (m_tocPageUrls.isEmpty()) {
+        qDebug() << "First chapters streamed from" << tocUrl;
+        beginTocWalk(tocUrl);
+    }
+
+    // A retried stream starts over and hands out the chapters already queued again;
+    // its numbering restarts with it, so position tells repeats apart, not the URL
+    QList<Chapter> fresh;
+    for (const Chapter &chapter : chapters) {
+        if (chapter.order() > m_tocChapterCount) {
+            fresh.append(chapter);
         }
-        break;
+    }
+    const QList<Chapter> selected = selectTocChapters(fresh);
 
-    case 1: // FullNovel
-        chaptersToDownload = allChapters;
-        break;
+    locker.unlock();
+    queueChapterDownloads(selected);
+}
 
-    case 2: // CustomPath (download all to custom path)
-        chaptersToDownload = allChapters;
-        break;
+void NovelSearchManager::onTocStreamFinished(const HttpResponse &response, const std::shared_ptr<TocStreamSink> &sink,
+                                             const QString &tocUrl, quint64 generation)
+{
+    if (generation != m_downloadGeneration || !m_isDownloading || !m_currentBookSource) {
+        qDebug() << "Ignoring stale chapter list response for" << tocUrl;
+        return;
+    }
 
-    default:
-        chaptersToDownload = allChapters.mid(0, 10); // Default: first 10 chapters
-        break;
+    QMutexLocker locker(&m_downloadMutex);
+
+    if (!response.success || !sink->isComplete()) {
+        QString errorMsg = QString("Failed to get chapter list page: %1").arg(response.success ? sink->errorString() : response.error);
+        qDebug() << errorMsg;
+        failTocWalk(locker, errorMsg);
+        return;
     }
 
-    if (chaptersToDownload.isEmpty()) {
+    qDebug() << "Chapter list page streamed, size:" << sink->bytesReceived() << "charset:" << sink->charset()
+             << "chapters:" << sink->chapterCount();
+
+    if (sink->linkCount() == 0) {
+        // The token stream matched nothing the tree builder might have; parse the page as a document
+        qDebug() << "Item selector matched nothing on the stream, parsing chapter list page as a document";
+        m_httpClient->getAsync(tocUrl, QJsonObject(), tocCachePolicy(m_currentBookSource), this,
+                               [this, tocUrl, generation](const HttpResponse &response) {
+            onChapterListPageFetched(response, nullptr, tocUrl, generation);
+        });
+        return;
+    }
+
+    if (m_tocPageUrls.isEmpty()) {
+        // Links were found, but none of them is a chapter
+        QString errorMsg = "No chapters found in book";
+        qDebug() << errorMsg;
+        resetDownloadState();
+        emit downloadFailed(errorMsg);
+        return;
+    }
+
+    m_tocPagesMerged = 1;
+    locker.unlock();
+    finishTocWalk();
+}
+
+void NovelSearchManager::onTocPageFetched(const HttpResponse &response, const QString &pageUrl, int pageIndex, quint64 generation)
+{
+    if (generation != m_downloadGeneration || !m_isDownloading || !m_currentBookSource) {
+        qDebug() << "Ignoring stale chapter list response for" << pageUrl;
+        return;
+    }
+
+    QMutexLocker locker(&m_downloadMutex);
+    m_tocPagesInFlight--;
+
+    QList<Chapter> chapters;
+    QStringList pageUrls;
+    if (response.success && !response.body.isEmpty()) {
+        chapters = m_parser->parseTocPage(response.body, response.charset(), *m_currentBookSource->tocRule(), pageUrl, &pageUrls);
+        qDebug() << "Chapter list page" << pageIndex + 1 << "parsed:" << chapters.size() << "chapters";
+    } else if (!isChapterSelectionComplete()) {
+        // The dispatcher has already retried it; numbering past a missing page would be wrong
+        QString errorMsg = QString("Failed to get chapter list page %1: %2").arg(pageIndex + 1).arg(response.error);
+        qDebug() << errorMsg;
+        failTocWalk(locker, errorMsg);
+        return;
+    } else {
+        qDebug() << "Ignoring failed chapter list page" << pageIndex + 1 << "past the selection:" << response.error;
+    }
+    m_tocPageChapters.insert(pageIndex, chapters);
+
+    const QList<Chapter> selected = mergeTocPages();
+    fetchTocPages(pageUrls, generation);
+    const bool walkDone = m_tocPagesInFlight == 0;
+
+    locker.unlock();
+    queueChapterDownloads(selected);
+    if (walkDone && generation == m_downloadGeneration && m_isDownloading) {
+        finishTocWalk();
+    }
+}
+
+void NovelSearchManager::fetchTocPages(const QStringList &pageUrls, quint64 generation)
+{
+    for (const QString &pageUrl : pageUrls) {
+        if (isChapterSelectionComplete()) {
+            return;
+        }
+        if (m_tocPageUrls.contains(pageUrl)) {
+            continue;
+        }
+        if (m_tocPageUrls.size() >= MAX_TOC_PAGES) {
+            qDebug() << "Reached maximum chapter list page limit" << MAX_TOC_PAGES;
+            return;
+        }
+
+        // Page order is discovery order: select boxes and numbered links list pages ascending
+        const int pageIndex = m_tocPageUrls.size();
+        m_tocPageUrls.append(pageUrl);
+        m_tocPagesInFlight++;
+
+        // Requests to one host are spaced by the dispatcher's RateLimiter
+        m_httpClient->getAsync(pageUrl, QJsonObject(), tocCachePolicy(m_currentBookSource), this,
+                               [this, pageUrl, pageIndex, generation](const HttpResponse &response) {
+            onTocPageFetched(response, pageUrl, pageIndex, generation);
+        });
+    }
+}
+
+void NovelSearchManager::beginTocWalk(const QString &tocUrl)
+{
+    // === STEP 5: Setup ChapterDownloader ===
+    qDebug() << "=== STEP 5: Setting up real chapter downloader ===";
+    setupChapterDownloader();
+
+    m_totalChapters = 0;
+    m_tocPageUrls = QStringList{tocUrl};
+    m_tocPageChapters.clear();
+    m_tocPagesMerged = 0;
+    m_tocPagesInFlight = 0;
+    m_tocChapterCount = 0;
+    m_tocLastPageUrls.clear();
+
+    // Chapters keep arriving after the first tasks start; finishTocWalk() closes the run
+    m_downloader->setMoreTasksExpected(true);
+}
+
+QList<Chapter> NovelSearchManager::mergeTocPages()
+{
+    // Only a contiguous run of pages from the front can be numbered
+    QList<Chapter> selected;
+    while (m_tocPageChapters.contains(m_tocPagesMerged)) {
+        QList<Chapter> pageChapters = m_tocPageChapters.take(m_tocPagesMerged);
+        m_tocPagesMerged++;
+
+        // Neighbouring pages often repeat the chapters at their boundary: drop the
+        // leading run already on the previous page, but nothing further in, where a
+        // repeat is the page's own (e.g. a "latest chapters" block)
+        int repeated = 0;
+        while (repeated < pageChapters.size() && m_tocLastPageUrls.contains(pageChapters.at(repeated).url())) {
+            repeated++;
+        }
+        pageChapters.erase(pageChapters.begin(), pageChapters.begin() + repeated);
+
+        m_tocLastPageUrls.clear();
+        for (const Chapter &chapter : pageChapters) {
+            m_tocLastPageUrls.insert(chapter.url());
+        }
+        selected += selectTocChapters(pageChapters);
+    }
+    return selected;
+}
+
+QList<Chapter> NovelSearchManager::selectTocChapters(const QList<Chapter> &chapters)
+{
+    QList<Chapter> selected;
+    for (Chapter chapter : chapters) {
+        const int index = m_tocChapterCount++;
+        chapter.setOrder(index + 1);
+        if (isChapterSelected(index)) {
+            selected.append(chapter);
+        }
+    }
+    return selected;
+}
+
+void NovelSearchManager::finishTocWalk()
+{
+    qDebug() << "Chapter list complete:" << m_tocChapterCount << "chapters on" << m_tocPagesMerged << "pages";
+
+    if (m_totalChapters == 0) {
         QString errorMsg = "No chapters to download in specified range";
         qDebug() << errorMsg;
+        QMutexLocker locker(&m_downloadMutex);
         resetDownloadState();
         emit downloadFailed(errorMsg);
         return;
     }
 
-    m_totalChapters = chaptersToDownload.size();
     qDebug() << "Will download" << m_totalChapters << "chapters";
 
-    emit downloadProgress("Starting chapter downloads...", 0, m_totalChapters);
+    // May finish the run at once if every chapter is already done; that locks m_downloadMutex
+    m_downloader->setMoreTasksExpected(false);
+}
 
-    // === STEP 6: Setup ChapterDownloader and Start Real Download ===
-    qDebug() << "=== STEP 6: Setting up real chapter downloader ===";
+void NovelSearchManager::failTocWalk(QMutexLocker &locker, const QString &errorMsg)
+{
+    const bool started = m_downloader && m_downloader->isDownloading();
+    resetDownloadState();
+    locker.unlock();
+    if (started) {
+        // Chapters from the partial list are already downloading; the finish is ignored once reset
+        m_downloader->stopDownload();
+    }
+    emit downloadFailed(errorMsg);
+}
+
+bool NovelSearchManager::isChapterSelected(int index) const
+{
+    switch (m_pendingDownloadMode) {
+    case 0: // ChapterRange
+        return index >= m_pendingStartChapter - 1 && (m_pendingEndChapter == -1 || index < m_pendingEndChapter);
+
+    case 1: // FullNovel
+    case 2: // CustomPath (download all to custom path)
+        return true;
+
+    default:
+        return index < 10; // Default: first 10 chapters
+    }
+}
+
+bool NovelSearchManager::isChapterSelectionComplete() const
+{
+    // Later pages cannot add to a selection that ends before them
+    int end = -1;
+    if (m_pendingDownloadMode == 0) {
+        end = m_pendingEndChapter;
+    } else if (m_pendingDownloadMode != 1 && m_pendingDownloadMode != 2) {
+        end = 10;
+    }
+    return end != -1 && m_tocChapterCount >= end;
+}
+
+void NovelSearchManager::queueChapterDownloads(const QList<Chapter> &chapters)
+{
+    if (chapters.isEmpty()) {
+        return;
+    }
+
+    // Called without m_downloadMutex held: adding tasks may start them, and their
+    // signals lock it. The totals are counted first, so no chapter finishes past them
+    QMutexLocker locker(&m_downloadMutex);
+    if (m_totalChapters == 0) {
+        // Chapters are sometimes served from another host than the TOC; connect while the first tasks are queued
+        const QUrl firstChapterUrl(chapters.first().url());
+        if (firstChapterUrl.host().compare(QUrl(m_tocPageUrls.first()).host(), Qt::CaseInsensitive) != 0) {
+            m_httpClient->prefetch(firstChapterUrl.toString());
+        }
+    }
+    m_totalChapters += chapters.size();
+    const int downloaded = m_downloadedChapters;
+    const int total = m_totalChapters;
+    locker.unlock();
+
+    for (const Chapter& chapter : chapters) {
+        QString taskId = m_downloader->addDownloadTask(chapter, *m_currentBookSource);
+        qDebug() << "Added download task:" << taskId << "-" << chapter.title();
+    }
+
+    emit downloadProgress("Starting chapter downloads...", downloaded, total);
 
+    // Tasks added to a running downloader start on their own
+    if (!m_downloader->isDownloading()) {
+        m_downloader->startDownload();
+        qDebug() << "=== REAL DOWNLOAD STARTED ===";
+    }
+}
+
+void NovelSearchManager::setupChapterDownloader()
+{
     // Configure ChapterDownloader
     m_downloader->setHttpClient(m_httpClient);
     m_downloader->setContentParser(m_parser);
@@ -794,17 +1248,6 @@ void NovelSearchManager::startDownload(const SearchResult &result, int startChap
     connect(m_downloader, &ChapterDownloader::taskCompleted, this, &NovelSearchManager::onRealChapterDownloaded, Qt::DirectConnection);
     connect(m_downloader, &ChapterDownloader::downloadFinished, this, &NovelSearchManager::onAllChaptersDownloaded, Qt::DirectConnection);
     connect(m_downloader, &ChapterDownloader::downloadError, this, &NovelSearchManager::onDownloadError, Qt::DirectConnection);
-
-    // Add all chapters as download tasks
-    for (const Chapter& chapter : chaptersToDownload) {
-        QString taskId = m_downloader->addDownloadTask(chapter, *bookSource);
-        qDebug() << "Added download task:" << taskId << "-" << chapter.title();
-    }
-
-    // Start the real download process
-    m_downloader->startDownload();
-
-    qDebug() << "=== REAL DOWNLOAD STARTED ===";
 }
 
 void NovelSearchManager::cancelDownload()
@@ -852,6 +1295,24 @@ void NovelSearchManager::onAllChaptersDownloaded(const DownloadStats &stats)
     qDebug() << "=== NovelSearchManager::onAllChaptersDownloaded CALLED ===";
     qDebug() << "Stats - Completed:" << stats.completedTasks << "Total:" << stats.totalTasks;
 
+    NetworkDispatcher *dispatcher = NetworkDispatcher::instance();
+    qDebug() << "Network totals - wire:" << dispatcher->totalTransferBytes() / 1024 << "KB"
+             << "decoded:" << dispatcher->totalDecodedBytes() / 1024 << "KB";
+    const QHash<QString, NetworkDispatcher::ProtocolStats> protocolStats = dispatcher->allProtocolStats();
+    for (auto it = protocolStats.constBegin(); it != protocolStats.constEnd(); ++it) {
+        qDebug() << "Connections to" << it.key() << "- h2:" << it->http2Responses
+                 << "h1:" << it->http1Responses << "fallbacks:" << it->http2Fallbacks
+                 << "TLS handshakes:" << it->tlsHandshakes;
+    }
+
+    // Per-host phase histograms for diagnosing slow sources (DNS, connect, TTFB or transfer bound)
+    const QString metricsPath = QStandardPaths::writableLocation(QStandardPaths::AppLocalDataLocation)
+        + "/network_metrics.json";
+    QString metricsError;
+    if (!NetworkMetrics::instance()->dumpToFile(metricsPath, &metricsError)) {
+        qDebug() << "Failed to write network metrics:" << metricsError;
+    }
+
     QMutexLocker locker(&m_downloadMutex);
 
     if (!m_isDownloading) {
@@ -991,10 +1452,50 @@ void NovelSearchManager::onSearchCompleted(const QList<SearchResult> &results, i
         }
 
         resetSearchState();
+        warmUpResultHosts(allResults);
         emit searchCompleted(allResults);
     }
 }
 
+int NovelSearchManager::searchDeadline(const BookSource &source, int fallbackMs) const
+{
+    const QString searchUrl = source.searchRule() ? source.searchRule()->url() : QString();
+    QString host = QUrl(searchUrl).host();
+    if (host.isEmpty()) {
+        host = QUrl(source.url()).host();
+    }
+    return LatencyTracker::instance()->deadline(host, fallbackMs);
+}
+
+void NovelSearchManager::warmUpResultHosts(const QList<SearchResult> &results)
+{
+    // Opening a result is the likely next step: connect to the first few book hosts now,
+    // and only resolve the rest
+    const int warmCount = 3;
+    QSet<QString> seenHosts;
+    for (const SearchResult &result : results) {
+        const QUrl bookUrl(result.bookUrl());
+        const QString host = bookUrl.host().toLower();
+        if (host.isEmpty() || seenHosts.contains(host)) {
+            continue;
+        }
+        seenHosts.insert(host);
+
+        if (seenHosts.size() <= warmCount) {
+            m_httpClient->prefetch(bookUrl.toString());
+        } else {
+            DnsCache::instance()->resolve(host, this, nullptr);
+        }
+    }
+}
+
+void NovelSearchManager::prefetchResult(const SearchResult &result)
+{
+    if (!result.bookUrl().isEmpty()) {
+        m_httpClient->prefetch(result.bookUrl());
+    }
+}
+
 void NovelSearchManager::onSequentialSearchFailed(const QString &error, int sourceId)
 {
     qDebug() << "Sequential search failed for source" << sourceId << "error:" << error;
@@ -1330,6 +1831,12 @@ void NovelSearchManager::resetDownloadState()
     m_downloadedChapters = 0;
     m_downloadedContent.clear();
     m_specialSourceRetryCount = 0;
+    m_tocPageUrls.clear();
+    m_tocPageChapters.clear();
+    m_tocPagesMerged = 0;
+    m_tocPagesInFlight = 0;
+    m_tocChapterCount = 0;
+    m_tocLastPageUrls.clear();
 }
 
 bool NovelSearchManager::isSpecialBookSourceError(int sourceId, const QString &error)
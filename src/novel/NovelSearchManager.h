@@ -8,16 +8,20 @@
 #include <QMutex>
 #include <QMetaType>
 #include <QSet>
+#include <memory>
 #include "NovelModels.h"
 #include "ChapterDownloader.h"
 
 // Forward declarations
+struct HttpResponse;
 class NovelSearcher;
 class ChapterDownloader;
 class FileGenerator;
 class RuleManager;
 class HttpClient;
 class ContentParser;
+class HtmlStreamSink;
+class TocStreamSink;
 class Settings;
 
 /**
@@ -50,6 +54,9 @@ public:
     void startDownload(const SearchResult &result, int startChapter, int endChapter, int mode, const QString &customPath);
     void cancelDownload();
 
+    // Warm the connection for a result the user is looking at, ahead of startDownload
+    void prefetchResult(const SearchResult &result);
+
     // Status query
     bool isSearching() const { return m_isSearching; }
     bool isDownloading() const { return m_isDownloading; }
@@ -88,13 +95,37 @@ private slots:
 private:
     void setupComponents();
     void setupConnections();
+    void applyNetworkConfig();
+    void warmUpResultHosts(const QList<SearchResult> &results);
+    int searchDeadline(const BookSource &source, int fallbackMs) const;
+    static QString cookieStorePath();
+    static QString adFilterDictionaryPath();
     void loadBookSources();
+    void refreshHttp2Hosts();
     void startSingleSourceSearch(const QString &keyword, int sourceId);
     void startMultiSourceSearch(const QString &keyword);
     void startConcurrentSearch(const QString &keyword);  // Backup concurrent search method
     void startSequentialSearch(const QString &keyword);
     void searchNextSource();
     void onSequentialSearchCompleted(const QList<SearchResult> &results, int sourceId);
+    void onSingleSourceSearchFinished(const QList<SearchResult> &results, int sourceId, quint64 generation);
+    void onChapterListPageFetched(const HttpResponse &response, const std::shared_ptr<HtmlStreamSink> &streamed,
+                                  const QString &tocUrl, quint64 generation);
+    void onTocChaptersStreamed(const QList<Chapter> &chapters, const QString &tocUrl, quint64 generation);
+    void onTocStreamFinished(const HttpResponse &response, const std::shared_ptr<TocStreamSink> &sink,
+                             const QString &tocUrl, quint64 generation);
+    void onTocPageFetched(const HttpResponse &response, const QString &pageUrl, int pageIndex, quint64 generation);
+    void fetchTocPages(const QStringList &pageUrls, quint64 generation);
+    void beginTocWalk(const QString &tocUrl);
+    // Number chapters under m_downloadMutex; the caller queues the selected ones after unlocking
+    QList<Chapter> mergeTocPages();
+    QList<Chapter> selectTocChapters(const QList<Chapter> &chapters);
+    void finishTocWalk();
+    void failTocWalk(QMutexLocker &locker, const QString &errorMsg);
+    bool isChapterSelected(int index) const;
+    bool isChapterSelectionComplete() const;
+    void queueChapterDownloads(const QList<Chapter> &chapters);
+    void setupChapterDownloader();
     void generateFile();
     void resetSearchState();
     void resetDownloadState();
@@ -130,6 +161,7 @@ private:
     int m_currentSearchIndex;
     QList<SearchResult> m_accumulatedResults;
     QTimer* m_sequentialTimer;
+    quint64 m_searchGeneration;
     
     // Download state
     bool m_isDownloading;
@@ -139,6 +171,21 @@ private:
     int m_downloadedChapters;
     QHash<QString, QString> m_downloadedContent;
     int m_specialSourceRetryCount;
+
+    // Pending chapter list request (startDownload continues asynchronously)
+    int m_pendingStartChapter;
+    int m_pendingEndChapter;
+    int m_pendingDownloadMode;
+    quint64 m_downloadGeneration;
+
+    // Chapter list pages, fetched concurrently and merged in page order
+    static const int MAX_TOC_PAGES = 50;        // Safety limit against endless pagination
+    QStringList m_tocPageUrls;                  // Every page found so far; the index is the page order
+    QHash<int, QList<Chapter>> m_tocPageChapters;   // Fetched pages waiting for an earlier one
+    int m_tocPagesMerged;                       // Pages [0, m_tocPagesMerged) are numbered and queued
+    int m_tocPagesInFlight;
+    int m_tocChapterCount;                      // Chapters numbered so far, selected or not
+    QSet<QString> m_tocLastPageUrls;            // Chapters of the page merged last, to drop its repeats
     
     // Thread safety
     QMutex m_searchMutex;
@@ -37,31 +37,24 @@ void SearchTask::run()
             }
             searchData.replace("%s", m_keyword);
         }
-        QNetworkReply *reply = nullptr;
+        QFuture<HttpResponse> future;
         if (rule->method().toLower() == "post") {
             headers["Content-Type"] = "application/x-www-form-urlencoded";
-            reply = m_httpClient->post(searchUrl, searchData.toUtf8(), headers);
+            future = m_httpClient->postAsync(searchUrl, searchData.toUtf8(), headers);
         } else {
             if (searchUrl.contains("%s")) {
                 searchUrl.replace("%s", m_keyword);
             }
-            reply = m_httpClient->get(searchUrl, headers);
-        }
-        if (!reply) {
-            emit searchFailed("Network request failed", m_source.id());
-            return;
+            // One slow connection should not decide the whole aggregated search
+            future = m_httpClient->getHedged(searchUrl, headers);
         }
-        QEventLoop loop;
-        connect(reply, &QNetworkReply::finished, &loop, &QEventLoop::quit);
-        loop.exec();
-        if (reply->error() != QNetworkReply::NoError) {
-            emit searchFailed(reply->errorString(), m_source.id());
-            reply->deleteLater();
+        // Pool thread waits on the future; the reply is driven by the shared network thread
+        HttpResponse response = future.result();
+        if (!response.success) {
+            emit searchFailed(response.error, m_source.id());
             return;
         }
-        QString html = QString::fromUtf8(reply->readAll());
-        reply->deleteLater();
-        QList<SearchResult> results = m_parser->parseSearchResults(html, m_source, searchUrl);
+        QList<SearchResult> results = m_parser->parseSearchResults(response.body, response.charset(), m_source, searchUrl);
         emit searchCompleted(results, m_source.id());
     } catch (const std::exception &e) {
         emit searchFailed(QString("Search exception: %1").arg(e.what()), m_source.id());
@@ -251,8 +244,13 @@ QList<SearchResult> NovelSearcher::performSingleSearch(const QString &keyword, c
                 if (value.startsWith("'") && value.endsWith("'")) {
                     value = value.mid(1, value.length() - 2);
                 }
-                threadLocalHttpClient.setCookie(name, value, QUrl(source.url()).host());
-                qDebug() << "NovelSearcher: Set cookie" << name << "=" << value;
+                // Never overwrite a token the site itself issued (the store is shared and persisted)
+                if (!SharedCookieStore::instance()->value(QUrl(source.url()), name.toUtf8()).isEmpty()) {
+                    continue;
+                }
+                if (threadLocalHttpClient.setCookie(name, value, QUrl(source.url()).host())) {
+                    qDebug() << "NovelSearcher: Set cookie" << name << "=" << value;
+                }
             }
         }
     }
@@ -295,6 +293,7 @@ QList<SearchResult> NovelSearcher::performSingleSearch(const QString &keyword, c
         bool requestSuccess = false;
         QString requestError;
 
+        QFuture<HttpResponse> searchFuture;
         if (rule->method().toLower() == "post") {
             // 使用curl兼容的headers，因为curl测试成功了
             headers["Content-Type"] = "application/x-www-form-urlencoded";
@@ -302,12 +301,19 @@ QList<SearchResult> NovelSearcher::performSingleSearch(const QString &keyword, c
             headers["Accept"] = "*/*";
             headers["Connection"] = "keep-alive";
             qDebug() << "NovelSearcher: POST request to" << searchUrl << "with data:" << searchData;
-            html = threadLocalHttpClient.postSync(searchUrl, searchData.toUtf8(), headers, &requestSuccess, &requestError);
+            searchFuture = threadLocalHttpClient.postAsync(searchUrl, searchData.toUtf8(), headers);
         } else {
             if (searchUrl.contains("%s")) {
                 searchUrl.replace("%s", keyword);
             }
-            html = threadLocalHttpClient.getSync(searchUrl, headers, &requestSuccess, &requestError);
+            searchFuture = threadLocalHttpClient.getHedged(searchUrl, headers);
+        }
+
+        const HttpResponse searchResponse = searchFuture.result();
+        requestSuccess = searchResponse.success;
+        requestError = searchResponse.error;
+        if (requestSuccess) {
+            html = searchResponse.text();
         }
 
         qDebug() << "NovelSearcher: Request result - Success:" << requestSuccess << "Error:" << requestError << "HTML length:" << html.length();
@@ -0,0 +1,132 @@
+#include "AhoCorasick.h"
+#include <QQueue>
+#include <QPair>
+
+AhoCorasick::AhoCorasick()
+    : m_nodes(1)
+    , m_patternCount(0)
+{
+}
+
+AhoCorasick::AhoCorasick(const QStringList &patterns)
+    : m_nodes(1)
+    , m_patternCount(0)
+{
+    // Trie; children are kept separately only for the breadth-first pass
+    QVector<QVector<QPair<ushort, int>>> children(1);
+    for (const QString &pattern : patterns) {
+        if (pattern.isEmpty()) {
+            continue;
+        }
+        int state = 0;
+        for (const QChar ch : pattern) {
+            const quint64 key = edgeKey(state, ch.unicode());
+            auto it = m_edges.constFind(key);
+            if (it == m_edges.constEnd()) {
+                const int next = m_nodes.size();
+                m_nodes.append(Node());
+                children.append(QVector<QPair<ushort, int>>());
+                children[state].append(qMakePair(ch.unicode(), next));
+                m_edges.insert(key, next);
+                state = next;
+            } else {
+                state = it.value();
+            }
+        }
+        m_nodes[state].longest = qMax(m_nodes[state].longest, pattern.size());
+        m_patternCount++;
+    }
+
+    // Failure links in breadth-first order, so a node's fail target is final before it is read
+    QQueue<int> queue;
+    for (const auto &child : children[0]) {
+        queue.enqueue(child.second);
+    }
+    while (!queue.isEmpty()) {
+        const int state = queue.dequeue();
+        for (const auto &child : children[state]) {
+            const int next = child.second;
+            m_nodes[next].fail = state == 0 ? 0 : step(m_nodes[state].fail, child.first);
+            m_nodes[next].longest = qMax(m_nodes[next].longest, m_nodes[m_nodes[next].fail].longest);
+            queue.enqueue(next);
+        }
+    }
+}
+
+int AhoCorasick::step(int state, ushort ch) const
+{
+    for (;;) {
+        auto it = m_edges.constFind(edgeKey(state, ch));
+        if (it != m_edges.constEnd()) {
+            return it.value();
+        }
+        if (state == 0) {
+            return 0;
+        }
+        state = m_nodes[state].fail;
+    }
+}
+
+bool AhoCorasick::containsAny(const QString &text) const
+{
+    if (isEmpty()) {
+        return false;
+    }
+    int state = 0;
+    for (const QChar ch : text) {
+        state = step(state, ch.unicode());
+        if (m_nodes[state].longest > 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+QString AhoCorasick::removeAll(const QString &text, int *removedCount) const
+{
+    if (removedCount) {
+        *removedCount = 0;
+    }
+    if (isEmpty() || text.isEmpty()) {
+        return text;
+    }
+
+    // Every match ending at i lies inside the longest one ending there, so the
+    // union of those longest matches is the union of all matches. Ends only
+    // grow, which lets the ranges be merged as they are found.
+    QVector<QPair<int, int>> ranges;     // [start, end) in text
+    int state = 0;
+    for (int i = 0; i < text.size(); ++i) {
+        state = step(state, text.at(i).unicode());
+        const int length = m_nodes[state].longest;
+        if (length == 0) {
+            continue;
+        }
+        const int start = i + 1 - length;
+        while (!ranges.isEmpty() && ranges.last().first >= start) {
+            ranges.removeLast();
+        }
+        if (!ranges.isEmpty() && ranges.last().second >= start) {
+            ranges.last().second = i + 1;
+        } else {
+            ranges.append(qMakePair(start, i + 1));
+        }
+    }
+
+    if (ranges.isEmpty()) {
+        return text;
+    }
+    if (removedCount) {
+        *removedCount = ranges.size();
+    }
+
+    QString result;
+    result.reserve(text.size());
+    int copied = 0;
+    for (const auto &range : ranges) {
+        result.append(text.midRef(copied, range.first - copied));
+        copied = range.second;
+    }
+    result.append(text.midRef(copied));
+    return result;
+}
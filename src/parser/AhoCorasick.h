@@ -0,0 +1,57 @@
+#ifndef AHOCORASICK_H
+#define AHOCORASICK_H
+
+#include <QString>
+#include <QStringList>
+#include <QHash>
+#include <QVector>
+
+/**
+ * @brief Aho-Corasick automaton over UTF-16 code units for literal patterns
+ *
+ * Built once, then read-only and safe to share between threads. A scan is
+ * one pass over the text whatever the number of patterns; matching is
+ * case-sensitive and exact.
+ */
+class AhoCorasick
+{
+public:
+    AhoCorasick();
+
+    /**
+     * @brief Build the automaton; empty patterns are ignored
+     */
+    explicit AhoCorasick(const QStringList &patterns);
+
+    bool isEmpty() const { return m_patternCount == 0; }
+    int patternCount() const { return m_patternCount; }
+
+    /**
+     * @brief Whether any pattern occurs in the text
+     */
+    bool containsAny(const QString &text) const;
+
+    /**
+     * @brief Text with every occurrence of every pattern removed
+     *
+     * Overlapping occurrences are removed as their union, so removal does
+     * not depend on pattern order.
+     * @param removedCount Set to the number of removed ranges if given
+     */
+    QString removeAll(const QString &text, int *removedCount = nullptr) const;
+
+private:
+    struct Node {
+        int fail = 0;
+        int longest = 0;        // Longest pattern ending here, through the fail chain
+    };
+
+    int step(int state, ushort ch) const;
+    static quint64 edgeKey(int state, ushort ch) { return (quint64(quint32(state)) << 16) | ch; }
+
+    QVector<Node> m_nodes;
+    QHash<quint64, int> m_edges;    // (state, code unit) -> state, trie edges only
+    int m_patternCount;
+};
+
+#endif // AHOCORASICK_H
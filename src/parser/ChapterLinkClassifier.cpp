@@ -0,0 +1,84 @@
+#include "ChapterLinkClassifier.h"
+#include <QStringList>
+
+const ChapterLinkClassifier &ChapterLinkClassifier::instance()
+{
+    static const ChapterLinkClassifier classifier;
+    return classifier;
+}
+
+ChapterLinkClassifier::ChapterLinkClassifier()
+    : m_titleKeywords(QStringList {
+          "home", "index", "bookmark", "collect", "vote", "recommend",
+          "prev", "next", "return", "toc", "setting", "config",
+          "login", "register", "search", "rank", "category", "complete",
+          QString::fromUtf8("\u9996\u9875"),         // "首页"
+          QString::fromUtf8("\u4e66\u67b6"),         // "书架"
+          QString::fromUtf8("\u52a0\u5165"),         // "加入"
+          QString::fromUtf8("\u6536\u85cf"),         // "收藏"
+          QString::fromUtf8("\u767b\u5f55"),         // "登录"
+          QString::fromUtf8("\u6ce8\u518c"),         // "注册"
+          QString::fromUtf8("\u641c\u7d22"),         // "搜索"
+          QString::fromUtf8("\u5c0f\u8bf4\u7f51")   // "小说网"
+      })
+    , m_urlPatterns(QStringList {
+          "javascript:", "mailto:", "#",
+          "/index", "/search", "/rank", "/category",
+          "/login", "/register", "/bookmark", "/vote"
+      })
+{
+}
+
+bool ChapterLinkClassifier::isNonChapterLink(const QString &title, const QString &url) const
+{
+    if (m_titleKeywords.containsAny(title.toLower())) {
+        return true;
+    }
+
+    const QString lowerUrl = url.toLower();
+    if (m_urlPatterns.containsAny(lowerUrl)) {
+        return true;
+    }
+
+    // Chapter URLs usually carry a number or the word "chapter"; titles can vouch for the rest
+    bool hasDigit = false;
+    for (const QChar ch : url) {
+        if (ch.isDigit()) {
+            hasDigit = true;
+            break;
+        }
+    }
+    if (!hasDigit && !lowerUrl.contains(QLatin1String("chapter"))) {
+        return !hasChapterMarker(title);
+    }
+
+    return false;
+}
+
+bool ChapterLinkClassifier::hasChapterMarker(const QString &title)
+{
+    static const QChar prefixes[] = { QChar(0x7B2C), QChar(0x5377) };                 // 第 卷
+    static const QChar suffixes[] = { QChar(0x7AE0), QChar(0x8282), QChar(0x56DE) };  // 章 节 回
+
+    int start = -1;
+    for (int i = 0; i < title.size() && start < 0; ++i) {
+        for (const QChar prefix : prefixes) {
+            if (title.at(i) == prefix) {
+                start = i;
+                break;
+            }
+        }
+    }
+    if (start < 0) {
+        return false;
+    }
+
+    for (int i = start + 1; i < title.size(); ++i) {
+        for (const QChar suffix : suffixes) {
+            if (title.at(i) == suffix) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
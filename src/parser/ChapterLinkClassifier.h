@@ -0,0 +1,33 @@
+#ifndef CHAPTERLINKCLASSIFIER_H
+#define CHAPTERLINKCLASSIFIER_H
+
+#include <QString>
+#include "AhoCorasick.h"
+
+/**
+ * @brief Tells navigation links (home, bookshelf, login...) from chapter links in a TOC
+ *
+ * Keyword and URL lists are compiled into automata once per process, so a
+ * link costs two linear scans of its title and URL instead of building a
+ * dozen regular expressions. Immutable; shared by all threads.
+ */
+class ChapterLinkClassifier
+{
+public:
+    static const ChapterLinkClassifier &instance();
+
+    bool isNonChapterLink(const QString &title, const QString &url) const;
+
+    /**
+     * @brief Whether the title reads like "第...章/节/回" or "卷...章"
+     */
+    static bool hasChapterMarker(const QString &title);
+
+private:
+    ChapterLinkClassifier();
+
+    AhoCorasick m_titleKeywords;    // Matched against the lowercased title
+    AhoCorasick m_urlPatterns;      // Matched against the lowercased URL
+};
+
+#endif // CHAPTERLINKCLASSIFIER_H
@@ -0,0 +1,76 @@
+#ifndef CHUNKTRANSCODER_H
+#define CHUNKTRANSCODER_H
+
+#include <QByteArray>
+#include <lexbor/encoding/encoding.h>
+
+/**
+ * @brief Incremental legacy-charset to UTF-8 transcoder on Lexbor's encoding module
+ *
+ * Decoder state survives between feed() calls, so input may be split anywhere,
+ * including inside a multi-byte sequence.
+ */
+struct ChunkTranscoder
+{
+    const lxb_encoding_data_t* from = nullptr;
+    const lxb_encoding_data_t* to = nullptr;
+    lxb_encoding_decode_t decode;
+    lxb_encoding_encode_t encode;
+    lxb_codepoint_t codepoints[4096];
+    lxb_char_t buffer[4096 * 4];
+
+    bool init(const QByteArray& charset)
+    {
+        static lxb_codepoint_t replacement[] = { 0xFFFD };
+
+        from = lxb_encoding_data_by_pre_name(
+            reinterpret_cast<const lxb_char_t*>(charset.constData()), charset.size());
+        to = lxb_encoding_data(LXB_ENCODING_UTF_8);
+        if (!from || !to) {
+            return false;
+        }
+
+        if (lxb_encoding_decode_init(&decode, from, codepoints, sizeof(codepoints) / sizeof(lxb_codepoint_t)) != LXB_STATUS_OK
+            || lxb_encoding_encode_init(&encode, to, buffer, sizeof(buffer)) != LXB_STATUS_OK) {
+            return false;
+        }
+        // Malformed sequences become U+FFFD instead of aborting the whole page
+        lxb_encoding_decode_replace_set(&decode, replacement, 1);
+        return true;
+    }
+
+    void feed(const char* input, size_t size, QByteArray* output)
+    {
+        const lxb_char_t* data = reinterpret_cast<const lxb_char_t*>(input);
+        const lxb_char_t* end = data + size;
+
+        lxb_status_t status;
+        do {
+            status = from->decode(&decode, &data, end);
+            flushCodepoints(output);
+        } while (status == LXB_STATUS_SMALL_BUFFER);
+    }
+
+    void finish(QByteArray* output)
+    {
+        // Emit replacement characters for a truncated trailing sequence
+        lxb_encoding_decode_finish(&decode);
+        flushCodepoints(output);
+    }
+
+private:
+    void flushCodepoints(QByteArray* output)
+    {
+        const lxb_codepoint_t* cp = codepoints;
+        const lxb_codepoint_t* cpEnd = codepoints + lxb_encoding_decode_buf_used(&decode);
+        lxb_status_t encodeStatus;
+        do {
+            encodeStatus = to->encode(&encode, &cp, cpEnd);
+            output->append(reinterpret_cast<const char*>(buffer), static_cast<int>(lxb_encoding_encode_buf_used(&encode)));
+            lxb_encoding_encode_buf_used_set(&encode, 0);
+        } while (encodeStatus == LXB_STATUS_SMALL_BUFFER);
+        lxb_encoding_decode_buf_used_set(&decode, 0);
+    }
+};
+
+#endif // CHUNKTRANSCODER_H
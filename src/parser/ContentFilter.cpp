@@ -0,0 +1,189 @@
+#include "ContentFilter.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QHash>
+#include <QFile>
+#include <QTextStream>
+#include <QDebug>
+
+namespace {
+
+struct FilterRegistry {
+    QMutex mutex;
+    QHash<QString, std::shared_ptr<const ContentFilter>> filters;   // filterTxt -> compiled
+    QStringList sharedLiterals;
+};
+
+FilterRegistry &registry()
+{
+    static FilterRegistry instance;
+    return instance;
+}
+
+bool isRegexMeta(QChar ch)
+{
+    switch (ch.unicode()) {
+    case '\\': case '^': case '$': case '.': case '|': case '?': case '*':
+    case '+': case '(': case ')': case '[': case ']': case '{': case '}':
+        return true;
+    default:
+        return false;
+    }
+}
+
+} // namespace
+
+std::shared_ptr<const ContentFilter> ContentFilter::forRule(const QString &filterTxt)
+{
+    FilterRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+
+    auto it = reg.filters.constFind(filterTxt);
+    if (it != reg.filters.constEnd()) {
+        return it.value();
+    }
+
+    std::shared_ptr<const ContentFilter> filter(new ContentFilter(filterTxt, reg.sharedLiterals));
+    if (!filter->isValid()) {
+        qWarning() << "ContentFilter: Invalid filter regex:" << filterTxt << filter->errorString();
+    }
+    reg.filters.insert(filterTxt, filter);
+    return filter;
+}
+
+void ContentFilter::setSharedDictionary(const QStringList &literals)
+{
+    FilterRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    reg.sharedLiterals = literals;
+    reg.filters.clear();
+}
+
+QStringList ContentFilter::sharedDictionary()
+{
+    FilterRegistry &reg = registry();
+    QMutexLocker locker(&reg.mutex);
+    return reg.sharedLiterals;
+}
+
+bool ContentFilter::loadSharedDictionary(const QString &filePath, QString *error)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        if (error) {
+            *error = file.errorString();
+        }
+        return false;
+    }
+
+    QStringList literals;
+    QTextStream in(&file);
+    in.setCodec("UTF-8");
+    while (!in.atEnd()) {
+        const QString line = in.readLine().trimmed();
+        if (!line.isEmpty() && !line.startsWith('#')) {
+            literals.append(line);
+        }
+    }
+
+    setSharedDictionary(literals);
+    qDebug() << "ContentFilter: Loaded" << literals.size() << "shared ad filters from" << filePath;
+    return true;
+}
+
+ContentFilter::ContentFilter(const QString &filterTxt, const QStringList &sharedLiterals)
+    : m_hasPatterns(false)
+{
+    QStringList literals = sharedLiterals;
+    QStringList patterns;
+
+    for (const QString &branch : splitAlternatives(filterTxt)) {
+        QString literal;
+        if (branch.isEmpty()) {
+            continue;
+        }
+        if (toLiteral(branch, &literal)) {
+            literals.append(literal);
+        } else {
+            patterns.append(branch);
+        }
+    }
+
+    m_literals = AhoCorasick(literals);
+
+    if (!patterns.isEmpty()) {
+        m_patterns = QRegularExpression(patterns.join('|'));
+        m_patterns.optimize();
+        if (m_patterns.isValid()) {
+            m_hasPatterns = true;
+        } else {
+            m_error = m_patterns.errorString();
+        }
+    }
+}
+
+QString ContentFilter::apply(const QString &content) const
+{
+    QString filtered = m_literals.removeAll(content);
+    if (m_hasPatterns) {
+        filtered.remove(m_patterns);
+    }
+    return filtered;
+}
+
+QStringList ContentFilter::splitAlternatives(const QString &pattern)
+{
+    QStringList branches;
+    QString current;
+    int depth = 0;
+    bool inClass = false;
+
+    for (int i = 0; i < pattern.size(); ++i) {
+        const QChar ch = pattern.at(i);
+        if (ch == '\\' && i + 1 < pattern.size()) {
+            current += ch;
+            current += pattern.at(++i);
+            continue;
+        }
+        if (inClass) {
+            inClass = ch != ']';
+        } else if (ch == '[') {
+            inClass = true;
+        } else if (ch == '(') {
+            depth++;
+        } else if (ch == ')') {
+            depth = qMax(0, depth - 1);
+        } else if (ch == '|' && depth == 0) {
+            branches.append(current);
+            current.clear();
+            continue;
+        }
+        current += ch;
+    }
+    branches.append(current);
+    return branches;
+}
+
+bool ContentFilter::toLiteral(const QString &branch, QString *literal)
+{
+    QString text;
+    text.reserve(branch.size());
+
+    for (int i = 0; i < branch.size(); ++i) {
+        const QChar ch = branch.at(i);
+        if (ch == '\\') {
+            // Only escaped punctuation is literal; \d, \s, \b and friends are patterns
+            if (i + 1 >= branch.size() || branch.at(i + 1).isLetterOrNumber()) {
+                return false;
+            }
+            text += branch.at(++i);
+        } else if (isRegexMeta(ch)) {
+            return false;
+        } else {
+            text += ch;
+        }
+    }
+
+    *literal = text;
+    return true;
+}
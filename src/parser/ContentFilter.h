@@ -0,0 +1,70 @@
+#ifndef CONTENTFILTER_H
+#define CONTENTFILTER_H
+
+#include <QString>
+#include <QStringList>
+#include <QRegularExpression>
+#include <memory>
+#include "AhoCorasick.h"
+
+/**
+ * @brief Compiled form of a ChapterRule filterTxt
+ *
+ * filterTxt is a regex alternation, but in practice almost every branch is a
+ * literal slogan. Literal branches (escaped metacharacters allowed) go into
+ * one Aho-Corasick automaton together with the shared ad dictionary; only
+ * real patterns stay in a regex, compiled once. Immutable and shared.
+ */
+class ContentFilter
+{
+public:
+    /**
+     * @brief Compiled filter for a filterTxt, cached per string
+     *
+     * Always non-null; an empty filterTxt still applies the shared dictionary.
+     */
+    static std::shared_ptr<const ContentFilter> forRule(const QString &filterTxt);
+
+    /**
+     * @brief Literal ad slogans removed from every source's chapters
+     *
+     * Filters compiled from now on include them; cached filters are dropped.
+     */
+    static void setSharedDictionary(const QStringList &literals);
+    static QStringList sharedDictionary();
+
+    /**
+     * @brief Load the shared dictionary from a UTF-8 file, one literal per line
+     *
+     * Blank lines and lines starting with '#' are skipped.
+     */
+    static bool loadSharedDictionary(const QString &filePath, QString *error = nullptr);
+
+    QString apply(const QString &content) const;
+
+    bool isValid() const { return m_error.isEmpty(); }
+    QString errorString() const { return m_error; }
+    int literalCount() const { return m_literals.patternCount(); }
+    bool hasPatterns() const { return m_hasPatterns; }
+
+    /**
+     * @brief Split a regex alternation at top-level '|' bars
+     */
+    static QStringList splitAlternatives(const QString &pattern);
+
+    /**
+     * @brief Literal text a regex branch stands for
+     * @return False if the branch uses any unescaped metacharacter
+     */
+    static bool toLiteral(const QString &branch, QString *literal);
+
+private:
+    ContentFilter(const QString &filterTxt, const QStringList &sharedLiterals);
+
+    AhoCorasick m_literals;
+    QRegularExpression m_patterns;
+    bool m_hasPatterns;
+    QString m_error;
+};
+
+#endif // CONTENTFILTER_H
@@ -1,5 +1,12 @@
 #include "ContentParser.h"
 #include "LexborHtmlParser.h"
+#include "ParsedDocument.h"
+#include "ParserPool.h"
+#include "HtmlSanitizer.h"
+#include "TextNormalizer.h"
+#include "ContentFilter.h"
+#include "ChapterLinkClassifier.h"
+#include "../network/CharsetDetector.h"
 #include <QDebug>
 #include <QUrl>
 #include <QRegularExpression>
@@ -13,7 +20,6 @@ ContentParser::ContentParser(QObject *parent)
 {
 
     m_htmlTagRegex = QRegularExpression("<[^>]*>", QRegularExpression::CaseInsensitiveOption);
-    m_whitespaceRegex = QRegularExpression("\\s+");
     m_entityRegex = QRegularExpression("&[^;]+;");
     m_invisibleRegex = QRegularExpression("[\\x00-\\x08\\x0B\\x0C\\x0E-\\x1F\\x7F]");
 }
@@ -46,10 +52,10 @@ QList<SearchResult> ContentParser::parseSearchResults(const QString &html, const
     debugLog(QString("Parsing search results, selector: %1, HTML length: %2").arg(rule.result()).arg(html.length()));
 
     // Try using Lexbor HTML parser first
-    LexborHtmlParser lexborParser;
-    if (lexborParser.parseHtml(html)) {
+    ParserPool::Lease lexborParser = ParserPool::acquire();
+    if (lexborParser->parseHtml(html)) {
         // Use improved parsing method that works with complete HTML document
-        QList<SearchResult> lexborResults = parseSearchResultsWithLexbor(lexborParser, rule, sourceId, baseUrl);
+        QList<SearchResult> lexborResults = parseSearchResultsWithLexbor(*lexborParser, rule, sourceId, baseUrl);
         if (!lexborResults.isEmpty()) {
             debugLog(QString("Lexbor parsing completed, found %1 results").arg(lexborResults.size()));
             return lexborResults;
@@ -58,6 +64,42 @@ QList<SearchResult> ContentParser::parseSearchResults(const QString &html, const
 
     // Fallback to original regex-based parsing
     debugLog("Falling back to regex-based parsing");
+    return parseSearchResultsWithRegex(html, rule, sourceId, baseUrl);
+}
+
+QList<SearchResult> ContentParser::parseSearchResults(const QByteArray &html, const QByteArray &charset, const BookSource &source, const QString &baseUrl)
+{
+    const SearchRule &rule = *source.searchRule();
+    QList<SearchResult> results;
+
+    if (html.isEmpty() || rule.result().isEmpty()) {
+        setError("HTML content or search result selector is empty");
+        return results;
+    }
+
+    debugLog(QString("Parsing search results from bytes, selector: %1, size: %2, charset: %3")
+             .arg(rule.result()).arg(html.size()).arg(QString::fromLatin1(charset)));
+
+    ParserPool::Lease lexborParser = ParserPool::acquire();
+    if (lexborParser->parseHtml(html, charset)) {
+        results = parseSearchResultsWithLexbor(*lexborParser, rule, source.id(), baseUrl);
+    }
+
+    if (results.isEmpty()) {
+        debugLog("Falling back to regex-based parsing");
+        results = parseSearchResultsWithRegex(CharsetDetector::decode(html, charset), rule, source.id(), baseUrl);
+    }
+
+    for (SearchResult &result : results) {
+        result.setSourceName(source.name());
+    }
+
+    return results;
+}
+
+QList<SearchResult> ContentParser::parseSearchResultsWithRegex(const QString &html, const SearchRule &rule, int sourceId, const QString &baseUrl)
+{
+    QList<SearchResult> results;
     QString cleanHtml = preprocessHtml(html);
     QStringList resultItems = extractMultipleContent(cleanHtml, rule.result(), HTML);
     
@@ -153,70 +195,123 @@ Book ContentParser::parseBookDetails(const QString &html, const BookSource &sour
 
 Book ContentParser::parseBookDetails(const QString &html, const BookRule &rule, const QString &bookUrl)
 {
-    Book book;
-    
     if (html.isEmpty()) {
         setError("HTML content is empty");
-        return book;
+        return Book();
     }
-    
+
     debugLog("Start parsing book details");
-    
 
     QString cleanHtml = preprocessHtml(html);
 
+    // One tree serves every field; only fields Lexbor cannot answer fall back to regex
+    ParsedDocument document;
+    if (!document.parse(cleanHtml)) {
+        debugLog("Failed to parse HTML with Lexbor, using regex for book details");
+    }
+
+    Book book = parseBookDetails(document, rule, bookUrl);
+
+    // Fields found in the tree are already cleaned; only regex results still need cleanText()
+    auto fallback = [&](const QString &selector, ContentType type, const QString &current) {
+        if (!current.isEmpty() || selector.isEmpty()) {
+            return current;
+        }
+        return extractSingleContent(cleanHtml, selector, type);
+    };
+    auto textFallback = [&](const QString &selector, const QString &current) {
+        if (!current.isEmpty() || selector.isEmpty()) {
+            return current;
+        }
+        return cleanText(extractSingleContent(cleanHtml, selector, detectContentType(selector)));
+    };
+
+    book.setBookName(textFallback(rule.bookName(), book.bookName()));
+    book.setAuthor(textFallback(rule.author(), book.author()));
+    book.setIntro(textFallback(rule.intro(), book.intro()));
+    book.setCategory(textFallback(rule.category(), book.category()));
+    book.setCoverUrl(fallback(rule.coverUrl(), coverContentType(rule.coverUrl()), book.coverUrl()));
+    book.setLatestChapter(textFallback(rule.latestChapter(), book.latestChapter()));
+    book.setLastUpdateTime(textFallback(rule.lastUpdateTime(), book.lastUpdateTime()));
+    book.setStatus(textFallback(rule.status(), book.status()));
+    book.setWordCount(textFallback(rule.wordCount(), book.wordCount()));
+
+    debugLog(QString("Book details analysis completed: %1 - %2").arg(book.bookName()).arg(book.author()));
+    return book;
+}
+
+Book ContentParser::parseBookDetails(ParsedDocument &document, const BookRule &rule, const QString &bookUrl)
+{
+    Book book;
     book.setUrl(bookUrl);
 
+    if (!document.isValid()) {
+        return book;
+    }
+
     if (!rule.bookName().isEmpty()) {
-        QString bookName = extractSingleContent(cleanHtml, rule.bookName(), detectContentType(rule.bookName()));
-        book.setBookName(cleanText(bookName));
+        book.setBookName(cleanText(extractField(document, rule.bookName(), detectContentType(rule.bookName()))));
     }
 
     if (!rule.author().isEmpty()) {
-        QString author = extractSingleContent(cleanHtml, rule.author(), detectContentType(rule.author()));
-        book.setAuthor(cleanText(author));
+        book.setAuthor(cleanText(extractField(document, rule.author(), detectContentType(rule.author()))));
     }
 
     if (!rule.intro().isEmpty()) {
-        QString intro = extractSingleContent(cleanHtml, rule.intro(), detectContentType(rule.intro()));
-        book.setIntro(cleanText(intro));
+        book.setIntro(cleanText(extractField(document, rule.intro(), detectContentType(rule.intro()))));
     }
 
     if (!rule.category().isEmpty()) {
-        QString category = extractSingleContent(cleanHtml, rule.category(), detectContentType(rule.category()));
-        book.setCategory(cleanText(category));
+        book.setCategory(cleanText(extractField(document, rule.category(), detectContentType(rule.category()))));
     }
-    
+
     if (!rule.coverUrl().isEmpty()) {
-        ContentType coverType = rule.coverUrl().startsWith("meta[") ? ATTR_CONTENT : ATTR_SRC;
-        QString coverUrl = extractSingleContent(cleanHtml, rule.coverUrl(), coverType);
-        book.setCoverUrl(coverUrl);
+        book.setCoverUrl(extractField(document, rule.coverUrl(), coverContentType(rule.coverUrl())));
     }
-    
+
     if (!rule.latestChapter().isEmpty()) {
-        QString latestChapter = extractSingleContent(cleanHtml, rule.latestChapter(), detectContentType(rule.latestChapter()));
-        book.setLatestChapter(cleanText(latestChapter));
+        book.setLatestChapter(cleanText(extractField(document, rule.latestChapter(), detectContentType(rule.latestChapter()))));
     }
 
     if (!rule.lastUpdateTime().isEmpty()) {
-        QString lastUpdateTime = extractSingleContent(cleanHtml, rule.lastUpdateTime(), detectContentType(rule.lastUpdateTime()));
-        book.setLastUpdateTime(cleanText(lastUpdateTime));
+        book.setLastUpdateTime(cleanText(extractField(document, rule.lastUpdateTime(), detectContentType(rule.lastUpdateTime()))));
     }
 
     if (!rule.status().isEmpty()) {
-        QString status = extractSingleContent(cleanHtml, rule.status(), detectContentType(rule.status()));
-        book.setStatus(cleanText(status));
+        book.setStatus(cleanText(extractField(document, rule.status(), detectContentType(rule.status()))));
     }
 
     if (!rule.wordCount().isEmpty()) {
-        QString wordCount = extractSingleContent(cleanHtml, rule.wordCount(), detectContentType(rule.wordCount()));
-        book.setWordCount(cleanText(wordCount));
+        book.setWordCount(cleanText(extractField(document, rule.wordCount(), detectContentType(rule.wordCount()))));
     }
-    
-    debugLog(QString("Book details analysis completed: %1 - %2").arg(book.bookName()).arg(book.author()));
+
     return book;
 }
 
+QString ContentParser::extractField(ParsedDocument &document, const QString &selector, ContentType type)
+{
+    switch (type) {
+    case HTML:
+        return document.outerHtml(selector);
+    case ATTR_HREF:
+        return document.attribute(selector, "href");
+    case ATTR_SRC:
+        return document.attribute(selector, "src");
+    case ATTR_CONTENT:
+        return document.attribute(selector, "content");
+    case ATTR_VALUE:
+        return document.attribute(selector, "value");
+    case TEXT:
+    default:
+        return document.text(selector);
+    }
+}
+
+ContentParser::ContentType ContentParser::coverContentType(const QString &selector)
+{
+    return selector.startsWith("meta[") ? ATTR_CONTENT : ATTR_SRC;
+}
+
 QList<Chapter> ContentParser::parseChapterList(const QString &html, const BookSource &source, const QString &baseUrl)
 {
     return parseChapterList(html, *source.tocRule(), baseUrl);
@@ -265,6 +360,97 @@ QString ContentParser::parseChapterContent(const QString &html, const ChapterRul
     return parseChapterContentSinglePage(html, rule);
 }
 
+QList<Chapter> ContentParser::parseChapterList(const QByteArray &html, const QByteArray &charset, const BookSource &source, const QString &baseUrl)
+{
+    return parseChapterList(html, charset, *source.tocRule(), baseUrl);
+}
+
+QList<Chapter> ContentParser::parseChapterList(const QByteArray &html, const QByteArray &charset, const TocRule &rule, const QString &baseUrl)
+{
+    if (html.isEmpty() || rule.item().isEmpty()) {
+        setError("HTML content or chapter selector is empty");
+        return QList<Chapter>();
+    }
+
+    // Pagination still walks pages as text
+    if (rule.pagination() && !rule.nextPage().isEmpty()) {
+        return parseChapterList(CharsetDetector::decode(html, charset), rule, baseUrl);
+    }
+
+    debugLog(QString("Start parsing chapter list from bytes, selector: %1, charset: %2")
+             .arg(rule.item()).arg(QString::fromLatin1(charset)));
+
+    // Lexbor reads the page in its own encoding; no QString copy of the document is made
+    ParserPool::Lease lexborParser = ParserPool::acquire();
+    if (!lexborParser->parseHtml(html, charset)) {
+        debugLog("Failed to parse HTML with Lexbor, falling back to regex method");
+        return parseChapterListWithRegex(preprocessHtml(CharsetDetector::decode(html, charset)), rule, baseUrl);
+    }
+
+    return parseChapterListWithLexbor(*lexborParser, rule, baseUrl);
+}
+
+QList<Chapter> ContentParser::parseChapterList(LexborHtmlParser &parsedDocument, const TocRule &rule, const QString &baseUrl)
+{
+    if (rule.item().isEmpty()) {
+        setError("Chapter selector is empty");
+        return QList<Chapter>();
+    }
+
+    debugLog(QString("Start parsing chapter list from streamed document, selector: %1").arg(rule.item()));
+    return parseChapterListWithLexbor(parsedDocument, rule, baseUrl);
+}
+
+bool ContentParser::tocLinkToChapter(const QString &title, const QString &href, const QString &baseUrl, Chapter *chapter)
+{
+    // Same checks as parseChapterListWithLexbor
+    const QString trimmedTitle = title.trimmed();
+    if (trimmedTitle.isEmpty() || href.isEmpty() || isNonChapterLink(trimmedTitle, href)) {
+        return false;
+    }
+
+    chapter->setTitle(cleanText(trimmedTitle));
+    chapter->setUrl(resolveUrl(href, baseUrl));
+    return true;
+}
+
+QString ContentParser::parseChapterContent(const QByteArray &html, const QByteArray &charset, const ChapterRule &rule)
+{
+    if (html.isEmpty() || rule.content().isEmpty()) {
+        setError("HTML content or chapter content selector is empty");
+        return QString();
+    }
+
+    if (rule.pagination() && !rule.nextPage().isEmpty()) {
+        return parseChapterContent(CharsetDetector::decode(html, charset), rule);
+    }
+
+    debugLog(QString("Start parsing chapter content from bytes, selector: %1, charset: %2")
+             .arg(rule.content()).arg(QString::fromLatin1(charset)));
+
+    ParserPool::Lease lexborParser = ParserPool::acquire();
+    QString content;
+    if (lexborParser->parseHtml(html, charset)) {
+        content = extractChapterContentWithLexbor(*lexborParser, rule);
+    }
+
+    // Fallback to regex method if Lexbor fails
+    if (content.isEmpty()) {
+        debugLog("Falling back to regex method for chapter content");
+        content = extractSingleContent(preprocessHtml(CharsetDetector::decode(html, charset)), rule.content(), HTML);
+    } else {
+        // The text path strips these in preprocessHtml before parsing
+        content = cleanInvisibleChars(content);
+    }
+
+    if (content.isEmpty()) {
+        setError(QString("Cannot extract chapter content with selector: %1").arg(rule.content()));
+        return QString();
+    }
+
+    return finishChapterContent(content, rule);
+}
+
 QStringList ContentParser::parseNextPageUrls(const QString &html, const QString &nextPageSelector, const QString &baseUrl)
 {
     QStringList urls;
@@ -285,6 +471,14 @@ QStringList ContentParser::parseNextPageUrls(const QString &html, const QString
     return urls;
 }
 
+QStringList ContentParser::parseNextPageUrls(ParsedDocument &document, const QString &nextPageSelector, const QString &baseUrl)
+{
+    if (!document.isValid() || nextPageSelector.isEmpty()) {
+        return QStringList();
+    }
+    return resolveUrls(document.attributes(nextPageSelector, "href"), baseUrl);
+}
+
 QString ContentParser::parseNextPageUrl(const QString &html, const QString &nextPageSelector, const QString &baseUrl)
 {
     QStringList urls = parseNextPageUrls(html, nextPageSelector, baseUrl);
@@ -406,36 +600,14 @@ QString ContentParser::cleanText(const QString &text)
         return text;
     }
 
-    QString cleaned = text;
-
-
-    cleaned = cleanInvisibleChars(cleaned);
-
-
-    cleaned = unescapeHtml(cleaned);
-
-    cleaned = normalizeWhitespace(cleaned);
-
-    return cleaned.trimmed();
+    return TextNormalizer::normalize(text, TextNormalizer::DecodeEntities | TextNormalizer::StripControlChars);
 }
 
 QString ContentParser::cleanHtml(const QString &html)
 {
-    if (html.isEmpty()) {
-        return html;
-    }
-
-    QString cleaned = html;
-
-
-    cleaned = cleanInvisibleChars(cleaned);
-
-    cleaned.remove(QRegularExpression("<!--.*?-->", QRegularExpression::DotMatchesEverythingOption));
-
-    cleaned.remove(QRegularExpression("<script[^>]*>.*?</script>", QRegularExpression::CaseInsensitiveOption | QRegularExpression::DotMatchesEverythingOption));
-    cleaned.remove(QRegularExpression("<style[^>]*>.*?</style>", QRegularExpression::CaseInsensitiveOption | QRegularExpression::DotMatchesEverythingOption));
-
-    return cleaned;
+    return HtmlSanitizer::sanitize(html, HtmlSanitizer::StripControlChars
+                                         | HtmlSanitizer::StripComments
+                                         | HtmlSanitizer::StripScripts);
 }
 
 QString ContentParser::removeHtmlTags(const QString &html, const QStringList &tagsToRemove)
@@ -460,21 +632,11 @@ QString ContentParser::filterContent(const QString &content, const QString &filt
 {
     QString filtered = content;
 
-    // Apply text filter using regex
-    if (!filterText.isEmpty()) {
-        try {
-            QRegularExpression filterRegex(filterText);
-            if (filterRegex.isValid()) {
-                filtered.remove(filterRegex);
-                debugLog(QString("Applied text filter, removed %1 matches").arg(filterText));
-            } else {
-                debugLog(QString("Invalid filter regex: %1 - %2").arg(filterText).arg(filterRegex.errorString()));
-                setError(QString("Invalid filter regex: %1").arg(filterRegex.errorString()));
-            }
-        } catch (const std::exception& e) {
-            debugLog(QString("Exception in text filter: %1").arg(e.what()));
-            setError(QString("Exception in text filter: %1").arg(e.what()));
-        }
+    // Literal slogans in one automaton pass, real patterns in a regex compiled once
+    std::shared_ptr<const ContentFilter> filter = ContentFilter::forRule(filterText);
+    filtered = filter->apply(filtered);
+    if (!filter->isValid()) {
+        setError(QString("Invalid filter regex: %1").arg(filter->errorString()));
     }
 
     if (!filterTags.isEmpty()) {
@@ -487,32 +649,21 @@ QString ContentParser::filterContent(const QString &content, const QString &filt
 
 QString ContentParser::formatChapterContent(const QString &content, const ChapterRule &rule)
 {
-    QString formatted = content;
-
-
-    formatted = filterContent(formatted, rule.filterTxt(), rule.filterTag());
+    QString formatted = filterContent(content, rule.filterTxt(), rule.filterTag());
 
+    // A closed paragraph tag is a tag name the normalizer breaks lines on;
+    // otherwise it is a rule regex that has to run first
+    QString breakTag;
     if (!rule.paragraphTag().isEmpty()) {
         if (rule.paragraphTagClosed()) {
-
-            formatted.replace(QRegularExpression(QString("<%1[^>]*>").arg(rule.paragraphTag())), "\n");
-            formatted.replace(QRegularExpression(QString("</%1>").arg(rule.paragraphTag())), "");
+            breakTag = rule.paragraphTag();
         } else {
-
             formatted.replace(QRegularExpression(rule.paragraphTag()), "\n");
         }
     }
 
-
-    formatted.remove(m_htmlTagRegex);
-
-    formatted = unescapeHtml(formatted);
-
-    formatted = normalizeWhitespace(formatted);
-
-    formatted.remove(QRegularExpression("\\n\\s*\\n"));
-
-    return formatted.trimmed();
+    // Tags, entities, control characters and whitespace in one pass
+    return TextNormalizer::normalize(formatted, TextNormalizer::ChapterText, breakTag);
 }
 
 QString ContentParser::resolveUrl(const QString &url, const QString &baseUrl)
@@ -694,23 +845,11 @@ ContentParser::ContentType ContentParser::detectContentType(const QString &selec
 
 QString ContentParser::preprocessHtml(const QString &html)
 {
-    debugLog(QString("preprocessHtml - Original HTML length: %1 chars").arg(html.length()));
-    debugLog(QString("preprocessHtml - Original HTML sample: %1").arg(html.left(200)));
-
-    QString processed = html;
-
-    // 清理不可见字符
-    processed = cleanInvisibleChars(processed);
-    debugLog(QString("preprocessHtml - After cleaning invisible chars: %1 chars").arg(processed.length()));
-
-    // 移除HTML注释
-    processed.remove(QRegularExpression("<!--.*?-->", QRegularExpression::DotMatchesEverythingOption));
-    debugLog(QString("preprocessHtml - After removing comments: %1 chars").arg(processed.length()));
-
-    // 标准化空白字符
-    processed.replace(QRegularExpression("\\s+"), " ");
-    debugLog(QString("preprocessHtml - After normalizing whitespace: %1 chars").arg(processed.length()));
-    debugLog(QString("preprocessHtml - Processed HTML sample: %1").arg(processed.left(200)));
+    // Invisible characters, comments and whitespace runs go in one scan
+    QString processed = HtmlSanitizer::sanitize(html, HtmlSanitizer::StripControlChars
+                                                      | HtmlSanitizer::StripComments
+                                                      | HtmlSanitizer::CollapseWhitespace);
+    debugLog(QString("preprocessHtml - %1 -> %2 chars").arg(html.length()).arg(processed.length()));
 
     return processed;
 }
@@ -722,26 +861,6 @@ QString ContentParser::cleanInvisibleChars(const QString &text)
     return cleaned;
 }
 
-QString ContentParser::unescapeHtml(const QString &html)
-{
-
-    QString result = html;
-    result.replace("&amp;", "&");
-    result.replace("&lt;", "<");
-    result.replace("&gt;", ">");
-    result.replace("&quot;", "\"");
-    result.replace("&#39;", "'");
-    result.replace("&nbsp;", " ");
-    return result;
-}
-
-QString ContentParser::normalizeWhitespace(const QString &text)
-{
-    QString normalized = text;
-    normalized.replace(m_whitespaceRegex, " ");
-    return normalized;
-}
-
 QString ContentParser::removeDuplicateTitle(const QString &content, const QString &title)
 {
     if (title.isEmpty()) {
@@ -846,55 +965,7 @@ QList<Chapter> ContentParser::parseChapterListWithRegex(const QString &html, con
 
 bool ContentParser::isNonChapterLink(const QString &title, const QString &url)
 {
-    // Filter out common non-chapter links by title patterns
-    QStringList nonChapterPatterns = {
-        "home", "index", "bookmark", "collect", "vote", "recommend",
-        "prev", "next", "return", "toc", "setting", "config",
-        "login", "register", "search", "rank", "category", "complete"
-    };
-
-    for (const QString &pattern : nonChapterPatterns) {
-        if (title.contains(pattern, Qt::CaseInsensitive)) {
-            return true;
-        }
-    }
-
-    // Filter out Chinese common non-chapter titles using Unicode ranges
-    if (title.contains(QRegularExpression("[\u9996\u9875]")) ||      // "首页"
-        title.contains(QRegularExpression("[\u4e66\u67b6]")) ||      // "书架"
-        title.contains(QRegularExpression("[\u52a0\u5165]")) ||      // "加入"
-        title.contains(QRegularExpression("[\u6536\u85cf]")) ||      // "收藏"
-        title.contains(QRegularExpression("[\u767b\u5f55]")) ||      // "登录"
-        title.contains(QRegularExpression("[\u6ce8\u518c]")) ||      // "注册"
-        title.contains(QRegularExpression("[\u641c\u7d22]")) ||      // "搜索"
-        title.contains(QRegularExpression("[\u5c0f\u8bf4\u7f51]"))) { // "小说网"
-        return true;
-    }
-
-    // Filter out common non-chapter links by URL patterns
-    QStringList nonChapterUrlPatterns = {
-        "javascript:", "mailto:", "#",
-        "/index", "/search", "/rank", "/category",
-        "/login", "/register", "/bookmark", "/vote"
-    };
-
-    for (const QString &pattern : nonChapterUrlPatterns) {
-        if (url.contains(pattern, Qt::CaseInsensitive)) {
-            return true;
-        }
-    }
-
-    // Filter out URLs that don't look like chapter URLs
-    // Chapter URLs usually contain numbers or specific patterns
-    if (!url.contains(QRegularExpression("\\d+")) && !url.contains("chapter", Qt::CaseInsensitive)) {
-        // If URL doesn't contain numbers or "chapter", it's likely not a chapter
-        // But allow if title looks like a chapter (contains Chinese chapter markers)
-        if (!title.contains(QRegularExpression("[\u7b2c\u5377].*[\u7ae0\u8282\u56de]"))) { // "第卷" + "章节回"
-            return true;
-        }
-    }
-
-    return false;
+    return ChapterLinkClassifier::instance().isNonChapterLink(title, url);
 }
 
 QString ContentParser::applySpecialProcessing(const QString &content, const ChapterRule &rule)
@@ -1053,6 +1124,81 @@ QList<Chapter> ContentParser::parseChapterListWithPagination(const QString &html
     return allChapters;
 }
 
+QList<Chapter> ContentParser::parseTocPage(const QByteArray &html, const QByteArray &charset, const TocRule &rule,
+                                           const QString &pageUrl, QStringList *pageUrls)
+{
+    if (pageUrls) {
+        pageUrls->clear();
+    }
+
+    if (html.isEmpty() || rule.item().isEmpty()) {
+        setError("HTML content or chapter selector is empty");
+        return QList<Chapter>();
+    }
+
+    debugLog(QString("Start parsing chapter list page: %1").arg(pageUrl));
+
+    // The same tree answers both the chapter links and the page links
+    ParsedDocument document;
+    QList<Chapter> chapters;
+    if (document.parse(html, charset)) {
+        chapters = parseChapterListWithLexbor(document.parser(), rule, pageUrl);
+        if (pageUrls && rule.pagination()) {
+            *pageUrls = parseTocPageUrls(document, rule, pageUrl);
+        }
+    } else {
+        debugLog("Failed to parse HTML with Lexbor, falling back to regex method");
+        const QString cleanHtml = preprocessHtml(CharsetDetector::decode(html, charset));
+        chapters = parseChapterListWithRegex(cleanHtml, rule, pageUrl);
+        if (pageUrls && rule.pagination()) {
+            const QString nextPageUrl = parseNextPageUrl(cleanHtml, rule.nextPage(), pageUrl);
+            if (!nextPageUrl.isEmpty() && nextPageUrl != pageUrl) {
+                pageUrls->append(nextPageUrl);
+            }
+        }
+    }
+
+    return chapters;
+}
+
+QStringList ContentParser::parseTocPageUrls(ParsedDocument &document, const TocRule &rule, const QString &pageUrl)
+{
+    // A page select box lists every page in order; numbered links list a window
+    // of them. Both come before the rule's next-page links, which may point at
+    // a page already listed.
+    static const QRegularExpression digitRuns("\\d+");
+    const auto pathPattern = [](const QUrl &url) {
+        // "/book/12_3/" -> "/book/#_#/": pages of one TOC differ only in their numbers
+        return url.path().replace(digitRuns, "#");
+    };
+
+    QStringList candidates;
+    const QUrl tocUrl(pageUrl);
+    const QString tocPattern = pathPattern(tocUrl);
+    for (const QString &url : resolveUrls(document.attributes("select option[value]", "value"), pageUrl)) {
+        // Select boxes are also used for chapter jumps and site menus, which lead
+        // to pages shaped differently from this one
+        const QUrl option(url);
+        if (option.host().compare(tocUrl.host(), Qt::CaseInsensitive) == 0 && pathPattern(option) == tocPattern) {
+            candidates.append(url);
+        }
+    }
+    candidates += parseNextPageUrls(document, rule.nextPage(), pageUrl);
+
+    QStringList urls;
+    for (const QString &url : candidates) {
+        const QUrl parsed(url);
+        // "javascript:" and "#" links do not lead to another page
+        if (!parsed.scheme().startsWith("http") || parsed.adjusted(QUrl::RemoveFragment).toString() == pageUrl) {
+            continue;
+        }
+        if (!urls.contains(url)) {
+            urls.append(url);
+        }
+    }
+    return urls;
+}
+
 QString ContentParser::parseChapterContentWithPagination(const QString &html, const ChapterRule &rule, const QString &baseUrl)
 {
     QString allContent;
@@ -1072,8 +1218,9 @@ QString ContentParser::parseChapterContentWithPagination(const QString &html, co
     while (!currentHtml.isEmpty() && pageCount <= maxPages) {
         debugLog(QString("Processing page %1 of chapter content").arg(pageCount));
 
-        // Parse content from current page
-        QString pageContent = parseChapterContentSinglePage(currentHtml, rule);
+        // Parse content and next page link from one tree
+        QString nextPageUrl;
+        QString pageContent = parseChapterPage(currentHtml, rule, currentBaseUrl, &nextPageUrl);
 
         if (pageContent.isEmpty()) {
             debugLog(QString("No content found on page %1, stopping pagination").arg(pageCount));
@@ -1088,9 +1235,6 @@ QString ContentParser::parseChapterContentWithPagination(const QString &html, co
 
         debugLog(QString("Added content from page %1, total length: %2").arg(pageCount).arg(allContent.length()));
 
-        // Find next page URL
-        QString nextPageUrl = parseNextPageUrl(currentHtml, rule.nextPage(), currentBaseUrl);
-
         if (nextPageUrl.isEmpty()) {
             debugLog("No next page URL found, pagination complete");
             break;
@@ -1121,6 +1265,15 @@ QString ContentParser::parseChapterContentWithPagination(const QString &html, co
 
 QString ContentParser::parseChapterContentSinglePage(const QString &html, const ChapterRule &rule)
 {
+    return parseChapterPage(html, rule, QString(), nullptr);
+}
+
+QString ContentParser::parseChapterPage(const QString &html, const ChapterRule &rule, const QString &pageUrl, QString *nextPageUrl)
+{
+    if (nextPageUrl) {
+        nextPageUrl->clear();
+    }
+
     if (html.isEmpty() || rule.content().isEmpty()) {
         setError("HTML content or chapter content selector is empty");
         return QString();
@@ -1131,19 +1284,12 @@ QString ContentParser::parseChapterContentSinglePage(const QString &html, const
     QString cleanHtml = preprocessHtml(html);
 
     // === USE LEXBOR HTML PARSER FOR REAL CSS SELECTOR SUPPORT ===
-    LexborHtmlParser lexborParser;
+    // The same tree answers both the content and the next-page link
+    ParsedDocument document;
     QString content;
 
-    if (lexborParser.parseHtml(cleanHtml)) {
-        // Use real CSS selector to get chapter content
-        QStringList contentElements = lexborParser.selectElements(rule.content());
-
-        if (!contentElements.isEmpty()) {
-            content = contentElements.first(); // Get the first matching element
-            debugLog(QString("Lexbor extracted content length: %1").arg(content.length()));
-        } else {
-            debugLog(QString("Lexbor found no elements for selector: %1").arg(rule.content()));
-        }
+    if (document.parse(cleanHtml)) {
+        content = extractChapterContentWithLexbor(document.parser(), rule);
     }
 
     // Fallback to regex method if Lexbor fails
@@ -1153,36 +1299,148 @@ QString ContentParser::parseChapterContentSinglePage(const QString &html, const
         debugLog(QString("Regex extracted content length: %1").arg(content.length()));
     }
 
+    if (nextPageUrl && !rule.nextPage().isEmpty()) {
+        QStringList urls = parseNextPageUrls(document, rule.nextPage(), pageUrl);
+        if (urls.isEmpty() && !document.isValid()) {
+            urls = parseNextPageUrls(cleanHtml, rule.nextPage(), pageUrl);
+        }
+        if (!urls.isEmpty()) {
+            *nextPageUrl = urls.first();
+        }
+    }
+
     if (content.isEmpty()) {
         setError(QString("Cannot extract chapter content with selector: %1").arg(rule.content()));
         return QString();
     }
 
-    // Apply special processing for specific book sources
-    content = applySpecialProcessing(content, rule);
+    return finishChapterContent(content, rule);
+}
 
-    content = formatChapterContent(content, rule);
+QString ContentParser::chapterSubPageUrl(const QString &chapterUrl, int pageNumber)
+{
+    QUrl url(chapterUrl);
+    const QString path = url.path();
+    const int slash = path.lastIndexOf('/');
+    int dot = path.lastIndexOf('.');
+    if (dot <= slash) {
+        dot = path.length();
+    }
 
-    debugLog(QString("Single page chapter content parsing completed, final length: %1 characters").arg(content.length()));
+    url.setPath(path.left(dot) + QString("_%1").arg(pageNumber) + path.mid(dot));
+    return url.toString();
+}
+
+int ContentParser::chapterSubPageNumber(const QString &chapterUrl, const QString &pageUrl)
+{
+    const QUrl chapter(chapterUrl);
+    const QUrl page(pageUrl);
+    if (chapter.host().compare(page.host(), Qt::CaseInsensitive) != 0) {
+        return 0;
+    }
+
+    const QString chapterPath = chapter.path();
+    const int slash = chapterPath.lastIndexOf('/');
+    int dot = chapterPath.lastIndexOf('.');
+    if (dot <= slash) {
+        dot = chapterPath.length();
+    }
+    const QString prefix = chapterPath.left(dot) + '_';
+    const QString suffix = chapterPath.mid(dot);
+
+    const QString pagePath = page.path();
+    if (pagePath.length() <= prefix.length() + suffix.length()
+        || !pagePath.startsWith(prefix) || !pagePath.endsWith(suffix)) {
+        return 0;
+    }
+
+    bool ok = false;
+    const int number = pagePath.mid(prefix.length(), pagePath.length() - prefix.length() - suffix.length()).toInt(&ok);
+    return ok && number > 1 ? number : 0;
+}
+
+QString ContentParser::stitchChapterPages(const QStringList &pages)
+{
+    QString stitched;
+    QStringList previousLines;
+
+    for (const QString &page : pages) {
+        QStringList lines = page.trimmed().split('\n');
+
+        // Sites often repeat the paragraph a page was cut at, or its last few lines
+        int overlap = 0;
+        for (int k = qMin(MAX_SEAM_LINES, qMin(previousLines.size(), lines.size())); k > 0 && overlap == 0; --k) {
+            bool same = true;
+            for (int i = 0; i < k && same; ++i) {
+                same = lines.at(i).trimmed() == previousLines.at(previousLines.size() - k + i).trimmed();
+            }
+            // A single short line repeats too often by chance to be taken as the cut paragraph
+            if (same && (k > 1 || lines.first().trimmed().length() >= MIN_SEAM_CHARS)) {
+                overlap = k;
+            }
+        }
+
+        previousLines = lines;
+        lines = lines.mid(overlap);
+        if (lines.isEmpty()) {
+            continue;
+        }
+        if (!stitched.isEmpty()) {
+            stitched += "\n\n";
+        }
+        stitched += lines.join('\n');
+    }
+
+    return stitched;
+}
+
+QString ContentParser::extractChapterContentWithLexbor(LexborHtmlParser &parser, const ChapterRule &rule)
+{
+    // Use real CSS selector to get chapter content
+    QStringList contentElements = parser.selectElements(rule.content());
+
+    if (contentElements.isEmpty()) {
+        debugLog(QString("Lexbor found no elements for selector: %1").arg(rule.content()));
+        return QString();
+    }
+
+    QString content = contentElements.first(); // Get the first matching element
+    debugLog(QString("Lexbor extracted content length: %1").arg(content.length()));
     return content;
 }
 
-QList<Chapter> ContentParser::parseChapterListSinglePage(const QString &html, const TocRule &rule, const QString &baseUrl)
+QString ContentParser::finishChapterContent(const QString &content, const ChapterRule &rule)
 {
-    QList<Chapter> chapters;
+    // Apply special processing for specific book sources
+    QString finished = applySpecialProcessing(content, rule);
+
+    finished = formatChapterContent(finished, rule);
+
+    debugLog(QString("Single page chapter content parsing completed, final length: %1 characters").arg(finished.length()));
+    return finished;
+}
 
+QList<Chapter> ContentParser::parseChapterListSinglePage(const QString &html, const TocRule &rule, const QString &baseUrl)
+{
     QString cleanHtml = preprocessHtml(html);
 
     // === USE LEXBOR HTML PARSER FOR REAL CSS SELECTOR SUPPORT ===
-    LexborHtmlParser lexborParser;
-    if (!lexborParser.parseHtml(cleanHtml)) {
+    ParserPool::Lease lexborParser = ParserPool::acquire();
+    if (!lexborParser->parseHtml(cleanHtml)) {
         debugLog("Failed to parse HTML with Lexbor, falling back to regex method");
         // Fallback to original regex method
         return parseChapterListWithRegex(cleanHtml, rule, baseUrl);
     }
 
+    return parseChapterListWithLexbor(*lexborParser, rule, baseUrl);
+}
+
+QList<Chapter> ContentParser::parseChapterListWithLexbor(LexborHtmlParser &parser, const TocRule &rule, const QString &baseUrl)
+{
+    QList<Chapter> chapters;
+
     // Use real CSS selector to get chapter elements
-    QList<LexborHtmlParser::ElementInfo> chapterElements = lexborParser.selectElementsWithInfo(rule.item());
+    QList<LexborHtmlParser::ElementInfo> chapterElements = parser.selectElementsWithInfo(rule.item());
 
     debugLog(QString("Found %1 chapter elements using Lexbor").arg(chapterElements.size()));
 
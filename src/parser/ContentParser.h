@@ -12,6 +12,8 @@
 #include "RuleManager.h"
 #include "LexborHtmlParser.h"
 
+class ParsedDocument;
+
 /**
  * @brief HTML Content Parser Class
  * Responsible for extracting search results, chapter lists, chapter content, etc. from HTML pages based on book source rules
@@ -51,26 +53,47 @@ public:
     // Search result parsing
     QList<SearchResult> parseSearchResults(const QString &html, const BookSource &source, const QString &baseUrl = QString());
     QList<SearchResult> parseSearchResults(const QString &html, const SearchRule &rule, int sourceId, const QString &baseUrl = QString());
+    QList<SearchResult> parseSearchResults(const QByteArray &html, const QByteArray &charset, const BookSource &source, const QString &baseUrl = QString());
 
     // Book details parsing
     Book parseBookDetails(const QString &html, const BookSource &source, const QString &bookUrl = QString());
     Book parseBookDetails(const QString &html, const BookRule &rule, const QString &bookUrl = QString());
+    // Every field from one already parsed page; empty fields are not retried with regex
+    Book parseBookDetails(ParsedDocument &document, const BookRule &rule, const QString &bookUrl = QString());
 
     // Chapter list parsing
     QList<Chapter> parseChapterList(const QString &html, const BookSource &source, const QString &baseUrl = QString());
     QList<Chapter> parseChapterList(const QString &html, const TocRule &rule, const QString &baseUrl = QString());
+    QList<Chapter> parseChapterList(const QByteArray &html, const QByteArray &charset, const BookSource &source, const QString &baseUrl = QString());
+    QList<Chapter> parseChapterList(const QByteArray &html, const QByteArray &charset, const TocRule &rule, const QString &baseUrl = QString());
+    // Document already parsed, e.g. streamed by HtmlStreamSink during the download (single-page TOCs)
+    QList<Chapter> parseChapterList(LexborHtmlParser &parsedDocument, const TocRule &rule, const QString &baseUrl = QString());
+    // One TOC link found without a document (TocStreamSink); false if it is not a chapter
+    bool tocLinkToChapter(const QString &title, const QString &href, const QString &baseUrl, Chapter *chapter);
 
     // Chapter content parsing
     QString parseChapterContent(const QString &html, const BookSource &source);
     QString parseChapterContent(const QString &html, const ChapterRule &rule);
+    QString parseChapterContent(const QByteArray &html, const QByteArray &charset, const ChapterRule &rule);
 
     // Pagination handling
     QStringList parseNextPageUrls(const QString &html, const QString &nextPageSelector, const QString &baseUrl = QString());
     QString parseNextPageUrl(const QString &html, const QString &nextPageSelector, const QString &baseUrl = QString());
+    QStringList parseNextPageUrls(ParsedDocument &document, const QString &nextPageSelector, const QString &baseUrl = QString());
     QList<Chapter> parseChapterListWithPagination(const QString &html, const TocRule &rule, const QString &baseUrl);
+    // Chapters of one TOC page and, if pageUrls is given, the other TOC pages it links to, from a single parse
+    QList<Chapter> parseTocPage(const QByteArray &html, const QByteArray &charset, const TocRule &rule,
+                                const QString &pageUrl, QStringList *pageUrls);
     QList<Chapter> parseChapterListSinglePage(const QString &html, const TocRule &rule, const QString &baseUrl);
     QString parseChapterContentWithPagination(const QString &html, const ChapterRule &rule, const QString &baseUrl);
     QString parseChapterContentSinglePage(const QString &html, const ChapterRule &rule);
+    // Content of one page and, if nextPageUrl is given, its next-page link, from a single parse
+    QString parseChapterPage(const QString &html, const ChapterRule &rule, const QString &pageUrl, QString *nextPageUrl);
+    // Sub-pages named like the chapter plus "_N": ".../123_2.html" is page 2 of ".../123.html"
+    static QString chapterSubPageUrl(const QString &chapterUrl, int pageNumber);
+    static int chapterSubPageNumber(const QString &chapterUrl, const QString &pageUrl);     // 0 if not a sub-page
+    // Joins page contents in order, dropping lines a page repeats from the end of the previous one
+    static QString stitchChapterPages(const QStringList &pages);
 
     // Generic content extraction
     ParseResult extractContent(const QString &html, const QString &selector, ContentType type = TEXT);
@@ -110,16 +133,26 @@ private:
 
     // Improved Lexbor parsing method
     QList<SearchResult> parseSearchResultsWithLexbor(LexborHtmlParser& parser, const SearchRule& rule, int sourceId, const QString& baseUrl);
+    QList<SearchResult> parseSearchResultsWithRegex(const QString &html, const SearchRule &rule, int sourceId, const QString &baseUrl);
+    QList<Chapter> parseChapterListWithLexbor(LexborHtmlParser& parser, const TocRule& rule, const QString& baseUrl);
+    QString extractChapterContentWithLexbor(LexborHtmlParser& parser, const ChapterRule& rule);
+    QString finishChapterContent(const QString &content, const ChapterRule &rule);
+    QString extractField(ParsedDocument &document, const QString &selector, ContentType type);
+    QStringList parseTocPageUrls(ParsedDocument &document, const TocRule &rule, const QString &pageUrl);
     QStringList extractMultipleByRegex(const QString &html, const QRegularExpression &regex, ContentType type);
     QString extractAttributeFromMatch(const QRegularExpressionMatch &match, const QString &attrName);
     
     // Selector handling
     QRegularExpression selectorToRegex(const QString &selector);
     ContentType detectContentType(const QString &selector);
+    ContentType coverContentType(const QString &selector);
 
     // Chapter filtering
     bool isNonChapterLink(const QString &title, const QString &url);
 
+    static constexpr int MAX_SEAM_LINES = 3;    // Lines compared where two chapter pages meet
+    static constexpr int MIN_SEAM_CHARS = 20;   // A one-line seam must be a paragraph this long, not "......" or a short reply
+
     // Fallback chapter parsing method
     QList<Chapter> parseChapterListWithRegex(const QString &html, const TocRule &rule, const QString &baseUrl);
     QString preprocessHtml(const QString &html);
@@ -132,8 +165,6 @@ private:
     
     // Text processing
     QString cleanInvisibleChars(const QString &text);
-    QString unescapeHtml(const QString &html);
-    QString normalizeWhitespace(const QString &text);
     QString removeDuplicateTitle(const QString &content, const QString &title);
     
     // URL processing
@@ -151,7 +182,6 @@ private:
 
     // Precompiled regular expressions
     QRegularExpression m_htmlTagRegex;      // HTML tag regex
-    QRegularExpression m_whitespaceRegex;   // Whitespace regex
     QRegularExpression m_entityRegex;       // HTML entity regex
     QRegularExpression m_invisibleRegex;    // Invisible character regex
 
@@ -0,0 +1,124 @@
+#include "HtmlSanitizer.h"
+#include <QByteArray>
+
+namespace {
+
+// HTML's own whitespace: full-width (U+3000) and non-breaking spaces are text, not layout
+bool isAsciiSpace(ushort ch)
+{
+    return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == '\f' || ch == '\v';
+}
+
+// ASCII-case-insensitive match of a lowercase literal at p
+bool matchesAt(const QChar *p, const QChar *end, const char *literal)
+{
+    for (; *literal; ++literal, ++p) {
+        if (p >= end) {
+            return false;
+        }
+        ushort ch = p->unicode();
+        if (ch >= 'A' && ch <= 'Z') {
+            ch += 'a' - 'A';
+        }
+        if (ch != static_cast<uchar>(*literal)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// First occurrence of a lowercase literal at or after p, or null
+const QChar *findLiteral(const QChar *p, const QChar *end, const char *literal)
+{
+    const ushort first = static_cast<uchar>(literal[0]);
+    for (; p < end; ++p) {
+        ushort ch = p->unicode();
+        if (ch >= 'A' && ch <= 'Z') {
+            ch += 'a' - 'A';
+        }
+        if (ch == first && matchesAt(p, end, literal)) {
+            return p;
+        }
+    }
+    return nullptr;
+}
+
+// End of a <script ...>...</script> style block starting at p, or null if unterminated
+const QChar *skipRawTextBlock(const QChar *p, const QChar *end, const char *openTag, const char *closeTag)
+{
+    if (!matchesAt(p, end, openTag)) {
+        return nullptr;
+    }
+    const QChar *tagEnd = p;
+    while (tagEnd < end && *tagEnd != QLatin1Char('>')) {
+        ++tagEnd;
+    }
+    if (tagEnd == end) {
+        return nullptr;
+    }
+    const QChar *close = findLiteral(tagEnd + 1, end, closeTag);
+    return close ? close + qstrlen(closeTag) : nullptr;
+}
+
+} // namespace
+
+QString HtmlSanitizer::sanitize(const QString &html, Options options)
+{
+    if (html.isEmpty()) {
+        return html;
+    }
+
+    QString out;
+    out.resize(html.size());     // Output never grows
+    QChar *dst = out.data();
+
+    const QChar *p = html.constData();
+    const QChar *end = p + html.size();
+    bool pendingSpace = false;
+
+    while (p < end) {
+        const ushort ch = p->unicode();
+
+        if ((options & StripControlChars) && isControlChar(ch)) {
+            ++p;
+            continue;
+        }
+
+        if (ch == '<') {
+            const QChar *skipTo = nullptr;
+            if ((options & StripComments) && matchesAt(p, end, "<!--")) {
+                const QChar *close = findLiteral(p + 4, end, "-->");
+                skipTo = close ? close + 3 : nullptr;
+            }
+            if (!skipTo && (options & StripScripts)) {
+                skipTo = skipRawTextBlock(p, end, "<script", "</script>");
+                if (!skipTo) {
+                    skipTo = skipRawTextBlock(p, end, "<style", "</style>");
+                }
+            }
+            if (skipTo) {
+                p = skipTo;
+                continue;
+            }
+        }
+
+        if ((options & CollapseWhitespace) && isAsciiSpace(p->unicode())) {
+            pendingSpace = true;
+            ++p;
+            continue;
+        }
+
+        if (pendingSpace) {
+            *dst++ = QLatin1Char(' ');
+            pendingSpace = false;
+        }
+        *dst++ = *p++;
+    }
+
+    if (pendingSpace) {
+        *dst++ = QLatin1Char(' ');
+    }
+
+    out.truncate(static_cast<int>(dst - out.constData()));
+    return out;
+}
@@ -0,0 +1,38 @@
+#ifndef HTMLSANITIZER_H
+#define HTMLSANITIZER_H
+
+#include <QString>
+#include <QFlags>
+
+/**
+ * @brief Single-pass cleanup of HTML text before it is parsed
+ *
+ * Replaces the chain of whole-document regex passes in ContentParser: control
+ * characters, comments, <script>/<style> blocks and whitespace runs are all
+ * handled in one forward scan that writes into one preallocated string.
+ * Unlike the regex chain's "\s+", only ASCII whitespace is collapsed: the
+ * full-width spaces (U+3000) that indent Chinese paragraphs and non-breaking
+ * spaces (U+00A0) survive. Unterminated comments and blocks are kept.
+ */
+class HtmlSanitizer
+{
+public:
+    enum Option {
+        StripControlChars  = 0x1,   // C0 controls except \t \n \r, and DEL
+        StripComments      = 0x2,   // <!-- ... -->
+        StripScripts       = 0x4,   // <script>...</script> and <style>...</style>
+        CollapseWhitespace = 0x8    // Every ASCII whitespace run becomes one space
+    };
+    Q_DECLARE_FLAGS(Options, Option)
+
+    static QString sanitize(const QString &html, Options options);
+
+    static bool isControlChar(ushort ch)
+    {
+        return ch <= 0x08 || ch == 0x0B || ch == 0x0C || (ch >= 0x0E && ch <= 0x1F) || ch == 0x7F;
+    }
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(HtmlSanitizer::Options)
+
+#endif // HTMLSANITIZER_H
@@ -0,0 +1,106 @@
+#include "HtmlStreamSink.h"
+#include "../network/CharsetDetector.h"
+#include <QDebug>
+
+namespace {
+// CharsetDetector::fromMetaTags looks at the same window
+const int SNIFF_BYTES = 4096;
+}
+
+HtmlStreamSink::HtmlStreamSink()
+    : m_parsing(false)
+    , m_failed(false)
+    , m_complete(false)
+    , m_bytesReceived(0)
+{
+}
+
+void HtmlStreamSink::begin(const QByteArray &contentType)
+{
+    // A retried attempt starts over with a fresh document
+    m_contentType = contentType;
+    m_charset.clear();
+    m_sniffBuffer.clear();
+    m_parsing = false;
+    m_failed = false;
+    m_complete = false;
+    m_bytesReceived = 0;
+    m_error.clear();
+    m_parser.clear();
+
+    const QByteArray declared = CharsetDetector::fromContentType(contentType);
+    if (!declared.isEmpty()) {
+        startParse(CharsetDetector::normalize(declared));
+    }
+}
+
+void HtmlStreamSink::write(const char *data, int size)
+{
+    if (m_failed) {
+        return;
+    }
+    m_bytesReceived += size;
+
+    if (m_parsing) {
+        if (!m_parser.parseChunk(data, static_cast<size_t>(size))) {
+            m_failed = true;
+            m_error = m_parser.getLastError();
+        }
+        return;
+    }
+
+    m_sniffBuffer.append(data, size);
+    if (m_sniffBuffer.size() >= SNIFF_BYTES) {
+        startParse(CharsetDetector::detect(m_sniffBuffer, m_contentType));
+    }
+}
+
+void HtmlStreamSink::end(bool complete)
+{
+    if (!complete) {
+        m_failed = true;
+        if (m_error.isEmpty()) {
+            m_error = "Transfer incomplete";
+        }
+    }
+
+    if (!m_failed && !m_parsing) {
+        // Short page: everything is still in the sniff buffer
+        startParse(CharsetDetector::detect(m_sniffBuffer, m_contentType));
+    }
+
+    if (m_failed) {
+        m_parser.clear();
+        m_sniffBuffer.clear();
+        return;
+    }
+
+    if (!m_parser.endChunkedParse()) {
+        m_failed = true;
+        m_error = m_parser.getLastError();
+        return;
+    }
+
+    m_complete = true;
+    qDebug() << "HtmlStreamSink: Parsed" << m_bytesReceived << "bytes as" << m_charset << "while downloading";
+}
+
+bool HtmlStreamSink::startParse(const QByteArray &charset)
+{
+    m_charset = charset;
+    m_parsing = m_parser.beginChunkedParse(charset);
+    if (!m_parsing) {
+        m_failed = true;
+        m_error = m_parser.getLastError();
+        return false;
+    }
+
+    const QByteArray buffered = m_sniffBuffer;
+    m_sniffBuffer = QByteArray();
+    if (!buffered.isEmpty() && !m_parser.parseChunk(buffered.constData(), static_cast<size_t>(buffered.size()))) {
+        m_failed = true;
+        m_error = m_parser.getLastError();
+        return false;
+    }
+    return true;
+}
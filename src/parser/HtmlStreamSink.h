@@ -0,0 +1,50 @@
+#ifndef HTMLSTREAMSINK_H
+#define HTMLSTREAMSINK_H
+
+#include <QByteArray>
+#include <QString>
+#include "../network/BodySink.h"
+#include "LexborHtmlParser.h"
+
+/**
+ * @brief BodySink that parses HTML with Lexbor while the response is still downloading
+ *
+ * The charset comes from the Content-Type header; without one, the first 4 KB
+ * are held back for BOM and <meta> sniffing before parsing starts. Fed on the
+ * network thread; read parser() only after the response callback reported
+ * success and isComplete() is true.
+ */
+class HtmlStreamSink : public BodySink
+{
+public:
+    HtmlStreamSink();
+
+    void begin(const QByteArray &contentType) override;
+    void write(const char *data, int size) override;
+    void end(bool complete) override;
+
+    /**
+     * @brief The whole body arrived and was parsed into a document
+     */
+    bool isComplete() const { return m_complete; }
+
+    LexborHtmlParser &parser() { return m_parser; }
+    QByteArray charset() const { return m_charset; }
+    qint64 bytesReceived() const { return m_bytesReceived; }
+    QString errorString() const { return m_error; }
+
+private:
+    bool startParse(const QByteArray &charset);
+
+    LexborHtmlParser m_parser;
+    QByteArray m_contentType;
+    QByteArray m_charset;
+    QByteArray m_sniffBuffer;       // Body start kept until the charset is known
+    bool m_parsing;
+    bool m_failed;
+    bool m_complete;
+    qint64 m_bytesReceived;
+    QString m_error;
+};
+
+#endif // HTMLSTREAMSINK_H
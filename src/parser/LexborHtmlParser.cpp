@@ -1,12 +1,16 @@
 #include "LexborHtmlParser.h"
+#include "SelectorCache.h"
+#include "ChunkTranscoder.h"
+#include "../network/CharsetDetector.h"
 #include <QTextCodec>
 
 // Simplified version: use basic HTML parsing without CSS selectors for now
 
 LexborHtmlParser::LexborHtmlParser()
     : m_document(nullptr)
-    , m_cssParser(nullptr)
     , m_selectors(nullptr)
+    , m_chunked(false)
+    , m_parsedBytes(0)
 {
     initializeLexbor();
 }
@@ -25,27 +29,14 @@ bool LexborHtmlParser::initializeLexbor()
         return false;
     }
 
-    // Initialize CSS parser
-    m_cssParser = lxb_css_parser_create();
-    if (!m_cssParser) {
-        m_lastError = "Failed to create CSS parser";
-        return false;
-    }
-
-    lxb_status_t status = lxb_css_parser_init(m_cssParser, nullptr);
-    if (status != LXB_STATUS_OK) {
-        m_lastError = "Failed to initialize CSS parser";
-        return false;
-    }
-
-    // Initialize selectors
+    // Selector strings are compiled by SelectorCache; only the matcher is per parser
     m_selectors = lxb_selectors_create();
     if (!m_selectors) {
         m_lastError = "Failed to create selectors";
         return false;
     }
 
-    status = lxb_selectors_init(m_selectors);
+    lxb_status_t status = lxb_selectors_init(m_selectors);
     if (status != LXB_STATUS_OK) {
         m_lastError = "Failed to initialize selectors";
         return false;
@@ -61,11 +52,6 @@ void LexborHtmlParser::cleanupLexbor()
         m_selectors = nullptr;
     }
 
-    if (m_cssParser) {
-        lxb_css_parser_destroy(m_cssParser, true);
-        m_cssParser = nullptr;
-    }
-
     if (m_document) {
         lxb_html_document_destroy(m_document);
         m_document = nullptr;
@@ -74,38 +60,152 @@ void LexborHtmlParser::cleanupLexbor()
 
 bool LexborHtmlParser::parseHtml(const QString& html)
 {
-    if (!m_document) {
-        m_lastError = "HTML document not initialized";
-        return false;
+    // Convert QString to UTF-8 byte array
+    QByteArray htmlBytes = html.toUtf8();
+    return parseUtf8(htmlBytes.constData(), htmlBytes.size());
+}
+
+bool LexborHtmlParser::parseHtml(const QByteArray& html, const QByteArray& charset)
+{
+    const bool isUtf8 = charset.isEmpty()
+        || charset.compare("utf-8", Qt::CaseInsensitive) == 0
+        || charset.compare("utf8", Qt::CaseInsensitive) == 0;
+
+    if (isUtf8) {
+        return parseUtf8(html.constData(), html.size());
     }
 
-    // Clear previous content
-    clear();
+    QByteArray utf8;
+    if (!transcodeToUtf8(html, charset, &utf8)) {
+        qDebug() << "LexborHtmlParser: Unsupported charset" << charset << ", parsing bytes as UTF-8";
+        return parseUtf8(html.constData(), html.size());
+    }
 
-    // Recreate document
-    m_document = lxb_html_document_create();
-    if (!m_document) {
-        m_lastError = "Failed to recreate HTML document";
+    return parseUtf8(utf8.constData(), utf8.size());
+}
+
+bool LexborHtmlParser::parseUtf8(const char* data, size_t size)
+{
+    // Reuse the previous document's memory for the new tree
+    if (!resetDocument()) {
         return false;
     }
+    m_parsedBytes = static_cast<qint64>(size);
 
-    // Convert QString to UTF-8 byte array
-    QByteArray htmlBytes = html.toUtf8();
-    const lxb_char_t* htmlData = reinterpret_cast<const lxb_char_t*>(htmlBytes.constData());
-    size_t htmlSize = htmlBytes.size();
+    const lxb_char_t* htmlData = reinterpret_cast<const lxb_char_t*>(data);
 
     // Parse HTML
-    lxb_status_t status = lxb_html_document_parse(m_document, htmlData, htmlSize);
+    lxb_status_t status = lxb_html_document_parse(m_document, htmlData, size);
     if (status != LXB_STATUS_OK) {
         m_lastError = QString("Failed to parse HTML, status: %1").arg(status);
         return false;
     }
 
     // Only output debug info for very small HTML fragments (likely problematic ones)
-    if (htmlSize < 300) {
-        qDebug() << "LexborHtmlParser: Parsed small HTML fragment, size:" << htmlSize;
+    if (size < 300) {
+        qDebug() << "LexborHtmlParser: Parsed small HTML fragment, size:" << size;
+    }
+
+    return true;
+}
+
+bool LexborHtmlParser::transcodeToUtf8(const QByteArray& input, const QByteArray& charset, QByteArray* output)
+{
+    // Heap-allocated: the code point and byte buffers are too large for a worker thread's stack
+    std::unique_ptr<ChunkTranscoder> transcoder(new ChunkTranscoder());
+    if (!transcoder->init(charset)) {
+        return false;
+    }
+
+    output->clear();
+    // CJK double-byte text grows by half when re-encoded as UTF-8
+    output->reserve(input.size() + input.size() / 2);
+
+    transcoder->feed(input.constData(), static_cast<size_t>(input.size()), output);
+    transcoder->finish(output);
+    return true;
+}
+
+bool LexborHtmlParser::beginChunkedParse(const QByteArray& charset)
+{
+    if (!resetDocument()) {
+        return false;
+    }
+
+    m_transcoder.reset();
+    if (!CharsetDetector::isUtf8(charset)) {
+        m_transcoder.reset(new ChunkTranscoder());
+        if (!m_transcoder->init(charset)) {
+            qDebug() << "LexborHtmlParser: Unsupported charset" << charset << ", parsing chunks as UTF-8";
+            m_transcoder.reset();
+        }
+    }
+
+    lxb_status_t status = lxb_html_document_parse_chunk_begin(m_document);
+    if (status != LXB_STATUS_OK) {
+        m_lastError = QString("Failed to begin chunked parse, status: %1").arg(status);
+        return false;
+    }
+
+    m_chunked = true;
+    return true;
+}
+
+bool LexborHtmlParser::parseChunk(const char* data, size_t size)
+{
+    if (!m_chunked) {
+        m_lastError = "Chunked parse not started";
+        return false;
+    }
+    if (size == 0) {
+        return true;
     }
+    m_parsedBytes += static_cast<qint64>(size);
 
+    const lxb_char_t* chunk = reinterpret_cast<const lxb_char_t*>(data);
+    size_t chunkSize = size;
+    if (m_transcoder) {
+        m_chunkBuffer.clear();
+        m_transcoder->feed(data, size, &m_chunkBuffer);
+        chunk = reinterpret_cast<const lxb_char_t*>(m_chunkBuffer.constData());
+        chunkSize = static_cast<size_t>(m_chunkBuffer.size());
+    }
+
+    lxb_status_t status = lxb_html_document_parse_chunk(m_document, chunk, chunkSize);
+    if (status != LXB_STATUS_OK) {
+        m_lastError = QString("Failed to parse HTML chunk, status: %1").arg(status);
+        m_chunked = false;
+        return false;
+    }
+    return true;
+}
+
+bool LexborHtmlParser::endChunkedParse()
+{
+    if (!m_chunked) {
+        m_lastError = "Chunked parse not started";
+        return false;
+    }
+    m_chunked = false;
+
+    if (m_transcoder) {
+        m_chunkBuffer.clear();
+        m_transcoder->finish(&m_chunkBuffer);
+        m_transcoder.reset();
+        if (!m_chunkBuffer.isEmpty()
+            && lxb_html_document_parse_chunk(m_document, reinterpret_cast<const lxb_char_t*>(m_chunkBuffer.constData()),
+                                             static_cast<size_t>(m_chunkBuffer.size())) != LXB_STATUS_OK) {
+            m_lastError = "Failed to parse final HTML chunk";
+            return false;
+        }
+    }
+    m_chunkBuffer = QByteArray();
+
+    lxb_status_t status = lxb_html_document_parse_chunk_end(m_document);
+    if (status != LXB_STATUS_OK) {
+        m_lastError = QString("Failed to end chunked parse, status: %1").arg(status);
+        return false;
+    }
     return true;
 }
 
@@ -132,16 +232,14 @@ QList<QString> LexborHtmlParser::selectElements(const QString& selector)
 {
     QList<QString> results;
 
-    if (!m_document || !m_cssParser || !m_selectors) {
+    if (!m_document || !m_selectors) {
         m_lastError = "Parser not properly initialized";
         return results;
     }
 
-    // Parse CSS selector
-    QByteArray selectorBytes = selector.toUtf8();
-    lxb_css_selector_list_t* selectorList = lxb_css_selectors_parse(m_cssParser,
-        reinterpret_cast<const lxb_char_t*>(selectorBytes.constData()),
-        selectorBytes.length());
+    // Compiled once per distinct selector and shared by all parsers
+    CompiledSelectorPtr compiled = SelectorCache::instance()->get(selector);
+    lxb_css_selector_list_t* selectorList = compiled ? compiled->list() : nullptr;
 
     if (!selectorList) {
         qDebug() << "LexborHtmlParser: Failed to parse CSS selector:" << selector;
@@ -164,9 +262,6 @@ QList<QString> LexborHtmlParser::selectElements(const QString& selector)
         m_lastError = "Selector search failed";
     }
 
-    // Cleanup
-    lxb_css_selector_list_destroy_memory(selectorList);
-
     // Only output debug info if no results found and HTML is small (likely problematic)
     if (results.isEmpty()) {
         // Get the HTML content for debugging only if it's small
@@ -197,16 +292,14 @@ QList<LexborHtmlParser::ElementInfo> LexborHtmlParser::selectElementsWithInfo(co
 {
     QList<ElementInfo> results;
 
-    if (!m_document || !m_cssParser || !m_selectors) {
+    if (!m_document || !m_selectors) {
         m_lastError = "Parser not properly initialized";
         return results;
     }
 
-    // Parse CSS selector
-    QByteArray selectorBytes = selector.toUtf8();
-    lxb_css_selector_list_t* selectorList = lxb_css_selectors_parse(m_cssParser,
-        reinterpret_cast<const lxb_char_t*>(selectorBytes.constData()),
-        selectorBytes.length());
+    // Compiled once per distinct selector and shared by all parsers
+    CompiledSelectorPtr compiled = SelectorCache::instance()->get(selector);
+    lxb_css_selector_list_t* selectorList = compiled ? compiled->list() : nullptr;
 
     if (!selectorList) {
         m_lastError = "Failed to parse CSS selector";
@@ -240,15 +333,12 @@ QList<LexborHtmlParser::ElementInfo> LexborHtmlParser::selectElementsWithInfo(co
             return LXB_STATUS_OK;
         }, &results);
 
-    // Cleanup
-    lxb_css_selector_list_destroy_memory(selectorList);
-
     return results;
 }
 
 QString LexborHtmlParser::selectTextFromElement(lxb_dom_node_t* element, const QString& selector)
 {
-    if (!element || !m_cssParser || !m_selectors) {
+    if (!element || !m_selectors) {
         return QString();
     }
 
@@ -264,11 +354,9 @@ QString LexborHtmlParser::selectTextFromElement(lxb_dom_node_t* element, const Q
         }
     }
 
-    // Parse CSS selector
-    QByteArray selectorBytes = cssSelector.toUtf8();
-    lxb_css_selector_list_t* selectorList = lxb_css_selectors_parse(m_cssParser,
-        reinterpret_cast<const lxb_char_t*>(selectorBytes.constData()),
-        selectorBytes.length());
+    // Compiled once per distinct selector and shared by all parsers
+    CompiledSelectorPtr compiled = SelectorCache::instance()->get(cssSelector);
+    lxb_css_selector_list_t* selectorList = compiled ? compiled->list() : nullptr;
 
     if (!selectorList) {
         return QString();
@@ -294,9 +382,6 @@ QString LexborHtmlParser::selectTextFromElement(lxb_dom_node_t* element, const Q
             return LXB_STATUS_OK;
         }, &result);
 
-    // Cleanup
-    lxb_css_selector_list_destroy_memory(selectorList);
-
     // Apply simple JavaScript rule processing for common patterns
     if (hasJsRule && !result.isEmpty()) {
         // Handle common pattern: r=r.replace('作者：', '');
@@ -311,15 +396,13 @@ QString LexborHtmlParser::selectTextFromElement(lxb_dom_node_t* element, const Q
 
 QString LexborHtmlParser::selectAttributeFromElement(lxb_dom_node_t* element, const QString& selector, const QString& attribute)
 {
-    if (!element || !m_cssParser || !m_selectors) {
+    if (!element || !m_selectors) {
         return QString();
     }
 
-    // Parse CSS selector
-    QByteArray selectorBytes = selector.toUtf8();
-    lxb_css_selector_list_t* selectorList = lxb_css_selectors_parse(m_cssParser,
-        reinterpret_cast<const lxb_char_t*>(selectorBytes.constData()),
-        selectorBytes.length());
+    // Compiled once per distinct selector and shared by all parsers
+    CompiledSelectorPtr compiled = SelectorCache::instance()->get(selector);
+    lxb_css_selector_list_t* selectorList = compiled ? compiled->list() : nullptr;
 
     if (!selectorList) {
         return QString();
@@ -352,9 +435,6 @@ QString LexborHtmlParser::selectAttributeFromElement(lxb_dom_node_t* element, co
             return LXB_STATUS_OK;
         }, &QPair<QString*, QByteArray*>(&result, &attrBytes));
 
-    // Cleanup
-    lxb_css_selector_list_destroy_memory(selectorList);
-
     return result;
 }
 
@@ -388,16 +468,14 @@ static lxb_status_t selectAttributeCallback(lxb_dom_node_t *node, lxb_css_select
 
 QString LexborHtmlParser::selectAttribute(const QString& selector, const QString& attribute)
 {
-    if (!m_document || !m_cssParser || !m_selectors) {
+    if (!m_document || !m_selectors) {
         m_lastError = "Parser not properly initialized";
         return QString();
     }
 
-    // Parse CSS selector
-    QByteArray selectorBytes = selector.toUtf8();
-    lxb_css_selector_list_t* selectorList = lxb_css_selectors_parse(m_cssParser,
-        reinterpret_cast<const lxb_char_t*>(selectorBytes.constData()),
-        selectorBytes.length());
+    // Compiled once per distinct selector and shared by all parsers
+    CompiledSelectorPtr compiled = SelectorCache::instance()->get(selector);
+    lxb_css_selector_list_t* selectorList = compiled ? compiled->list() : nullptr;
 
     if (!selectorList) {
         qDebug() << "LexborHtmlParser: Failed to parse CSS selector:" << selector;
@@ -426,9 +504,6 @@ QString LexborHtmlParser::selectAttribute(const QString& selector, const QString
         m_lastError = "Selector search failed";
     }
 
-    // Cleanup
-    lxb_css_selector_list_destroy_memory(selectorList);
-
     // Only output debug info if result is empty (indicating a problem)
     if (result.isEmpty()) {
         qDebug() << "LexborHtmlParser: Found empty attribute value for selector:" << selector << "attribute:" << attribute;
@@ -437,12 +512,119 @@ QString LexborHtmlParser::selectAttribute(const QString& selector, const QString
     return result;
 }
 
+QList<lxb_dom_node_t*> LexborHtmlParser::selectNodes(const QString& selector)
+{
+    QList<lxb_dom_node_t*> nodes;
+
+    if (!m_document || !m_selectors) {
+        m_lastError = "Parser not properly initialized";
+        return nodes;
+    }
+
+    // Compiled once per distinct selector and shared by all parsers
+    CompiledSelectorPtr compiled = SelectorCache::instance()->get(selector);
+    lxb_css_selector_list_t* selectorList = compiled ? compiled->list() : nullptr;
+
+    if (!selectorList) {
+        qDebug() << "LexborHtmlParser: Failed to parse CSS selector:" << selector;
+        m_lastError = "Failed to parse CSS selector";
+        return nodes;
+    }
+
+    // Search from the document node: meta tags live in <head>
+    lxb_dom_node_t* root = &lxb_dom_interface_document(m_document)->node;
+    lxb_status_t status = lxb_selectors_find(m_selectors, root, selectorList,
+        [](lxb_dom_node_t *node, lxb_css_selector_specificity_t spec, void *ctx) -> lxb_status_t {
+            if (node) {
+                static_cast<QList<lxb_dom_node_t*>*>(ctx)->append(node);
+            }
+            return LXB_STATUS_OK;
+        }, &nodes);
+
+    if (status != LXB_STATUS_OK) {
+        qDebug() << "LexborHtmlParser: Selector search failed with status:" << status;
+        m_lastError = "Selector search failed";
+    }
+
+    return nodes;
+}
+
+QString LexborHtmlParser::textOf(lxb_dom_node_t* node)
+{
+    if (!node) return QString();
+
+    size_t textLength = 0;
+    lxb_char_t* textData = lxb_dom_node_text_content(node, &textLength);
+    if (!textData || textLength == 0) {
+        return QString();
+    }
+
+    QString text = QString::fromUtf8(reinterpret_cast<const char*>(textData), static_cast<int>(textLength)).trimmed();
+    lxb_dom_document_destroy_text(node->owner_document, textData);
+    return text;
+}
+
+QString LexborHtmlParser::attributeOf(lxb_dom_node_t* node, const QString& attribute)
+{
+    if (!node || node->type != LXB_DOM_NODE_TYPE_ELEMENT) return QString();
+
+    QByteArray attrBytes = attribute.toUtf8();
+    size_t attrLength = 0;
+    const lxb_char_t* attrValue = lxb_dom_element_get_attribute(lxb_dom_interface_element(node),
+        reinterpret_cast<const lxb_char_t*>(attrBytes.constData()), attrBytes.length(), &attrLength);
+
+    if (!attrValue || attrLength == 0) {
+        return QString();
+    }
+    return QString::fromUtf8(reinterpret_cast<const char*>(attrValue), static_cast<int>(attrLength));
+}
+
+QString LexborHtmlParser::htmlOf(lxb_dom_node_t* node)
+{
+    if (!node) return QString();
+
+    lexbor_str_t str = {0};
+    if (lxb_html_serialize_tree_str(node, &str) != LXB_STATUS_OK || !str.data) {
+        return QString();
+    }
+
+    QString html = QString::fromUtf8(reinterpret_cast<const char*>(str.data), static_cast<int>(str.length));
+    lexbor_str_destroy(&str, node->owner_document->text, false);
+    return html;
+}
+
 void LexborHtmlParser::clear()
 {
-    if (m_document) {
+    m_chunked = false;
+    m_transcoder.reset();
+
+    if (!m_document) {
+        return;
+    }
+
+    // Cleaning keeps the document's memory arenas for the next parse; after
+    // an unusually large page they are released instead of kept per thread
+    if (m_parsedBytes > RETAINED_DOCUMENT_BYTES) {
         lxb_html_document_destroy(m_document);
         m_document = nullptr;
+    } else {
+        lxb_html_document_clean(m_document);
     }
+    m_parsedBytes = 0;
+}
+
+bool LexborHtmlParser::resetDocument()
+{
+    clear();
+
+    if (!m_document) {
+        m_document = lxb_html_document_create();
+        if (!m_document) {
+            m_lastError = "Failed to create HTML document";
+            return false;
+        }
+    }
+    return true;
 }
 
 QString LexborHtmlParser::extractElementContent(lxb_dom_node_t* node)
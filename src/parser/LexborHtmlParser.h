@@ -1,11 +1,16 @@
 #pragma once
 
 #include <QString>
+#include <QByteArray>
 #include <QList>
 #include <QDebug>
+#include <memory>
 #include <lexbor/html/html.h>
 #include <lexbor/css/css.h>
 #include <lexbor/selectors/selectors.h>
+#include <lexbor/encoding/encoding.h>
+
+struct ChunkTranscoder;
 
 /**
  * @brief Professional HTML parser based on Lexbor
@@ -37,6 +42,41 @@ public:
      */
     bool parseHtml(const QString& html);
 
+    /**
+     * @brief Parse raw HTML bytes in their original encoding
+     * @param html Undecoded response body
+     * @param charset Charset label of the body (empty or "utf-8" parses in place)
+     * @return Whether parsing was successful
+     *
+     * UTF-8 input is handed to Lexbor untouched; other encodings are transcoded
+     * straight to UTF-8 by Lexbor's encoding module, with no UTF-16 copy.
+     */
+    bool parseHtml(const QByteArray& html, const QByteArray& charset);
+
+    /**
+     * @brief Start an incremental parse fed piece by piece with parseChunk()
+     * @param charset Charset label of the bytes to come (empty or "utf-8" parses in place)
+     * @return Whether the document could be set up
+     *
+     * Lets parsing overlap the network transfer: each chunk is tokenized and
+     * added to the tree as it arrives, so the whole body is never held in memory.
+     * Legacy encodings are transcoded chunk by chunk; a multi-byte sequence may
+     * be split across chunks. Queries are valid only after endChunkedParse().
+     */
+    bool beginChunkedParse(const QByteArray& charset = QByteArray());
+
+    /**
+     * @brief Feed the next piece of the document
+     */
+    bool parseChunk(const char* data, size_t size);
+
+    /**
+     * @brief Flush the last chunk and finish the tree
+     */
+    bool endChunkedParse();
+
+    bool isParsingChunks() const { return m_chunked; }
+
     /**
      * @brief Query elements using CSS selector
      * @param selector CSS selector string
@@ -66,6 +106,28 @@ public:
      */
     QList<ElementInfo> selectElementsWithInfo(const QString& selector);
 
+    /**
+     * @brief Query matching nodes anywhere in the document, <head> included
+     * @param selector CSS selector string
+     * @return Matching nodes in document order, owned by the document
+     */
+    QList<lxb_dom_node_t*> selectNodes(const QString& selector);
+
+    /**
+     * @brief Trimmed text content of a node
+     */
+    static QString textOf(lxb_dom_node_t* node);
+
+    /**
+     * @brief Attribute value of an element node, empty if absent
+     */
+    static QString attributeOf(lxb_dom_node_t* node, const QString& attribute);
+
+    /**
+     * @brief Serialized HTML of a node, the node's own tag included
+     */
+    static QString htmlOf(lxb_dom_node_t* node);
+
     /**
      * @brief Query text content from a specific element using relative selector
      * @param element Parent element node
@@ -84,7 +146,7 @@ public:
     QString selectAttributeFromElement(lxb_dom_node_t* element, const QString& selector, const QString& attribute);
 
     /**
-     * @brief Clear resources
+     * @brief Drop the current tree, keeping the document's memory for reuse
      */
     void clear();
 
@@ -95,9 +157,30 @@ public:
 
 private:
     lxb_html_document_t* m_document;
-    lxb_css_parser_t* m_cssParser;
     lxb_selectors_t* m_selectors;
     QString m_lastError;
+    bool m_chunked;                                 // Between beginChunkedParse() and endChunkedParse()
+    qint64 m_parsedBytes;                           // Input size of the current tree
+    std::unique_ptr<ChunkTranscoder> m_transcoder;  // Legacy charset of the chunked parse, null for UTF-8
+    QByteArray m_chunkBuffer;                       // Transcoded chunk, reused between calls
+
+    // Trees from larger inputs do not keep their arenas after clear()
+    static const qint64 RETAINED_DOCUMENT_BYTES = 4 * 1024 * 1024;
+
+    /**
+     * @brief Clear the document, creating it if it was released
+     */
+    bool resetDocument();
+
+    /**
+     * @brief Parse a UTF-8 buffer into a fresh document
+     */
+    bool parseUtf8(const char* data, size_t size);
+
+    /**
+     * @brief Transcode bytes from a legacy charset to UTF-8 with Lexbor's encoding module
+     */
+    static bool transcodeToUtf8(const QByteArray& input, const QByteArray& charset, QByteArray* output);
 
     /**
      * @brief Initialize Lexbor components
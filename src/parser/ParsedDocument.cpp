@@ -0,0 +1,81 @@
+#include "ParsedDocument.h"
+
+ParsedDocument::ParsedDocument()
+    : m_parser(ParserPool::acquire())
+{
+}
+
+bool ParsedDocument::parse(const QString &html)
+{
+    m_matches.clear();
+    m_valid = !html.isEmpty() && m_parser->parseHtml(html);
+    return m_valid;
+}
+
+bool ParsedDocument::parse(const QByteArray &html, const QByteArray &charset)
+{
+    m_matches.clear();
+    m_valid = !html.isEmpty() && m_parser->parseHtml(html, charset);
+    return m_valid;
+}
+
+const QList<lxb_dom_node_t*> &ParsedDocument::matches(const QString &selector)
+{
+    auto it = m_matches.find(selector);
+    if (it == m_matches.end()) {
+        it = m_matches.insert(selector, m_valid ? m_parser->selectNodes(selector) : QList<lxb_dom_node_t*>());
+    }
+    return it.value();
+}
+
+QStringList ParsedDocument::texts(const QString &selector)
+{
+    QStringList results;
+    for (lxb_dom_node_t *node : matches(selector)) {
+        const QString text = LexborHtmlParser::textOf(node);
+        if (!text.isEmpty()) {
+            results.append(text);
+        }
+    }
+    return results;
+}
+
+QString ParsedDocument::text(const QString &selector)
+{
+    for (lxb_dom_node_t *node : matches(selector)) {
+        const QString text = LexborHtmlParser::textOf(node);
+        if (!text.isEmpty()) {
+            return text;
+        }
+    }
+    return QString();
+}
+
+QStringList ParsedDocument::attributes(const QString &selector, const QString &attribute)
+{
+    QStringList results;
+    for (lxb_dom_node_t *node : matches(selector)) {
+        const QString value = LexborHtmlParser::attributeOf(node, attribute);
+        if (!value.isEmpty()) {
+            results.append(value);
+        }
+    }
+    return results;
+}
+
+QString ParsedDocument::attribute(const QString &selector, const QString &attribute)
+{
+    for (lxb_dom_node_t *node : matches(selector)) {
+        const QString value = LexborHtmlParser::attributeOf(node, attribute);
+        if (!value.isEmpty()) {
+            return value;
+        }
+    }
+    return QString();
+}
+
+QString ParsedDocument::outerHtml(const QString &selector)
+{
+    const QList<lxb_dom_node_t*> &nodes = matches(selector);
+    return nodes.isEmpty() ? QString() : LexborHtmlParser::htmlOf(nodes.first());
+}
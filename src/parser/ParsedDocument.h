@@ -0,0 +1,72 @@
+#ifndef PARSEDDOCUMENT_H
+#define PARSEDDOCUMENT_H
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QList>
+#include "LexborHtmlParser.h"
+#include "ParserPool.h"
+
+/**
+ * @brief One HTML page parsed once with Lexbor, queried by every rule field
+ *
+ * ContentParser extracts all fields of a book page, or the content and the
+ * next-page link of a chapter page, from the same tree instead of parsing
+ * or regex-scanning the HTML per field. Selector matches are cached, so a
+ * field read as text and as href costs one query. Not thread-safe and not
+ * copyable; the nodes belong to the document, which must be destroyed on the
+ * thread that created it.
+ */
+class ParsedDocument
+{
+public:
+    ParsedDocument();
+
+    /**
+     * @brief Parse decoded HTML, replacing any previous document
+     */
+    bool parse(const QString &html);
+
+    /**
+     * @brief Parse raw bytes in their own charset, replacing any previous document
+     */
+    bool parse(const QByteArray &html, const QByteArray &charset);
+
+    bool isValid() const { return m_valid; }
+    QString errorString() const { return m_parser->getLastError(); }
+
+    /**
+     * @brief Trimmed text of every match, empty texts skipped
+     */
+    QStringList texts(const QString &selector);
+    QString text(const QString &selector);
+
+    /**
+     * @brief Attribute of every match that has it
+     */
+    QStringList attributes(const QString &selector, const QString &attribute);
+    QString attribute(const QString &selector, const QString &attribute);
+
+    /**
+     * @brief Serialized HTML of the first match
+     */
+    QString outerHtml(const QString &selector);
+
+    /**
+     * @brief Underlying parser, for element-relative queries
+     */
+    LexborHtmlParser &parser() { return *m_parser; }
+
+private:
+    Q_DISABLE_COPY(ParsedDocument)
+
+    const QList<lxb_dom_node_t*> &matches(const QString &selector);
+
+    ParserPool::Lease m_parser;     // Pooled per thread; the document is not shared across threads
+    bool m_valid = false;
+    QHash<QString, QList<lxb_dom_node_t*>> m_matches;     // Selector -> nodes, per document
+};
+
+#endif // PARSEDDOCUMENT_H
@@ -0,0 +1,78 @@
+#include "ParserPool.h"
+#include "ContentParser.h"
+#include <QThreadStorage>
+#include <QVector>
+
+namespace {
+
+struct ThreadParsers {
+    QVector<LexborHtmlParser*> idle;
+    ContentParser *contentParser = nullptr;
+
+    ~ThreadParsers()
+    {
+        qDeleteAll(idle);
+        delete contentParser;
+    }
+};
+
+// QThreadStorage deletes each thread's entry when that thread exits
+QThreadStorage<ThreadParsers*> &threadStorage()
+{
+    static QThreadStorage<ThreadParsers*> storage;
+    return storage;
+}
+
+ThreadParsers *currentThreadParsers()
+{
+    QThreadStorage<ThreadParsers*> &storage = threadStorage();
+    if (!storage.hasLocalData()) {
+        storage.setLocalData(new ThreadParsers());
+    }
+    return storage.localData();
+}
+
+} // namespace
+
+ParserPool::Lease::Lease(Lease &&other) noexcept
+    : m_parser(other.m_parser)
+{
+    other.m_parser = nullptr;
+}
+
+ParserPool::Lease::~Lease()
+{
+    if (m_parser) {
+        ParserPool::release(m_parser);
+    }
+}
+
+ParserPool::Lease ParserPool::acquire()
+{
+    ThreadParsers *parsers = currentThreadParsers();
+    if (!parsers->idle.isEmpty()) {
+        return Lease(parsers->idle.takeLast());
+    }
+    return Lease(new LexborHtmlParser());
+}
+
+void ParserPool::release(LexborHtmlParser *parser)
+{
+    ThreadParsers *parsers = currentThreadParsers();
+    if (parsers->idle.size() >= MAX_IDLE_PER_THREAD) {
+        delete parser;
+        return;
+    }
+    // Drops the tree now, so a pooled parser holds no page between uses
+    parser->clear();
+    parsers->idle.append(parser);
+}
+
+ContentParser *ParserPool::threadContentParser()
+{
+    ThreadParsers *parsers = currentThreadParsers();
+    if (!parsers->contentParser) {
+        parsers->contentParser = new ContentParser();
+    }
+    return parsers->contentParser;
+}
@@ -0,0 +1,60 @@
+#ifndef PARSERPOOL_H
+#define PARSERPOOL_H
+
+#include "LexborHtmlParser.h"
+
+class ContentParser;
+
+/**
+ * @brief Per-thread pool of reusable LexborHtmlParser instances
+ *
+ * A released parser keeps its document, whose memory arenas are cleaned
+ * rather than freed, and its selector engine, so the next page parsed on the
+ * same thread allocates almost nothing. Each thread has its own pool: no
+ * locking, and no parser ever crosses threads. Idle parsers are destroyed
+ * with their thread.
+ */
+class ParserPool
+{
+public:
+    /**
+     * @brief A pooled parser, returned to the calling thread's pool on destruction
+     *
+     * Must be destroyed on the thread that acquired it.
+     */
+    class Lease
+    {
+    public:
+        Lease(Lease &&other) noexcept;
+        ~Lease();
+
+        LexborHtmlParser *get() const { return m_parser; }
+        LexborHtmlParser *operator->() const { return m_parser; }
+        LexborHtmlParser &operator*() const { return *m_parser; }
+
+    private:
+        friend class ParserPool;
+        explicit Lease(LexborHtmlParser *parser) : m_parser(parser) {}
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+        Lease &operator=(Lease &&) = delete;
+
+        LexborHtmlParser *m_parser;
+    };
+
+    static Lease acquire();
+
+    /**
+     * @brief The calling thread's ContentParser, created on first use
+     *
+     * For pool threads, which used to build a ContentParser per chapter.
+     */
+    static ContentParser *threadContentParser();
+
+private:
+    static const int MAX_IDLE_PER_THREAD = 4;   // Nested parses on one thread rarely exceed two
+
+    static void release(LexborHtmlParser *parser);
+};
+
+#endif // PARSERPOOL_H
@@ -0,0 +1,88 @@
+#include "SelectorCache.h"
+#include <QReadLocker>
+#include <QWriteLocker>
+#include <QDebug>
+
+CompiledSelector::CompiledSelector(const QString &source, lxb_css_selector_list_t *list)
+    : m_source(source)
+    , m_list(list)
+{
+}
+
+CompiledSelector::~CompiledSelector()
+{
+    if (m_list) {
+        lxb_css_selector_list_destroy_memory(m_list);
+    }
+}
+
+SelectorCache *SelectorCache::instance()
+{
+    static SelectorCache cache;
+    return &cache;
+}
+
+SelectorCache::SelectorCache()
+    : m_cssParser(lxb_css_parser_create())
+{
+    if (m_cssParser && lxb_css_parser_init(m_cssParser, nullptr) != LXB_STATUS_OK) {
+        lxb_css_parser_destroy(m_cssParser, true);
+        m_cssParser = nullptr;
+    }
+    if (!m_cssParser) {
+        qWarning() << "SelectorCache: Failed to create CSS parser";
+    }
+}
+
+SelectorCache::~SelectorCache()
+{
+    m_selectors.clear();
+    if (m_cssParser) {
+        lxb_css_parser_destroy(m_cssParser, true);
+    }
+}
+
+CompiledSelectorPtr SelectorCache::get(const QString &selector)
+{
+    if (selector.isEmpty()) {
+        return nullptr;
+    }
+
+    {
+        QReadLocker locker(&m_lock);
+        auto it = m_selectors.constFind(selector);
+        if (it != m_selectors.constEnd()) {
+            return it.value();
+        }
+    }
+
+    QWriteLocker locker(&m_lock);
+    auto it = m_selectors.constFind(selector);
+    if (it != m_selectors.constEnd()) {
+        return it.value();      // Another thread compiled it meanwhile
+    }
+    if (!m_cssParser) {
+        return nullptr;
+    }
+
+    // Each parsed list gets its own memory, so it outlives this parser run
+    const QByteArray selectorBytes = selector.toUtf8();
+    lxb_css_selector_list_t *list = lxb_css_selectors_parse(m_cssParser,
+        reinterpret_cast<const lxb_char_t*>(selectorBytes.constData()),
+        selectorBytes.length());
+
+    CompiledSelectorPtr compiled;
+    if (list) {
+        compiled.reset(new CompiledSelector(selector, list));
+    } else {
+        qDebug() << "SelectorCache: Failed to parse CSS selector:" << selector;
+    }
+    m_selectors.insert(selector, compiled);
+    return compiled;
+}
+
+int SelectorCache::size() const
+{
+    QReadLocker locker(&m_lock);
+    return m_selectors.size();
+}
@@ -0,0 +1,70 @@
+#ifndef SELECTORCACHE_H
+#define SELECTORCACHE_H
+
+#include <QString>
+#include <QHash>
+#include <QReadWriteLock>
+#include <memory>
+#include <lexbor/css/css.h>
+
+/**
+ * @brief A CSS selector parsed once by Lexbor, ready for lxb_selectors_find()
+ *
+ * Immutable after construction: matching only reads the selector list, so one
+ * instance may be used by any number of parsers on any thread at once.
+ */
+class CompiledSelector
+{
+public:
+    ~CompiledSelector();
+
+    const QString &source() const { return m_source; }
+
+    /**
+     * @brief Parsed selector list; lxb_selectors_find() takes it non-const but does not modify it
+     */
+    lxb_css_selector_list_t *list() const { return m_list; }
+
+private:
+    friend class SelectorCache;
+    CompiledSelector(const QString &source, lxb_css_selector_list_t *list);
+    CompiledSelector(const CompiledSelector &) = delete;
+    CompiledSelector &operator=(const CompiledSelector &) = delete;
+
+    QString m_source;
+    lxb_css_selector_list_t *m_list;    // Owns its own Lexbor memory
+};
+
+using CompiledSelectorPtr = std::shared_ptr<const CompiledSelector>;
+
+/**
+ * @brief Process-wide selector string -> CompiledSelector map
+ *
+ * Rule selectors never change while a source is loaded, so each distinct
+ * string is compiled the first time it is seen and then shared. Selectors
+ * Lexbor rejects are remembered as null, so a bad rule does not re-run the
+ * CSS parser on every page either. Thread-safe; lookups take a read lock.
+ */
+class SelectorCache
+{
+public:
+    static SelectorCache *instance();
+
+    /**
+     * @brief Compiled form of the selector, compiling it on first use
+     * @return Null if the selector is empty or not valid CSS
+     */
+    CompiledSelectorPtr get(const QString &selector);
+
+    int size() const;
+
+private:
+    SelectorCache();
+    ~SelectorCache();
+
+    mutable QReadWriteLock m_lock;
+    QHash<QString, CompiledSelectorPtr> m_selectors;
+    lxb_css_parser_t *m_cssParser;      // Used only under the write lock
+};
+
+#endif // SELECTORCACHE_H
@@ -0,0 +1,492 @@
+#include "StreamingTocExtractor.h"
+#include "ChunkTranscoder.h"
+#include "../network/CharsetDetector.h"
+#include <lexbor/html/tokenizer.h>
+#include <lexbor/html/tokenizer/state.h>
+#include <lexbor/html/tokenizer/state_rawtext.h>
+#include <lexbor/html/tokenizer/state_rcdata.h>
+#include <lexbor/html/tokenizer/state_script.h>
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+
+bool isNameChar(QChar ch)
+{
+    return ch.isLetterOrNumber() || ch == '-' || ch == '_';
+}
+
+// Elements without an end tag never enter the stack
+bool isVoidElement(lxb_tag_id_t tagId)
+{
+    switch (tagId) {
+    case LXB_TAG_AREA: case LXB_TAG_BASE: case LXB_TAG_BR: case LXB_TAG_COL:
+    case LXB_TAG_EMBED: case LXB_TAG_HR: case LXB_TAG_IMG: case LXB_TAG_INPUT:
+    case LXB_TAG_LINK: case LXB_TAG_META: case LXB_TAG_PARAM: case LXB_TAG_SOURCE:
+    case LXB_TAG_TRACK: case LXB_TAG_WBR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Start tags that close an open <p>
+bool closesParagraph(lxb_tag_id_t tagId)
+{
+    switch (tagId) {
+    case LXB_TAG_ADDRESS: case LXB_TAG_ARTICLE: case LXB_TAG_ASIDE: case LXB_TAG_BLOCKQUOTE:
+    case LXB_TAG_DIV: case LXB_TAG_DL: case LXB_TAG_FIELDSET: case LXB_TAG_FOOTER:
+    case LXB_TAG_FORM: case LXB_TAG_H1: case LXB_TAG_H2: case LXB_TAG_H3:
+    case LXB_TAG_H4: case LXB_TAG_H5: case LXB_TAG_H6: case LXB_TAG_HEADER:
+    case LXB_TAG_HR: case LXB_TAG_MAIN: case LXB_TAG_NAV: case LXB_TAG_OL:
+    case LXB_TAG_P: case LXB_TAG_PRE: case LXB_TAG_SECTION: case LXB_TAG_TABLE:
+    case LXB_TAG_UL:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool hasClass(const QByteArray &classAttribute, const QByteArray &name)
+{
+    int from = 0;
+    while ((from = classAttribute.indexOf(name, from)) >= 0) {
+        const int end = from + name.size();
+        const bool startsWord = from == 0 || QChar(classAttribute.at(from - 1)).isSpace();
+        const bool endsWord = end == classAttribute.size() || QChar(classAttribute.at(end)).isSpace();
+        if (startsWord && endsWord) {
+            return true;
+        }
+        from = end;
+    }
+    return false;
+}
+
+} // namespace
+
+StreamingTocExtractor::StreamingTocExtractor(const QString &selector)
+    : m_valid(parseSelector(selector, &m_compounds))
+    , m_needsAttributes(false)
+    , m_tokenizer(nullptr)
+    , m_started(false)
+    , m_captureDepth(0)
+    , m_linkCount(0)
+{
+    for (const Compound &compound : m_compounds) {
+        m_needsAttributes = m_needsAttributes || !compound.id.isEmpty() || !compound.classes.isEmpty();
+    }
+    if (!m_valid) {
+        m_error = QString("Selector cannot be matched while streaming: %1").arg(selector);
+    }
+}
+
+StreamingTocExtractor::~StreamingTocExtractor()
+{
+    if (m_tokenizer) {
+        lxb_html_tokenizer_destroy(m_tokenizer);
+    }
+}
+
+bool StreamingTocExtractor::isStreamable(const QString &selector)
+{
+    QVector<Compound> compounds;
+    return parseSelector(selector, &compounds);
+}
+
+bool StreamingTocExtractor::parseSelector(const QString &selector, QVector<Compound> *compounds)
+{
+    QVector<Compound> parsed;
+    bool pendingChild = false;
+    int i = 0;
+    const int length = selector.length();
+
+    while (i < length) {
+        const QChar ch = selector.at(i);
+        if (ch.isSpace()) {
+            ++i;
+            continue;
+        }
+        if (ch == '>') {
+            if (parsed.isEmpty() || pendingChild) {
+                return false;
+            }
+            pendingChild = true;
+            ++i;
+            continue;
+        }
+
+        Compound compound;
+        compound.child = pendingChild;
+        pendingChild = false;
+
+        while (i < length && !selector.at(i).isSpace() && selector.at(i) != '>') {
+            const QChar marker = selector.at(i);
+            if (marker == '*' && compound.tag.isEmpty() && compound.id.isEmpty() && compound.classes.isEmpty()) {
+                ++i;
+                continue;
+            }
+            if (marker == '#' || marker == '.') {
+                ++i;
+            }
+
+            const int start = i;
+            while (i < length && isNameChar(selector.at(i))) {
+                ++i;
+            }
+            if (i == start) {
+                return false;   // Attribute tests, pseudo-classes, lists and sibling combinators
+            }
+            const QByteArray name = selector.mid(start, i - start).toUtf8();
+
+            if (marker == '#') {
+                if (!compound.id.isEmpty()) {
+                    return false;
+                }
+                compound.id = name;
+            } else if (marker == '.') {
+                compound.classes.append(name);
+            } else {
+                if (!compound.tag.isEmpty() || !compound.id.isEmpty() || !compound.classes.isEmpty()) {
+                    return false;
+                }
+                compound.tag = name.toLower();
+            }
+        }
+        parsed.append(compound);
+    }
+
+    if (parsed.isEmpty() || pendingChild) {
+        return false;
+    }
+    *compounds = parsed;
+    return true;
+}
+
+bool StreamingTocExtractor::begin(const QByteArray &charset)
+{
+    if (!m_valid) {
+        return false;
+    }
+
+    // A new document, e.g. a retried transfer, starts from a fresh tokenizer
+    if (m_tokenizer) {
+        lxb_html_tokenizer_destroy(m_tokenizer);
+    }
+    m_stack.clear();
+    m_captureDepth = 0;
+    m_text.clear();
+    m_href.clear();
+    m_linkCount = 0;
+    m_error.clear();
+    m_started = false;
+
+    m_tokenizer = lxb_html_tokenizer_create();
+    if (!m_tokenizer || lxb_html_tokenizer_init(m_tokenizer) != LXB_STATUS_OK) {
+        m_error = "Failed to create HTML tokenizer";
+        return false;
+    }
+    lxb_html_tokenizer_callback_token_done_set(m_tokenizer, &StreamingTocExtractor::onToken, this);
+
+    if (lxb_html_tokenizer_begin(m_tokenizer) != LXB_STATUS_OK) {
+        m_error = "Failed to begin tokenizing";
+        return false;
+    }
+
+    // Tag ids come from the tokenizer's tag table, which exists once it has begun
+    for (Compound &compound : m_compounds) {
+        if (!compound.tag.isEmpty()) {
+            compound.tagId = lxb_tag_id_by_name(lxb_html_tokenizer_tags(m_tokenizer),
+                reinterpret_cast<const lxb_char_t*>(compound.tag.constData()), compound.tag.size());
+        }
+    }
+
+    m_transcoder.reset();
+    if (!CharsetDetector::isUtf8(charset)) {
+        m_transcoder.reset(new ChunkTranscoder());
+        if (!m_transcoder->init(charset)) {
+            qDebug() << "StreamingTocExtractor: Unsupported charset" << charset << ", reading chunks as UTF-8";
+            m_transcoder.reset();
+        }
+    }
+
+    m_started = true;
+    return true;
+}
+
+bool StreamingTocExtractor::feed(const char *data, size_t size)
+{
+    if (!m_started) {
+        if (m_error.isEmpty()) {
+            m_error = "Tokenizing not started";
+        }
+        return false;
+    }
+    if (size == 0) {
+        return true;
+    }
+
+    if (m_transcoder) {
+        m_chunkBuffer.clear();
+        m_transcoder->feed(data, size, &m_chunkBuffer);
+        return tokenize(m_chunkBuffer.constData(), static_cast<size_t>(m_chunkBuffer.size()));
+    }
+    return tokenize(data, size);
+}
+
+bool StreamingTocExtractor::end()
+{
+    if (!m_started) {
+        if (m_error.isEmpty()) {
+            m_error = "Tokenizing not started";
+        }
+        return false;
+    }
+    m_started = false;
+
+    if (m_transcoder) {
+        m_chunkBuffer.clear();
+        m_transcoder->finish(&m_chunkBuffer);
+        m_transcoder.reset();
+        if (!m_chunkBuffer.isEmpty() && !tokenize(m_chunkBuffer.constData(), static_cast<size_t>(m_chunkBuffer.size()))) {
+            return false;
+        }
+    }
+    m_chunkBuffer = QByteArray();
+
+    if (lxb_html_tokenizer_end(m_tokenizer) != LXB_STATUS_OK) {
+        m_error = "Failed to finish tokenizing";
+        return false;
+    }
+
+    // Elements left open at the end of the page close there
+    popTo(0);
+
+    // The tokenizer keeps the input it was given; release it with the document
+    lxb_html_tokenizer_destroy(m_tokenizer);
+    m_tokenizer = nullptr;
+    return true;
+}
+
+bool StreamingTocExtractor::tokenize(const char *data, size_t size)
+{
+    const lxb_status_t status = lxb_html_tokenizer_chunk(m_tokenizer, reinterpret_cast<const lxb_char_t*>(data), size);
+    if (status != LXB_STATUS_OK) {
+        m_error = QString("Failed to tokenize HTML chunk, status: %1").arg(status);
+        m_started = false;
+        return false;
+    }
+    return true;
+}
+
+lxb_html_token_t *StreamingTocExtractor::onToken(lxb_html_tokenizer_t *tokenizer, lxb_html_token_t *token, void *context)
+{
+    Q_UNUSED(tokenizer)
+    static_cast<StreamingTocExtractor*>(context)->handleToken(token);
+    return token;
+}
+
+void StreamingTocExtractor::handleToken(lxb_html_token_t *token)
+{
+    switch (token->tag_id) {
+    case LXB_TAG__TEXT:
+        if (m_captureDepth > 0) {
+            m_text.append(reinterpret_cast<const char*>(token->text_start),
+                          static_cast<int>(token->text_end - token->text_start));
+        }
+        return;
+
+    case LXB_TAG__EM_COMMENT:
+    case LXB_TAG__EM_DOCTYPE:
+    case LXB_TAG__END_OF_FILE:
+        return;
+
+    default:
+        break;
+    }
+
+    if (token->type & LXB_HTML_TOKEN_TYPE_CLOSE) {
+        closeElement(token->tag_id);
+    } else {
+        openElement(token);
+    }
+}
+
+void StreamingTocExtractor::openElement(lxb_html_token_t *token)
+{
+    const lxb_tag_id_t tagId = token->tag_id;
+    closeImplied(tagId);
+
+    OpenElement element;
+    element.tagId = tagId;
+
+    const lxb_char_t *href = nullptr;
+    size_t hrefLength = 0;
+    for (lxb_html_token_attr_t *attr = token->attr_first; attr; attr = attr->next) {
+        size_t nameLength = 0;
+        const lxb_char_t *name = lxb_html_token_attr_name(attr, &nameLength);
+        if (!name || !attr->value) {
+            continue;
+        }
+        const QByteArray attrName = QByteArray::fromRawData(reinterpret_cast<const char*>(name), static_cast<int>(nameLength));
+        if (attrName == "href") {
+            href = attr->value;
+            hrefLength = attr->value_size;
+        } else if (m_needsAttributes && attrName == "id") {
+            element.id = QByteArray(reinterpret_cast<const char*>(attr->value), static_cast<int>(attr->value_size));
+        } else if (m_needsAttributes && attrName == "class") {
+            element.classes = QByteArray(reinterpret_cast<const char*>(attr->value), static_cast<int>(attr->value_size));
+        }
+    }
+
+    m_stack.append(element);
+
+    if (m_captureDepth == 0 && matches(m_compounds.size() - 1, m_stack.size() - 1)) {
+        m_captureDepth = m_stack.size();
+        m_text.clear();
+        m_href = href ? QByteArray(reinterpret_cast<const char*>(href), static_cast<int>(hrefLength)) : QByteArray();
+    }
+
+    if (isVoidElement(tagId) || (token->type & LXB_HTML_TOKEN_TYPE_CLOSE_SELF)) {
+        popTo(m_stack.size() - 1);
+        return;
+    }
+
+    // Without a tree builder the tokenizer has to be told where raw text starts
+    switch (tagId) {
+    case LXB_TAG_SCRIPT:
+        lxb_html_tokenizer_tmp_tag_id_set(m_tokenizer, tagId);
+        lxb_html_tokenizer_state_set(m_tokenizer, lxb_html_tokenizer_state_script_data_before);
+        break;
+    case LXB_TAG_STYLE: case LXB_TAG_XMP: case LXB_TAG_IFRAME:
+    case LXB_TAG_NOEMBED: case LXB_TAG_NOFRAMES:
+        lxb_html_tokenizer_tmp_tag_id_set(m_tokenizer, tagId);
+        lxb_html_tokenizer_state_set(m_tokenizer, lxb_html_tokenizer_state_rawtext_before);
+        break;
+    case LXB_TAG_TEXTAREA: case LXB_TAG_TITLE:
+        lxb_html_tokenizer_tmp_tag_id_set(m_tokenizer, tagId);
+        lxb_html_tokenizer_state_set(m_tokenizer, lxb_html_tokenizer_state_rcdata_before);
+        break;
+    case LXB_TAG_PLAINTEXT:
+        lxb_html_tokenizer_state_set(m_tokenizer, lxb_html_tokenizer_state_plaintext_before);
+        break;
+    default:
+        break;
+    }
+}
+
+void StreamingTocExtractor::closeElement(lxb_tag_id_t tagId)
+{
+    // Stray end tags are ignored, as the tree builder would
+    for (int i = m_stack.size() - 1; i >= 0; --i) {
+        if (m_stack.at(i).tagId == tagId) {
+            popTo(i);
+            return;
+        }
+    }
+}
+
+void StreamingTocExtractor::closeImplied(lxb_tag_id_t tagId)
+{
+    switch (tagId) {
+    case LXB_TAG_LI:
+        closeInScope({LXB_TAG_LI}, {LXB_TAG_UL, LXB_TAG_OL});
+        break;
+    case LXB_TAG_DD:
+    case LXB_TAG_DT:
+        closeInScope({LXB_TAG_DD, LXB_TAG_DT}, {LXB_TAG_DL});
+        break;
+    case LXB_TAG_OPTION:
+        closeInScope({LXB_TAG_OPTION}, {LXB_TAG_SELECT, LXB_TAG_DATALIST});
+        break;
+    case LXB_TAG_TR:
+        closeInScope({LXB_TAG_TR}, {LXB_TAG_TABLE, LXB_TAG_TBODY, LXB_TAG_THEAD, LXB_TAG_TFOOT});
+        break;
+    case LXB_TAG_TD:
+    case LXB_TAG_TH:
+        closeInScope({LXB_TAG_TD, LXB_TAG_TH}, {LXB_TAG_TR, LXB_TAG_TABLE});
+        break;
+    case LXB_TAG_A:
+        // Links do not nest; a new one ends the previous
+        closeInScope({LXB_TAG_A}, {LXB_TAG_TD, LXB_TAG_TH, LXB_TAG_TABLE});
+        break;
+    default:
+        break;
+    }
+
+    if (closesParagraph(tagId)) {
+        closeInScope({LXB_TAG_P}, {LXB_TAG_BUTTON, LXB_TAG_TD, LXB_TAG_TH, LXB_TAG_TABLE});
+    }
+}
+
+bool StreamingTocExtractor::closeInScope(std::initializer_list<lxb_tag_id_t> targets,
+                                         std::initializer_list<lxb_tag_id_t> boundaries)
+{
+    for (int i = m_stack.size() - 1; i >= 0; --i) {
+        const lxb_tag_id_t open = m_stack.at(i).tagId;
+        if (std::find(targets.begin(), targets.end(), open) != targets.end()) {
+            popTo(i);
+            return true;
+        }
+        if (std::find(boundaries.begin(), boundaries.end(), open) != boundaries.end()) {
+            return false;
+        }
+    }
+    return false;
+}
+
+void StreamingTocExtractor::popTo(int depth)
+{
+    if (m_captureDepth > depth) {
+        finishLink();
+    }
+    if (m_stack.size() > depth) {
+        m_stack.resize(depth);
+    }
+}
+
+void StreamingTocExtractor::finishLink()
+{
+    m_captureDepth = 0;
+    m_linkCount++;
+    if (m_callback) {
+        m_callback(QString::fromUtf8(m_text), QString::fromUtf8(m_href));
+    }
+    m_text.clear();
+    m_href.clear();
+}
+
+bool StreamingTocExtractor::matches(int compound, int element) const
+{
+    // Right to left, as CSS engines do; stacks and selectors are both short
+    if (!compoundMatches(m_compounds.at(compound), m_stack.at(element))) {
+        return false;
+    }
+    if (compound == 0) {
+        return true;
+    }
+    if (m_compounds.at(compound).child) {
+        return element > 0 && matches(compound - 1, element - 1);
+    }
+    for (int ancestor = element - 1; ancestor >= 0; --ancestor) {
+        if (matches(compound - 1, ancestor)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool StreamingTocExtractor::compoundMatches(const Compound &compound, const OpenElement &element) const
+{
+    if (!compound.tag.isEmpty() && compound.tagId != element.tagId) {
+        return false;
+    }
+    if (!compound.id.isEmpty() && compound.id != element.id) {
+        return false;
+    }
+    for (const QByteArray &name : compound.classes) {
+        if (!hasClass(element.classes, name)) {
+            return false;
+        }
+    }
+    return true;
+}
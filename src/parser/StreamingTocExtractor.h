@@ -0,0 +1,110 @@
+#ifndef STREAMINGTOCEXTRACTOR_H
+#define STREAMINGTOCEXTRACTOR_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QVector>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <lexbor/html/html.h>
+
+struct ChunkTranscoder;
+
+/**
+ * @brief Chapter links picked out of HTML while it is tokenized, without building a tree
+ *
+ * For TOC pages with thousands of links, where a full document and one
+ * ElementInfo text copy per link dominate memory. Handles the simple
+ * selectors TOC rules use, like "#list > dl > dd > a": compounds of a tag
+ * name, an #id and .classes joined by descendant or child combinators.
+ *
+ * The open-element stack is rebuilt from the token stream, including the
+ * implied end tags of li, dd, dt, p, option, table rows and cells and nested
+ * links. That is enough for link lists, not the full tree construction
+ * algorithm, so callers should fall back to LexborHtmlParser when nothing
+ * matches. Only the text and href of matched elements are kept. Not
+ * thread-safe.
+ */
+class StreamingTocExtractor
+{
+public:
+    using LinkCallback = std::function<void(const QString &text, const QString &href)>;
+
+    explicit StreamingTocExtractor(const QString &selector);
+    ~StreamingTocExtractor();
+
+    /**
+     * @brief Whether the selector uses only what the token stream can match
+     */
+    static bool isStreamable(const QString &selector);
+
+    bool isValid() const { return m_valid; }
+
+    /**
+     * @brief Called for each matched element when it closes, in document order
+     */
+    void setLinkCallback(LinkCallback callback) { m_callback = std::move(callback); }
+
+    /**
+     * @brief Start a new document
+     * @param charset Charset label of the bytes to come (empty or "utf-8" reads them as is)
+     */
+    bool begin(const QByteArray &charset);
+    bool feed(const char *data, size_t size);
+    bool end();
+
+    int linkCount() const { return m_linkCount; }
+    QString errorString() const { return m_error; }
+
+private:
+    struct Compound {
+        QByteArray tag;             // Lower case; empty matches any element
+        lxb_tag_id_t tagId = LXB_TAG__UNDEF;
+        QByteArray id;
+        QList<QByteArray> classes;
+        bool child = false;         // Joined to the previous compound by '>'
+    };
+
+    struct OpenElement {
+        lxb_tag_id_t tagId = LXB_TAG__UNDEF;
+        QByteArray id;
+        QByteArray classes;         // Raw class attribute
+    };
+
+    Q_DISABLE_COPY(StreamingTocExtractor)
+
+    static bool parseSelector(const QString &selector, QVector<Compound> *compounds);
+    static lxb_html_token_t *onToken(lxb_html_tokenizer_t *tokenizer, lxb_html_token_t *token, void *context);
+
+    void handleToken(lxb_html_token_t *token);
+    void openElement(lxb_html_token_t *token);
+    void closeElement(lxb_tag_id_t tagId);
+    void closeImplied(lxb_tag_id_t tagId);
+    bool closeInScope(std::initializer_list<lxb_tag_id_t> targets, std::initializer_list<lxb_tag_id_t> boundaries);
+    void popTo(int depth);
+    void finishLink();
+    bool matches(int compound, int element) const;
+    bool compoundMatches(const Compound &compound, const OpenElement &element) const;
+    bool tokenize(const char *data, size_t size);
+
+    QVector<Compound> m_compounds;
+    bool m_valid;
+    bool m_needsAttributes;         // Some compound tests an id or a class
+    LinkCallback m_callback;
+
+    lxb_html_tokenizer_t *m_tokenizer;
+    std::unique_ptr<ChunkTranscoder> m_transcoder;  // Legacy charset of the document, null for UTF-8
+    QByteArray m_chunkBuffer;                       // Transcoded chunk, reused between calls
+    bool m_started;
+
+    QVector<OpenElement> m_stack;
+    int m_captureDepth;             // Stack size while inside a matched element, 0 otherwise
+    QByteArray m_text;              // UTF-8 text of the matched element so far
+    QByteArray m_href;
+    int m_linkCount;
+    QString m_error;
+};
+
+#endif // STREAMINGTOCEXTRACTOR_H
@@ -0,0 +1,156 @@
+#include "TextNormalizer.h"
+#include "HtmlSanitizer.h"
+
+namespace {
+
+const int MAX_ENTITY_LENGTH = 10;   // "&#x10FFFF;"
+
+bool isAsciiLetter(ushort ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z');
+}
+
+ushort toLowerAscii(ushort ch)
+{
+    return (ch >= 'A' && ch <= 'Z') ? ch + ('a' - 'A') : ch;
+}
+
+bool nameEquals(const QChar *name, int length, const char *literal)
+{
+    int i = 0;
+    for (; i < length && literal[i]; ++i) {
+        if (toLowerAscii(name[i].unicode()) != static_cast<uchar>(literal[i])) {
+            return false;
+        }
+    }
+    return i == length && !literal[i];
+}
+
+bool isBreakTag(const QChar *name, int length, const QString &breakTag)
+{
+    if (nameEquals(name, length, "p") || nameEquals(name, length, "br") || nameEquals(name, length, "div")) {
+        return true;
+    }
+    return !breakTag.isEmpty() && QString::compare(QString::fromRawData(name, length), breakTag, Qt::CaseInsensitive) == 0;
+}
+
+// Code point of the entity between '&' and ';', or 0 if it is not one we decode
+uint decodeEntity(const QChar *name, int length)
+{
+    if (length >= 2 && name[0] == QLatin1Char('#')) {
+        const bool hex = name[1] == QLatin1Char('x') || name[1] == QLatin1Char('X');
+        bool ok = false;
+        const uint value = QString::fromRawData(name + (hex ? 2 : 1), length - (hex ? 2 : 1)).toUInt(&ok, hex ? 16 : 10);
+        if (!ok) {
+            return 0;
+        }
+        if (value == 0 || value > 0x10FFFF || (value >= 0xD800 && value <= 0xDFFF)) {
+            return 0xFFFD;
+        }
+        return value;
+    }
+
+    if (nameEquals(name, length, "amp")) return '&';
+    if (nameEquals(name, length, "lt")) return '<';
+    if (nameEquals(name, length, "gt")) return '>';
+    if (nameEquals(name, length, "quot")) return '"';
+    if (nameEquals(name, length, "apos")) return '\'';
+    if (nameEquals(name, length, "nbsp")) return 0x00A0;
+    return 0;
+}
+
+} // namespace
+
+QString TextNormalizer::normalize(const QString &text, Options options, const QString &breakTag)
+{
+    if (text.isEmpty()) {
+        return text;
+    }
+
+    QString out;
+    out.resize(text.size());    // Every step shrinks or keeps the length
+    QChar *const begin = out.data();
+    QChar *dst = begin;
+    bool pendingSpace = false;
+    bool pendingBreak = false;
+    const bool keepBreaks = options & KeepLineBreaks;
+
+    auto put = [&](QChar ch) {
+        const ushort u = ch.unicode();
+        if (u == '\n' || u == '\r') {
+            (keepBreaks ? pendingBreak : pendingSpace) = true;
+            return;
+        }
+        if (ch.isSpace()) {
+            pendingSpace = true;     // Includes U+00A0 and full-width U+3000
+            return;
+        }
+        if ((options & StripControlChars) && HtmlSanitizer::isControlChar(u)) {
+            return;
+        }
+        if (dst != begin) {
+            if (pendingBreak) {
+                *dst++ = QLatin1Char('\n');
+            } else if (pendingSpace) {
+                *dst++ = QLatin1Char(' ');
+            }
+        }
+        pendingBreak = false;
+        pendingSpace = false;
+        *dst++ = ch;
+    };
+
+    const QChar *p = text.constData();
+    const QChar *end = p + text.size();
+
+    while (p < end) {
+        const ushort u = p->unicode();
+
+        if (u == '<' && (options & StripTags) && p + 1 < end) {
+            const ushort next = p[1].unicode();
+            if (isAsciiLetter(next) || next == '/' || next == '!' || next == '?') {
+                const QChar *close = p + 1;
+                while (close < end && *close != QLatin1Char('>')) {
+                    ++close;
+                }
+                if (close < end) {
+                    const QChar *name = p + (next == '/' ? 2 : 1);
+                    const QChar *nameEnd = name;
+                    while (nameEnd < close && (isAsciiLetter(nameEnd->unicode()) || nameEnd->isDigit())) {
+                        ++nameEnd;
+                    }
+                    if (isBreakTag(name, static_cast<int>(nameEnd - name), breakTag)) {
+                        put(QLatin1Char('\n'));
+                    }
+                    p = close + 1;
+                    continue;
+                }
+            }
+        }
+
+        if (u == '&' && (options & DecodeEntities)) {
+            const QChar *semicolon = p + 1;
+            while (semicolon < end && semicolon - p <= MAX_ENTITY_LENGTH && *semicolon != QLatin1Char(';')) {
+                ++semicolon;
+            }
+            if (semicolon < end && *semicolon == QLatin1Char(';')) {
+                const uint codePoint = decodeEntity(p + 1, static_cast<int>(semicolon - p - 1));
+                if (codePoint) {
+                    if (QChar::requiresSurrogates(codePoint)) {
+                        put(QChar(QChar::highSurrogate(codePoint)));
+                        put(QChar(QChar::lowSurrogate(codePoint)));
+                    } else {
+                        put(QChar(static_cast<ushort>(codePoint)));
+                    }
+                    p = semicolon + 1;
+                    continue;
+                }
+            }
+        }
+
+        put(*p++);
+    }
+
+    out.truncate(static_cast<int>(dst - begin));
+    return out;
+}
@@ -0,0 +1,42 @@
+#ifndef TEXTNORMALIZER_H
+#define TEXTNORMALIZER_H
+
+#include <QString>
+#include <QFlags>
+
+/**
+ * @brief Fused single-pass cleanup of extracted chapter text
+ *
+ * One forward scan does what used to be separate passes over the chapter:
+ * tag removal (paragraph tags become line breaks), entity decoding,
+ * control-character stripping and whitespace normalization. Output goes
+ * into one buffer sized to the input, which it never outgrows.
+ *
+ * Result: one paragraph per line, lines separated by a single '\n', inner
+ * whitespace runs collapsed to one space, and leading/trailing whitespace of
+ * each line dropped, full-width U+3000 indentation included. Decoded text is
+ * never re-scanned, so "&lt;b&gt;" stays the literal text "<b>".
+ */
+class TextNormalizer
+{
+public:
+    enum Option {
+        StripTags         = 0x1,    // Drop tags; <p>, <br>, <div> and the break tag start a new line
+        DecodeEntities    = 0x2,    // Named basics, &nbsp; and numeric references
+        StripControlChars = 0x4,    // C0 controls except \t \n \r, and DEL
+        KeepLineBreaks    = 0x8,    // Otherwise line breaks collapse into spaces too
+
+        ChapterText = StripTags | DecodeEntities | StripControlChars | KeepLineBreaks
+    };
+    Q_DECLARE_FLAGS(Options, Option)
+
+    /**
+     * @param breakTag Extra tag name that separates paragraphs, e.g. a rule's paragraph tag
+     */
+    static QString normalize(const QString &text, Options options = ChapterText,
+                             const QString &breakTag = QString());
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(TextNormalizer::Options)
+
+#endif // TEXTNORMALIZER_H
@@ -0,0 +1,163 @@
+#include "TocStreamSink.h"
+#include "ContentParser.h"
+#include "ParserPool.h"
+#include "../network/CharsetDetector.h"
+#include <QDebug>
+#include <algorithm>
+
+namespace {
+// CharsetDetector::fromMetaTags looks at the same window
+const int SNIFF_BYTES = 4096;
+}
+
+TocStreamSink::TocStreamSink(const TocRule &rule, const QString &baseUrl)
+    : m_extractor(rule.item())
+    , m_baseUrl(baseUrl)
+    , m_descending(rule.isDesc())
+    , m_chapterCount(0)
+    , m_extracting(false)
+    , m_failed(false)
+    , m_complete(false)
+    , m_bytesReceived(0)
+{
+    m_extractor.setLinkCallback([this](const QString &title, const QString &href) {
+        onLink(title, href);
+    });
+}
+
+void TocStreamSink::begin(const QByteArray &contentType)
+{
+    // A retried attempt starts over; chapters already handed out come again
+    m_contentType = contentType;
+    m_charset.clear();
+    m_sniffBuffer.clear();
+    m_batch.clear();
+    m_chapterCount = 0;
+    m_extracting = false;
+    m_failed = false;
+    m_complete = false;
+    m_bytesReceived = 0;
+    m_error.clear();
+
+    if (!m_extractor.isValid()) {
+        m_failed = true;
+        m_error = m_extractor.errorString();
+        return;
+    }
+
+    const QByteArray declared = CharsetDetector::fromContentType(contentType);
+    if (!declared.isEmpty()) {
+        startExtraction(CharsetDetector::normalize(declared));
+    }
+}
+
+void TocStreamSink::write(const char *data, int size)
+{
+    if (m_failed) {
+        return;
+    }
+    m_bytesReceived += size;
+
+    if (m_extracting) {
+        if (!m_extractor.feed(data, static_cast<size_t>(size))) {
+            m_failed = true;
+            m_error = m_extractor.errorString();
+        }
+        return;
+    }
+
+    m_sniffBuffer.append(data, size);
+    if (m_sniffBuffer.size() >= SNIFF_BYTES) {
+        startExtraction(CharsetDetector::detect(m_sniffBuffer, m_contentType));
+    }
+}
+
+void TocStreamSink::end(bool complete)
+{
+    if (!complete) {
+        m_failed = true;
+        if (m_error.isEmpty()) {
+            m_error = "Transfer incomplete";
+        }
+    }
+
+    if (!m_failed && !m_extracting) {
+        // Short page: everything is still in the sniff buffer
+        startExtraction(CharsetDetector::detect(m_sniffBuffer, m_contentType));
+    }
+
+    if (m_failed) {
+        m_sniffBuffer.clear();
+        m_batch.clear();
+        return;
+    }
+
+    if (!m_extractor.end()) {
+        m_failed = true;
+        m_error = m_extractor.errorString();
+        m_batch.clear();
+        return;
+    }
+
+    if (m_descending) {
+        // Newest first on the page; numbered and handed out in reading order
+        std::reverse(m_batch.begin(), m_batch.end());
+        for (int i = 0; i < m_batch.size(); ++i) {
+            m_batch[i].setOrder(i + 1);
+        }
+    }
+    flush();
+
+    m_complete = true;
+    qDebug() << "TocStreamSink: Extracted" << m_chapterCount << "chapters from" << m_bytesReceived
+             << "bytes as" << m_charset << "while downloading";
+}
+
+bool TocStreamSink::startExtraction(const QByteArray &charset)
+{
+    m_charset = charset;
+    m_extracting = m_extractor.begin(charset);
+    if (!m_extracting) {
+        m_failed = true;
+        m_error = m_extractor.errorString();
+        return false;
+    }
+
+    const QByteArray buffered = m_sniffBuffer;
+    m_sniffBuffer = QByteArray();
+    if (!buffered.isEmpty() && !m_extractor.feed(buffered.constData(), static_cast<size_t>(buffered.size()))) {
+        m_failed = true;
+        m_error = m_extractor.errorString();
+        return false;
+    }
+    return true;
+}
+
+void TocStreamSink::onLink(const QString &title, const QString &href)
+{
+    // The network thread's own ContentParser applies the same filters as the DOM path
+    Chapter chapter;
+    if (!ParserPool::threadContentParser()->tocLinkToChapter(title, href, m_baseUrl, &chapter)) {
+        return;
+    }
+
+    chapter.setOrder(++m_chapterCount);
+    m_batch.append(chapter);
+
+    // The first chapters go out early so downloads can start
+    const bool firstBatch = m_batch.size() == m_chapterCount;
+    if (!m_descending && m_batch.size() >= (firstBatch ? FIRST_BATCH_SIZE : BATCH_SIZE)) {
+        flush();
+    }
+}
+
+void TocStreamSink::flush()
+{
+    if (m_batch.isEmpty()) {
+        return;
+    }
+    if (m_callback) {
+        m_callback(m_batch);
+    }
+    m_batch.clear();
+}
@@ -0,0 +1,76 @@
+#ifndef TOCSTREAMSINK_H
+#define TOCSTREAMSINK_H
+
+#include <QByteArray>
+#include <QString>
+#include <QList>
+#include <functional>
+#include "../network/BodySink.h"
+#include "../novel/NovelModels.h"
+#include "StreamingTocExtractor.h"
+
+/**
+ * @brief BodySink that turns a single-page TOC into chapters while it downloads
+ *
+ * Runs StreamingTocExtractor on the rule's item selector, so no document is
+ * built. Chapters are handed out in batches as they are found, on the network
+ * thread. A retried transfer starts over and hands out the same chapters
+ * again, numbered from 1, so the receiver must skip orders it already has.
+ * Descending lists (TocRule::isDesc) are handed out in one batch at the end,
+ * in reading order.
+ * Use only for selectors StreamingTocExtractor::isStreamable() accepts.
+ */
+class TocStreamSink : public BodySink
+{
+public:
+    using BatchCallback = std::function<void(const QList<Chapter> &chapters)>;
+
+    TocStreamSink(const TocRule &rule, const QString &baseUrl);
+
+    void setBatchCallback(BatchCallback callback) { m_callback = std::move(callback); }
+
+    void begin(const QByteArray &contentType) override;
+    void write(const char *data, int size) override;
+    void end(bool complete) override;
+
+    /**
+     * @brief The whole body arrived and was tokenized
+     */
+    bool isComplete() const { return m_complete; }
+
+    int chapterCount() const { return m_chapterCount; }
+
+    /**
+     * @brief Elements the item selector matched, chapters or not
+     */
+    int linkCount() const { return m_extractor.linkCount(); }
+    QByteArray charset() const { return m_charset; }
+    qint64 bytesReceived() const { return m_bytesReceived; }
+    QString errorString() const { return m_error; }
+
+private:
+    bool startExtraction(const QByteArray &charset);
+    void onLink(const QString &title, const QString &href);
+    void flush();
+
+    static const int FIRST_BATCH_SIZE = 20;
+    static const int BATCH_SIZE = 200;  // Chapters per hand-out; one queued call each on the GUI thread
+
+    StreamingTocExtractor m_extractor;
+    QString m_baseUrl;
+    bool m_descending;
+    BatchCallback m_callback;
+
+    QByteArray m_contentType;
+    QByteArray m_charset;
+    QByteArray m_sniffBuffer;       // Body start kept until the charset is known
+    QList<Chapter> m_batch;
+    int m_chapterCount;
+    bool m_extracting;
+    bool m_failed;
+    bool m_complete;
+    qint64 m_bytesReceived;
+    QString m_error;
+};
+
+#endif // TOCSTREAMSINK_H
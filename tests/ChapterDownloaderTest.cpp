@@ -0,0 +1,111 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include "../src/novel/ChapterDownloader.h"
+#include "../src/network/HttpClient.h"
+#include "../src/parser/ContentParser.h"
+
+/**
+ * @brief Scheduling tests for ChapterDownloader
+ *
+ * Chapter requests go to a local server that accepts and never answers, so
+ * every started task stays active until the test lets go of the connections.
+ */
+class ChapterDownloaderTest : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void tasksAddedDuringRunFillEverySlot();
+
+private:
+    int activeTasks() const;
+    Chapter chapter(int order) const;
+
+    QTcpServer *m_server = nullptr;
+    QList<QTcpSocket*> m_connections;
+    HttpClient *m_httpClient = nullptr;
+    ContentParser *m_parser = nullptr;
+    ChapterDownloader *m_downloader = nullptr;
+    BookSource m_source;
+};
+
+void ChapterDownloaderTest::init()
+{
+    m_server = new QTcpServer(this);
+    QVERIFY(m_server->listen(QHostAddress::LocalHost));
+    connect(m_server, &QTcpServer::newConnection, this, [this]() {
+        while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+            m_connections.append(socket);
+        }
+    });
+
+    m_source.setId(1);
+    m_source.setName("local");
+    m_source.setUrl(QString("http://127.0.0.1:%1/").arg(m_server->serverPort()));
+
+    m_httpClient = new HttpClient(this);
+    m_parser = new ContentParser(this);
+    m_downloader = new ChapterDownloader(this);
+    m_downloader->setHttpClient(m_httpClient);
+    m_downloader->setContentParser(m_parser);
+
+    DownloadConfig config;
+    config.maxConcurrent = 4;
+    config.requestInterval = 10;
+    config.maxRetries = 1;
+    config.enableSmartInterval = false;
+    m_downloader->setDownloadConfig(config);
+}
+
+void ChapterDownloaderTest::cleanup()
+{
+    // Dropped connections fail the waiting workers, so the pool drains
+    m_server->close();
+    for (QTcpSocket *socket : m_connections) {
+        socket->abort();
+    }
+    m_connections.clear();
+    m_downloader->stopDownload();
+
+    delete m_downloader;
+    m_downloader = nullptr;
+    delete m_parser;
+    m_parser = nullptr;
+    delete m_httpClient;
+    m_httpClient = nullptr;
+    delete m_server;
+    m_server = nullptr;
+}
+
+void ChapterDownloaderTest::tasksAddedDuringRunFillEverySlot()
+{
+    // As during a streamed TOC walk: the run starts with the first chapter and the rest follow
+    m_downloader->setMoreTasksExpected(true);
+    m_downloader->addDownloadTask(chapter(1), m_source);
+    m_downloader->startDownload();
+    QTRY_COMPARE(activeTasks(), 1);
+
+    for (int order = 2; order <= 6; ++order) {
+        m_downloader->addDownloadTask(chapter(order), m_source);
+    }
+
+    QTRY_COMPARE(activeTasks(), 4);
+    QTest::qWait(200);
+    QCOMPARE(activeTasks(), 4);     // Never past maxConcurrent
+}
+
+int ChapterDownloaderTest::activeTasks() const
+{
+    return m_downloader->getTasksByStatus(DownloadStatus::Downloading).size();
+}
+
+Chapter ChapterDownloaderTest::chapter(int order) const
+{
+    return Chapter(QString("%1%2.html").arg(m_source.url()).arg(order), QString("Chapter %1").arg(order), order);
+}
+
+QTEST_GUILESS_MAIN(ChapterDownloaderTest)
+#include "ChapterDownloaderTest.moc"
@@ -0,0 +1,102 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+std::atomic<quint64> g_allocations(0);
+std::atomic<quint64> g_bytes(0);
+
+inline void countAllocation(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_bytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+} // namespace
+
+#if defined(__GLIBC__)
+
+// Calls from Qt, Lexbor and libstdc++ resolve to these before libc's own
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    countAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+
+} // extern "C"
+
+bool AllocationCounter::coversMalloc()
+{
+    return true;
+}
+
+#else
+
+void *operator new(size_t size)
+{
+    countAllocation(size);
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+bool AllocationCounter::coversMalloc()
+{
+    return false;
+}
+
+#endif
+
+AllocationCounter::Snapshot AllocationCounter::snapshot()
+{
+    Snapshot snapshot;
+    snapshot.allocations = g_allocations.load(std::memory_order_relaxed);
+    snapshot.bytes = g_bytes.load(std::memory_order_relaxed);
+    return snapshot;
+}
@@ -0,0 +1,28 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+/**
+ * @brief Process-wide heap allocation counters for the parser benchmark
+ *
+ * With glibc, malloc, calloc and realloc are interposed, so operator new, Qt
+ * containers and Lexbor are all counted. Elsewhere only operator new is
+ * replaced, and the malloc calls of Qt containers and Lexbor go uncounted.
+ */
+namespace AllocationCounter
+{
+    struct Snapshot {
+        quint64 allocations = 0;
+        quint64 bytes = 0;
+    };
+
+    Snapshot snapshot();
+
+    /**
+     * @brief Whether C allocations are counted too, not only operator new
+     */
+    bool coversMalloc();
+}
+
+#endif // ALLOCATIONCOUNTER_H
@@ -0,0 +1,140 @@
+#include "LegacyParsers.h"
+#include <QRegularExpression>
+#include <QStringList>
+
+namespace {
+
+// ContentParser members, built once in its constructor
+const QRegularExpression &htmlTagRegex()
+{
+    static const QRegularExpression regex("<[^>]*>", QRegularExpression::CaseInsensitiveOption);
+    return regex;
+}
+
+const QRegularExpression &whitespaceRegex()
+{
+    static const QRegularExpression regex("\\s+");
+    return regex;
+}
+
+const QRegularExpression &invisibleRegex()
+{
+    static const QRegularExpression regex("[\\x00-\\x08\\x0B\\x0C\\x0E-\\x1F\\x7F]");
+    return regex;
+}
+
+QString cleanInvisibleChars(const QString &text)
+{
+    QString cleaned = text;
+    cleaned.remove(invisibleRegex());
+    return cleaned;
+}
+
+QString unescapeHtml(const QString &html)
+{
+    QString result = html;
+    result.replace("&amp;", "&");
+    result.replace("&lt;", "<");
+    result.replace("&gt;", ">");
+    result.replace("&quot;", "\"");
+    result.replace("&#39;", "'");
+    result.replace("&nbsp;", " ");
+    return result;
+}
+
+QString normalizeWhitespace(const QString &text)
+{
+    QString normalized = text;
+    normalized.replace(whitespaceRegex(), " ");
+    return normalized;
+}
+
+} // namespace
+
+QString LegacyParsers::preprocessHtml(const QString &html)
+{
+    QString processed = html;
+    processed = cleanInvisibleChars(processed);
+    processed.remove(QRegularExpression("<!--.*?-->", QRegularExpression::DotMatchesEverythingOption));
+    processed.replace(QRegularExpression("\\s+"), " ");
+    return processed;
+}
+
+QString LegacyParsers::formatChapterText(const QString &content, const ChapterRule &rule)
+{
+    QString formatted = content;
+
+    if (!rule.paragraphTag().isEmpty()) {
+        if (rule.paragraphTagClosed()) {
+            formatted.replace(QRegularExpression(QString("<%1[^>]*>").arg(rule.paragraphTag())), "\n");
+            formatted.replace(QRegularExpression(QString("</%1>").arg(rule.paragraphTag())), "");
+        } else {
+            formatted.replace(QRegularExpression(rule.paragraphTag()), "\n");
+        }
+    }
+
+    formatted.remove(htmlTagRegex());
+    formatted = unescapeHtml(formatted);
+    formatted = normalizeWhitespace(formatted);
+    formatted.remove(QRegularExpression("\\n\\s*\\n"));
+
+    return formatted.trimmed();
+}
+
+QString LegacyParsers::filterText(const QString &content, const QString &filterTxt)
+{
+    QString filtered = content;
+    if (!filterTxt.isEmpty()) {
+        QRegularExpression filterRegex(filterTxt);
+        if (filterRegex.isValid()) {
+            filtered.remove(filterRegex);
+        }
+    }
+    return filtered;
+}
+
+bool LegacyParsers::isNonChapterLink(const QString &title, const QString &url)
+{
+    QStringList nonChapterPatterns = {
+        "home", "index", "bookmark", "collect", "vote", "recommend",
+        "prev", "next", "return", "toc", "setting", "config",
+        "login", "register", "search", "rank", "category", "complete"
+    };
+
+    for (const QString &pattern : nonChapterPatterns) {
+        if (title.contains(pattern, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+
+    if (title.contains(QRegularExpression("[\u9996\u9875]")) ||      // "首页"
+        title.contains(QRegularExpression("[\u4e66\u67b6]")) ||      // "书架"
+        title.contains(QRegularExpression("[\u52a0\u5165]")) ||      // "加入"
+        title.contains(QRegularExpression("[\u6536\u85cf]")) ||      // "收藏"
+        title.contains(QRegularExpression("[\u767b\u5f55]")) ||      // "登录"
+        title.contains(QRegularExpression("[\u6ce8\u518c]")) ||      // "注册"
+        title.contains(QRegularExpression("[\u641c\u7d22]")) ||      // "搜索"
+        title.contains(QRegularExpression("[\u5c0f\u8bf4\u7f51]"))) { // "小说网"
+        return true;
+    }
+
+    QStringList nonChapterUrlPatterns = {
+        "javascript:", "mailto:", "#",
+        "/index", "/search", "/rank", "/category",
+        "/login", "/register", "/bookmark", "/vote"
+    };
+
+    for (const QString &pattern : nonChapterUrlPatterns) {
+        if (url.contains(pattern, Qt::CaseInsensitive)) {
+            return true;
+        }
+    }
+
+    if (!url.contains(QRegularExpression("\\d+")) && !url.contains("chapter", Qt::CaseInsensitive)) {
+        if (!title.contains(QRegularExpression("[\u7b2c\u5377].*[\u7ae0\u8282\u56de]"))) { // "第卷" + "章节回"
+            return true;
+        }
+    }
+
+    return false;
+}
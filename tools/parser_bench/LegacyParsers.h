@@ -0,0 +1,36 @@
+#ifndef LEGACYPARSERS_H
+#define LEGACYPARSERS_H
+
+#include <QString>
+#include "../../src/novel/NovelModels.h"
+
+/**
+ * @brief ContentParser's earlier regex-chain implementations, kept as benchmark baselines
+ *
+ * Copied from the code HtmlSanitizer, TextNormalizer, ContentFilter and
+ * ChapterLinkClassifier replaced, with the same regexes built at the same
+ * points: once per parser where ContentParser held them as members, on every
+ * call where it built them inline.
+ */
+namespace LegacyParsers
+{
+    /**
+     * @brief Old preprocessHtml: invisible characters, comments, whitespace runs
+     */
+    QString preprocessHtml(const QString &html);
+
+    /**
+     * @brief Old formatChapterContent after filterContent: paragraph tags,
+     *        tag removal, entities, whitespace
+     */
+    QString formatChapterText(const QString &content, const ChapterRule &rule);
+
+    /**
+     * @brief Old filterTxt handling: the whole alternation as one regex, compiled per call
+     */
+    QString filterText(const QString &content, const QString &filterTxt);
+
+    bool isNonChapterLink(const QString &title, const QString &url);
+}
+
+#endif // LEGACYPARSERS_H
@@ -0,0 +1,448 @@
+#include "PageCorpus.h"
+#include "../../src/network/CharsetDetector.h"
+#include "../../src/network/FixtureArchive.h"
+#include "../../src/parser/ContentFilter.h"
+#include <QRandomGenerator>
+#include <QTextCodec>
+#include <QUrl>
+#include <QDebug>
+
+namespace {
+
+const char *const PHRASES[] = {
+    "\u98ce\u4ece\u5c71\u8c37\u91cc\u5439\u4e0a\u6765\uff0c\u5e26\u7740\u677e\u9488\u7684\u6c14\u5473\u3002",  // "风从山谷里吹上来，带着松针的气味。"
+    "\u4ed6\u62ac\u8d77\u5934\uff0c\u770b\u89c1\u8fdc\u5904\u7684\u57ce\u5899\u5728\u66ae\u8272\u91cc\u6e10\u6e10\u6a21\u7cca\u3002",  // "他抬起头，看见远处的城墙在暮色里渐渐模糊。"
+    "\u5ba2\u6808\u91cc\u4eba\u58f0\u5608\u6742\uff0c\u9152\u9999\u548c\u996d\u83dc\u7684\u70ed\u6c14\u6df7\u5728\u4e00\u8d77\u3002",  // "客栈里人声嘈杂，酒香和饭菜的热气混在一起。"
+    "\u5c11\u5e74\u63e1\u7d27\u4e86\u624b\u4e2d\u7684\u5251\uff0c\u4e00\u8a00\u4e0d\u53d1\u5730\u8d70\u8fdb\u96e8\u91cc\u3002",  // "少年握紧了手中的剑，一言不发地走进雨里。"
+    "\u8001\u4eba\u7b11\u4e86\u7b11\uff0c\u628a\u8336\u676f\u63a8\u5230\u4ed6\u9762\u524d\u3002",  // "老人笑了笑，把茶杯推到他面前。"
+    "\u591c\u6df1\u4e86\uff0c\u53ea\u6709\u66f4\u592b\u7684\u6886\u5b50\u58f0\u5728\u8857\u5df7\u95f4\u56de\u8361\u3002",  // "夜深了，只有更夫的梆子声在街巷间回荡。"
+    "\u5979\u8f6c\u8eab\u79bb\u53bb\uff0c\u8863\u89d2\u5728\u98ce\u4e2d\u8f7b\u8f7b\u626c\u8d77\u3002",  // "她转身离去，衣角在风中轻轻扬起。"
+    "\u5c71\u8def\u873f\u8712\u5411\u4e0a\uff0c\u5c3d\u5934\u662f\u4e00\u5ea7\u7834\u65e7\u7684\u9053\u89c2\u3002"  // "山路蜿蜒向上，尽头是一座破旧的道观。"
+};
+
+const char *const TITLE_WORDS[] = {
+    "\u542f\u7a0b", "\u5c71\u884c", "\u5f52\u9014", "\u591c\u96e8",     // "启程" "山行" "归途" "夜雨"
+    "\u91cd\u9022", "\u8bd5\u5251", "\u95ee\u9053", "\u79bb\u522b"      // "重逢" "试剑" "问道" "离别"
+};
+
+const int PHRASE_COUNT = int(sizeof(PHRASES) / sizeof(PHRASES[0]));
+const int TITLE_WORD_COUNT = int(sizeof(TITLE_WORDS) / sizeof(TITLE_WORDS[0]));
+const int LATEST_CHAPTERS = 12;     // "最新章节" block above the full list
+
+QString text(const char *utf8)
+{
+    return QString::fromUtf8(utf8);
+}
+
+// Labels shared by the layouts
+const QString HOME = text("\u9996\u9875");                  // "首页"
+const QString BOOKSHELF = text("\u4e66\u67b6");             // "书架"
+const QString ADD_TO_SHELF = text("\u52a0\u5165\u4e66\u67b6");  // "加入书架"
+const QString RANKING = text("\u6392\u884c\u699c");         // "排行榜"
+const QString CHAPTER_INDEX = text("\u7ae0\u8282\u76ee\u5f55"); // "章节目录"
+const QString PREV_CHAPTER = text("\u4e0a\u4e00\u7ae0");    // "上一章"
+const QString NEXT_CHAPTER = text("\u4e0b\u4e00\u7ae0");    // "下一章"
+const QString NEXT_PAGE = text("\u4e0b\u4e00\u9875");       // "下一页"
+const QString MAIN_TEXT = text("\u6b63\u6587");             // "正文"
+const QString LATEST = text("\u6700\u65b0\u7ae0\u8282");    // "最新章节"
+const QString SERIALIZING = text("\u8fde\u8f7d");           // "连载"
+const QString CATEGORY = text("\u7384\u5e7b");              // "玄幻"
+const QString AUTHOR_LABEL = text("\u4f5c\u8005");          // "作者"
+const QString BOOK_NAME_LABEL = text("\u6587\u7ae0\u540d\u79f0");  // "文章名称"
+const QString UPDATED_LABEL = text("\u66f4\u65b0");         // "更新"
+const QString INTRO = text("\u57fa\u51c6\u6d4b\u8bd5\u7528\u7684\u5408\u6210\u4e66\u7c4d\uff0c\u7ae0\u8282\u4e0e\u6bb5\u843d\u7531\u751f\u6210\u5668\u6309\u89c4\u5219\u6784\u9020\u3002");  // "基准测试用的合成书籍，章节与段落由生成器按规则构造。"
+
+QString origin(const BookSource &source)
+{
+    const QUrl url(source.url());
+    return url.scheme() + "://" + url.host();
+}
+
+QString bookName(int book)
+{
+    return text("\u6d4b\u8bd5\u4e4b\u4e66") + QString::number(book + 1);     // "测试之书"
+}
+
+QString authorName(int book)
+{
+    return text("\u79bb\u7ebf\u4f5c\u8005") + QString::number(book % 7 + 1);  // "离线作者"
+}
+
+QString updateTime(int book)
+{
+    return QString("2024-05-%1").arg(book % 28 + 1, 2, 10, QChar('0'));
+}
+
+QString htmlHead(const QString &title, const QByteArray &charset, const QString &extra = QString())
+{
+    return QString("<!DOCTYPE html>\n<html><head>\n"
+                   "<meta http-equiv=\"Content-Type\" content=\"text/html; charset=%1\">\n"
+                   "<title>%2</title>\n%3"
+                   "<script type=\"text/javascript\">var _hmt = _hmt || []; function readbook() { if (document.cookie.length > 0) { return true; } return false; }</script>\n"
+                   "<style>body { margin: 0; } .box_con { border: 1px solid #88c6e5; } #list dd { width: 33%; float: left; }</style>\n"
+                   "</head>\n")
+        .arg(QString::fromLatin1(charset), title.toHtmlEscaped(), extra);
+}
+
+QString metaProperty(const QString &property, const QString &content)
+{
+    return QString("<meta property=\"%1\" content=\"%2\">\n").arg(property, content.toHtmlEscaped());
+}
+
+QString siteHeader()
+{
+    return QString("<div class=\"header\"><a href=\"/\">%1</a> <a href=\"/paihangbang/\">%2</a> "
+                   "<a href=\"/bookcase.php\">%3</a> <a href=\"/login.php\">login</a></div>\n"
+                   "<!-- header ad slot: <div class=\"ad\">...</div> -->\n")
+        .arg(HOME, RANKING, BOOKSHELF);
+}
+
+} // namespace
+
+/**
+ * @brief Deterministic text for the generated pages
+ */
+class PageCorpus::Writer
+{
+public:
+    explicit Writer(quint32 seed) : m_random(seed) {}
+
+    QString paragraph()
+    {
+        QString paragraph;
+        const int phrases = 1 + m_random.bounded(3);
+        for (int i = 0; i < phrases; ++i) {
+            paragraph += text(PHRASES[m_random.bounded(PHRASE_COUNT)]);
+        }
+        return paragraph;
+    }
+
+    static QString chapterTitle(int chapter)
+    {
+        return text("\u7b2c") + QString::number(chapter) + text("\u7ae0") + ' '    // "第" "章"
+            + text(TITLE_WORDS[chapter % TITLE_WORD_COUNT]);
+    }
+
+    /**
+     * @brief The literal slogans of a rule's filterTxt, so the filter has work to do
+     */
+    static QStringList slogans(const ChapterRule &rule)
+    {
+        QStringList slogans;
+        for (const QString &branch : ContentFilter::splitAlternatives(rule.filterTxt())) {
+            QString literal;
+            if (ContentFilter::toLiteral(branch, &literal) && !literal.isEmpty()) {
+                slogans.append(literal);
+            }
+        }
+        return slogans;
+    }
+
+    bool chance(int percent) { return int(m_random.bounded(100)) < percent; }
+
+private:
+    QRandomGenerator m_random;
+};
+
+PageCorpus::PageCorpus(const QList<BookSource> &sources)
+    : m_sources(sources)
+{
+}
+
+int PageCorpus::generate(const Options &options)
+{
+    const int before = m_pages.size();
+    Writer writer(options.seed);
+
+    for (const BookSource &source : m_sources) {
+        if (!source.searchRule() || !source.chapterRule()) {
+            qWarning() << "PageCorpus: Skipping" << source.name() << "- it lacks a search or chapter rule";
+            continue;
+        }
+        const QString key = sourceKey(source);
+        if (key.contains("biqu")) {
+            generateBiquge(source, options, writer);
+        } else if (key.contains("shuhaige")) {
+            generateShuhaige(source, options, writer);
+        } else {
+            qWarning() << "PageCorpus: No page layout for" << source.name() << source.url()
+                       << "- record its pages and pass --archive";
+        }
+    }
+    return m_pages.size() - before;
+}
+
+void PageCorpus::generateBiquge(const BookSource &source, const Options &options, Writer &writer)
+{
+    // www.xbiqugu.la: table search results, one "#list" with every chapter, <br> paragraphs
+    const QString site = origin(source);
+    const QStringList slogans = Writer::slogans(*source.chapterRule());
+    const int chapters = qMax(1, options.tocChapters);
+
+    for (int book = 0; book < options.books; ++book) {
+        // Search results page
+        QString search = htmlHead(QString("%1 - search").arg(bookName(book)), options.charset);
+        search += "<body>\n<div id=\"wrapper\">\n" + siteHeader();
+        search += "<form id=\"checkform\" method=\"post\" action=\"/modules/article/waps.php\">"
+                  "<table class=\"grid\" width=\"100%\" align=\"center\"><tbody>\n";
+        search += QString("<tr align=\"center\"><th>%1</th><th>%2</th><th>%3</th><th>%4</th></tr>\n")
+                      .arg(BOOK_NAME_LABEL, LATEST, AUTHOR_LABEL, UPDATED_LABEL);
+        for (int row = 0; row < options.searchRows; ++row) {
+            const int found = book * options.searchRows + row;
+            const QString bookUrl = QString("%1/%2/%3/").arg(site).arg(found % 50 + 1).arg(1001 + found);
+            search += QString("<tr><td class=\"even\"><a href=\"%1\">%2</a></td>"
+                              "<td class=\"odd\"><a href=\"%1%3.html\">%4</a></td>"
+                              "<td class=\"even\">%5</td><td class=\"odd\" align=\"center\">%6</td></tr>\n")
+                          .arg(bookUrl, bookName(found)).arg(chapters)
+                          .arg(Writer::chapterTitle(chapters), authorName(found), updateTime(found));
+        }
+        search += "</tbody></table></form>\n</div>\n</body></html>\n";
+        addPage(SearchPage, source, source.searchRule()->url(), search, options.charset);
+
+        // Book page with the chapter list
+        const QString bookPath = QString("/%1/%2/").arg(book % 50 + 1).arg(1001 + book);
+        const QString bookUrl = site + bookPath;
+        QString meta = metaProperty("og:type", "novel")
+                     + metaProperty("og:novel:book_name", bookName(book))
+                     + metaProperty("og:novel:author", authorName(book))
+                     + metaProperty("og:description", INTRO)
+                     + metaProperty("og:novel:category", CATEGORY)
+                     + metaProperty("og:image", QString("%1/files/article/image/%2.jpg").arg(site).arg(1001 + book));
+        QString page = htmlHead(bookName(book), options.charset, meta);
+        page += "<body>\n<div id=\"wrapper\">\n" + siteHeader();
+        page += QString("<div class=\"box_con\"><div id=\"maininfo\"><div id=\"info\"><h1>%1</h1>"
+                        "<p>%2&nbsp;:&nbsp;%3</p><p><a href=\"/modules/article/addbookcase.php?bid=%4\">%5</a></p></div>"
+                        "<div id=\"intro\"><p>%6</p></div></div></div>\n")
+                    .arg(bookName(book), AUTHOR_LABEL, authorName(book)).arg(1001 + book).arg(ADD_TO_SHELF, INTRO);
+        page += QString("<div class=\"box_con\"><div id=\"list\"><dl>\n<dt>%1</dt>\n").arg(MAIN_TEXT);
+        for (int chapter = 1; chapter <= chapters; ++chapter) {
+            page += QString("<dd><a href=\"%1%2.html\">%3</a></dd>\n").arg(bookPath).arg(chapter).arg(Writer::chapterTitle(chapter));
+        }
+        page += "</dl></div></div>\n";
+        page += QString("<div class=\"footer\"><a href=\"/\">%1</a></div>\n</div>\n</body></html>\n").arg(HOME);
+        addPage(BookPage, source, bookUrl, page, options.charset);
+        addPage(TocPage, source, bookUrl, page, options.charset);
+
+        // Chapters spread over the list
+        for (int sample = 0; sample < options.chaptersPerBook; ++sample) {
+            const int chapter = 1 + sample * chapters / qMax(1, options.chaptersPerBook);
+            const QString title = Writer::chapterTitle(chapter);
+            QString content = htmlHead(title, options.charset);
+            content += "<body>\n<div id=\"wrapper\">\n" + siteHeader();
+            content += QString("<div class=\"content_read\"><div class=\"box_con\">\n"
+                               "<div class=\"con_top\"><a href=\"/\">%1</a> &gt; <a href=\"%2\">%3</a> &gt; %4</div>\n"
+                               "<div class=\"bookname\"><h1>%4</h1>\n"
+                               "<div class=\"bottem1\"><a href=\"%2%5.html\">%6</a> &larr; <a href=\"%2\">%7</a> &rarr; "
+                               "<a href=\"%2%8.html\">%9</a></div></div>\n")
+                           .arg(HOME, bookPath, bookName(book), title).arg(qMax(1, chapter - 1))
+                           .arg(PREV_CHAPTER, CHAPTER_INDEX).arg(chapter + 1).arg(NEXT_CHAPTER);
+            content += "<div id=\"content\">";
+            for (int paragraph = 0; paragraph < options.paragraphs; ++paragraph) {
+                content += "&nbsp;&nbsp;&nbsp;&nbsp;" + writer.paragraph() + "<br />\n<br />\n";
+                if (!slogans.isEmpty() && writer.chance(5)) {
+                    content += slogans.first() + "<br />\n<br />\n";
+                }
+            }
+            if (!slogans.isEmpty()) {
+                content += QString("<p><a href=\"%1\" target=\"_blank\">%2</a></p>").arg(site, slogans.last());
+            }
+            content += "<script>app2();</script></div>\n";
+            content += QString("<div class=\"bottem2\"><a href=\"%1\">%2</a></div>\n</div></div>\n</div>\n</body></html>\n")
+                           .arg(bookPath, CHAPTER_INDEX);
+            addPage(ChapterPage, source, QString("%1%2.html").arg(bookUrl).arg(chapter), content, options.charset);
+        }
+    }
+}
+
+void PageCorpus::generateShuhaige(const BookSource &source, const Options &options, Writer &writer)
+{
+    // www.shuhaige.net: <dl> search results, "最新章节" block before the full list, <p> paragraphs split over "_2" pages
+    const QString site = origin(source);
+    const QStringList slogans = Writer::slogans(*source.chapterRule());
+    const int chapters = qMax(1, options.tocChapters);
+
+    for (int book = 0; book < options.books; ++book) {
+        // Search results page
+        QString search = htmlHead(QString("%1 - search").arg(bookName(book)), options.charset);
+        search += "<body>\n" + siteHeader() + "<div id=\"sitembox\">\n";
+        for (int row = 0; row < options.searchRows; ++row) {
+            const int found = book * options.searchRows + row;
+            const QString bookPath = QString("/%1/").arg(2001 + found);
+            search += QString("<dl><dt><a href=\"%1\"><img src=\"/files/%2.jpg\" alt=\"%3\"></a></dt>\n"
+                              "<dd><h3><a href=\"%1\">%3</a></h3></dd>\n"
+                              "<dd class=\"book_other\">%4: <span>%5</span> <span>%6</span> "
+                              "<span><a href=\"%1%7.html\">%8</a></span> <span>%9</span></dd>\n")
+                          .arg(bookPath).arg(2001 + found).arg(bookName(found), AUTHOR_LABEL, authorName(found), SERIALIZING)
+                          .arg(chapters).arg(Writer::chapterTitle(chapters), updateTime(found));
+            search += QString("<dd class=\"book_des\">%1</dd></dl>\n").arg(INTRO);
+        }
+        search += "</div>\n</body></html>\n";
+        addPage(SearchPage, source, source.searchRule()->url(), search, options.charset);
+
+        // Book page: latest chapters first, then the full list after the second <dt>
+        const QString bookPath = QString("/%1/").arg(2001 + book);
+        const QString bookUrl = site + bookPath;
+        QString meta = metaProperty("og:novel:book_name", bookName(book))
+                     + metaProperty("og:novel:author", authorName(book))
+                     + metaProperty("og:novel:category", CATEGORY)
+                     + metaProperty("og:image", QString("%1/files/%2.jpg").arg(site).arg(2001 + book))
+                     + metaProperty("og:novel:latest_chapter_name", Writer::chapterTitle(chapters))
+                     + metaProperty("og:novel:update_time", updateTime(book))
+                     + metaProperty("og:novel:status", SERIALIZING);
+        QString page = htmlHead(bookName(book), options.charset, meta);
+        page += "<body>\n" + siteHeader();
+        page += QString("<div class=\"book\"><div class=\"info\"><h2>%1</h2>"
+                        "<div id=\"intro\"><p>%2</p><p>%3</p></div></div></div>\n")
+                    .arg(bookName(book), INTRO, writer.paragraph());
+        page += QString("<div class=\"listmain\"><dl>\n<dt>%1</dt>\n").arg(LATEST);
+        for (int chapter = chapters; chapter > qMax(0, chapters - LATEST_CHAPTERS); --chapter) {
+            page += QString("<dd><a href=\"%1%2.html\">%3</a></dd>\n").arg(bookPath).arg(chapter).arg(Writer::chapterTitle(chapter));
+        }
+        page += QString("<dt>%1</dt>\n").arg(MAIN_TEXT);
+        for (int chapter = 1; chapter <= chapters; ++chapter) {
+            page += QString("<dd><a href=\"%1%2.html\">%3</a></dd>\n").arg(bookPath).arg(chapter).arg(Writer::chapterTitle(chapter));
+        }
+        page += "</dl></div>\n</body></html>\n";
+        addPage(BookPage, source, bookUrl, page, options.charset);
+        addPage(TocPage, source, bookUrl, page, options.charset);
+
+        // Chapters spread over the list, each on two pages
+        for (int sample = 0; sample < options.chaptersPerBook; ++sample) {
+            const int chapter = 1 + sample * chapters / qMax(1, options.chaptersPerBook);
+            const QString title = Writer::chapterTitle(chapter);
+            for (int subPage = 1; subPage <= 2; ++subPage) {
+                const QString pageUrl = subPage == 1 ? QString("%1%2.html").arg(bookUrl).arg(chapter)
+                                                     : QString("%1%2_2.html").arg(bookUrl).arg(chapter);
+                const QString nextUrl = subPage == 1 ? QString("%1%2_2.html").arg(bookPath).arg(chapter)
+                                                     : QString("%1%2.html").arg(bookPath).arg(chapter + 1);
+
+                QString content = htmlHead(title, options.charset);
+                content += "<body>\n" + siteHeader();
+                content += QString("<div class=\"book reader\"><div class=\"bookname\"><h1>%1</h1></div>\n"
+                                   "<div id=\"content\">").arg(title);
+                const int paragraphs = subPage == 1 ? (options.paragraphs + 1) / 2 : options.paragraphs / 2;
+                for (int paragraph = 0; paragraph < paragraphs; ++paragraph) {
+                    content += "<p>\u3000\u3000" + writer.paragraph() + "</p>";
+                }
+                if (subPage == 1 && !slogans.isEmpty()) {
+                    content += "<p>" + slogans.first() + "</p>";
+                }
+                content += "<div class=\"ad\"><script>ad();</script></div></div>\n";
+                content += QString("<div class=\"page_chapter\"><a href=\"%1\">%2</a> <a href=\"%3\">%4</a> "
+                                   "<a id=\"pager_next\" href=\"%5\">%6</a></div>\n</div>\n</body></html>\n")
+                               .arg(QString("%1%2.html").arg(bookPath).arg(qMax(1, chapter - 1)), PREV_CHAPTER,
+                                    bookPath, CHAPTER_INDEX, nextUrl, subPage == 1 ? NEXT_PAGE : NEXT_CHAPTER);
+                addPage(ChapterPage, source, pageUrl, content, options.charset);
+            }
+        }
+    }
+}
+
+int PageCorpus::loadArchive(const QString &directory, QString *error)
+{
+    FixtureArchive archive(directory);
+    if (!archive.load(error)) {
+        return -1;
+    }
+
+    int added = 0;
+    for (const FixtureArchive::Entry &indexed : archive.entries()) {
+        const BookSource *owner = nullptr;
+        for (const BookSource &source : m_sources) {
+            if (QUrl(source.url()).host().compare(indexed.url.host(), Qt::CaseInsensitive) == 0) {
+                owner = &source;
+                break;
+            }
+        }
+        if (!owner || indexed.statusCode != 200) {
+            continue;
+        }
+
+        FixtureArchive::Entry entry;
+        if (!archive.find(indexed.method, indexed.url, indexed.requestBody, &entry) || entry.body.isEmpty()) {
+            continue;
+        }
+        QByteArray contentType;
+        for (const auto &header : entry.headers) {
+            if (header.first.compare("Content-Type", Qt::CaseInsensitive) == 0) {
+                contentType = header.second;
+            }
+        }
+        const QByteArray charset = CharsetDetector::detect(entry.body, contentType);
+
+        // The search URL is the search page; directories are book pages; the rest are chapters
+        Page page;
+        page.sourceId = owner->id();
+        page.url = entry.url.toString();
+        page.body = entry.body;
+        page.charset = charset;
+        page.html = CharsetDetector::decode(entry.body, charset);
+
+        const QString path = entry.url.path();
+        if (entry.method == "POST" || (owner->searchRule() && path == QUrl(owner->searchRule()->url()).path())) {
+            page.kind = SearchPage;
+            m_pages.append(page);
+            ++added;
+        } else if (path.endsWith('/')) {
+            page.kind = BookPage;
+            m_pages.append(page);
+            page.kind = TocPage;
+            m_pages.append(page);
+            added += 2;
+        } else {
+            page.kind = ChapterPage;
+            m_pages.append(page);
+            ++added;
+        }
+    }
+    return added;
+}
+
+void PageCorpus::addPage(Kind kind, const BookSource &source, const QString &url, const QString &html, const QByteArray &charset)
+{
+    Page page;
+    page.kind = kind;
+    page.sourceId = source.id();
+    page.url = url;
+    page.charset = CharsetDetector::normalize(charset);
+
+    QTextCodec *codec = CharsetDetector::isUtf8(page.charset) ? nullptr : QTextCodec::codecForName(page.charset);
+    page.body = codec ? codec->fromUnicode(html) : html.toUtf8();
+    page.html = CharsetDetector::decode(page.body, page.charset);
+    m_pages.append(page);
+}
+
+QList<PageCorpus::Page> PageCorpus::pages(Kind kind, int sourceId) const
+{
+    QList<Page> result;
+    for (const Page &page : m_pages) {
+        if (page.kind == kind && page.sourceId == sourceId) {
+            result.append(page);
+        }
+    }
+    return result;
+}
+
+QString PageCorpus::sourceKey(const BookSource &source)
+{
+    // "www.xbiqugu.la" -> "xbiqugu"
+    QStringList labels = QUrl(source.url()).host().split('.', Qt::SkipEmptyParts);
+    if (labels.size() > 1) {
+        labels.removeLast();
+    }
+    if (labels.size() > 1 && labels.first() == "www") {
+        labels.removeFirst();
+    }
+    return labels.isEmpty() ? QString("source%1").arg(source.id()) : labels.join('.');
+}
+
+QString PageCorpus::kindName(Kind kind)
+{
+    switch (kind) {
+    case SearchPage:  return "search";
+    case BookPage:    return "book";
+    case TocPage:     return "toc";
+    case ChapterPage: return "chapter";
+    }
+    return QString();
+}
@@ -0,0 +1,86 @@
+#ifndef PAGECORPUS_H
+#define PAGECORPUS_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <QHash>
+#include "../../src/novel/NovelModels.h"
+
+/**
+ * @brief Search, book, TOC and chapter pages for the parser benchmark
+ *
+ * Pages are generated in memory from the layouts of the sites in
+ * resources/rules, so the corpus follows each rule's selectors without
+ * checked-in pages. Generation is deterministic: the same options give the
+ * same bytes. Recorded pages can be added from a fixture archive; they are
+ * assigned to a source by host and to a kind by URL.
+ *
+ * On these sites the book page carries the chapter list, so each book page is
+ * also a TOC page.
+ */
+class PageCorpus
+{
+public:
+    enum Kind {
+        SearchPage,
+        BookPage,
+        TocPage,
+        ChapterPage
+    };
+
+    struct Page {
+        Kind kind = SearchPage;
+        int sourceId = 0;
+        QString url;
+        QByteArray body;            // As served
+        QByteArray charset;
+        QString html;               // Body decoded once, for the QString entry points
+    };
+
+    struct Options {
+        int books = 4;              // Book pages, search pages and sampled chapters per source scale with this
+        int tocChapters = 3000;     // Links in each chapter list
+        int chaptersPerBook = 8;    // Chapter pages generated per book
+        int paragraphs = 40;        // Paragraphs per chapter page
+        int searchRows = 20;        // Results per search page
+        QByteArray charset = "utf-8";
+        quint32 seed = 1;
+    };
+
+    explicit PageCorpus(const QList<BookSource> &sources);
+
+    /**
+     * @brief Generate pages for every source with a known layout
+     * @return Number of pages added
+     */
+    int generate(const Options &options);
+
+    /**
+     * @brief Add the pages of a fixture archive recorded by HttpClient
+     * @return Number of pages added, or -1 if the archive cannot be read
+     */
+    int loadArchive(const QString &directory, QString *error = nullptr);
+
+    QList<BookSource> sources() const { return m_sources; }
+    QList<Page> pages(Kind kind, int sourceId) const;
+    int size() const { return m_pages.size(); }
+
+    /**
+     * @brief Short name of a source for reports, e.g. "xbiqugu"
+     */
+    static QString sourceKey(const BookSource &source);
+    static QString kindName(Kind kind);
+
+private:
+    class Writer;
+
+    void addPage(Kind kind, const BookSource &source, const QString &url, const QString &html, const QByteArray &charset);
+    void generateBiquge(const BookSource &source, const Options &options, Writer &writer);
+    void generateShuhaige(const BookSource &source, const Options &options, Writer &writer);
+
+    QList<BookSource> m_sources;
+    QList<Page> m_pages;
+};
+
+#endif // PAGECORPUS_H
@@ -0,0 +1,454 @@
+#include "ParserBench.h"
+#include "AllocationCounter.h"
+#include "LegacyParsers.h"
+#include "../../src/parser/HtmlSanitizer.h"
+#include "../../src/parser/TextNormalizer.h"
+#include "../../src/parser/ContentFilter.h"
+#include "../../src/parser/ChapterLinkClassifier.h"
+#include "../../src/parser/StreamingTocExtractor.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QHash>
+#include <QPair>
+#include <QRegularExpression>
+#include <memory>
+#include <vector>
+
+namespace {
+
+// QNetworkReply hands out about this much per readyRead
+const int STREAM_CHUNK_BYTES = 16 * 1024;
+
+// Keeps what the cases produce observable, so nothing is optimized away
+volatile qint64 g_produced = 0;
+
+qint64 totalBytes(const QList<PageCorpus::Page> &pages)
+{
+    qint64 bytes = 0;
+    for (const PageCorpus::Page &page : pages) {
+        bytes += page.body.size();
+    }
+    return bytes;
+}
+
+qint64 utf8Bytes(const QStringList &texts)
+{
+    qint64 bytes = 0;
+    for (const QString &text : texts) {
+        bytes += text.toUtf8().size();
+    }
+    return bytes;
+}
+
+QString ratio(double baseline, double current)
+{
+    if (baseline <= 0 || current <= 0) {
+        return QString("n/a");
+    }
+    return QString("%1x").arg(baseline / current, 0, 'f', 2);
+}
+
+} // namespace
+
+double ParserBench::Result::itemsPerSecond() const
+{
+    return nsecs > 0 ? items * 1e9 / nsecs : 0;
+}
+
+double ParserBench::Result::megabytesPerSecond() const
+{
+    return nsecs > 0 ? bytes * 1e9 / nsecs / (1024.0 * 1024.0) : 0;
+}
+
+double ParserBench::Result::allocationsPerItem() const
+{
+    return items > 0 ? double(allocations) / items : 0;
+}
+
+double ParserBench::Result::allocatedKBPerItem() const
+{
+    return items > 0 ? double(allocatedBytes) / items / 1024.0 : 0;
+}
+
+ParserBench::ParserBench(const PageCorpus &corpus, const Options &options)
+    : m_corpus(corpus)
+    , m_options(options)
+{
+    for (const BookSource &source : m_corpus.sources()) {
+        addSourceCases(source);
+    }
+}
+
+ParserBench::~ParserBench()
+{
+}
+
+QStringList ParserBench::caseNames() const
+{
+    QStringList names;
+    for (const Case &benchCase : m_cases) {
+        names.append(benchCase.name);
+    }
+    return names;
+}
+
+void ParserBench::addCase(const QString &name, const QString &unit, int items, qint64 bytes,
+                          std::function<qint64()> round, const QString &baseline)
+{
+    if (items == 0) {
+        return;
+    }
+    Case benchCase;
+    benchCase.name = name;
+    benchCase.unit = unit;
+    benchCase.baseline = baseline;
+    benchCase.items = items;
+    benchCase.bytes = bytes;
+    benchCase.round = std::move(round);
+    m_cases.append(benchCase);
+}
+
+void ParserBench::addSourceCases(const BookSource &source)
+{
+    // The entry points dereference every rule
+    if (!source.searchRule() || !source.bookRule() || !source.tocRule() || !source.chapterRule()) {
+        qWarning() << "ParserBench: Skipping" << source.name() << "- it lacks a search, book, TOC or chapter rule";
+        return;
+    }
+
+    const QString key = PageCorpus::sourceKey(source);
+    const QList<PageCorpus::Page> searchPages = m_corpus.pages(PageCorpus::SearchPage, source.id());
+    const QList<PageCorpus::Page> bookPages = m_corpus.pages(PageCorpus::BookPage, source.id());
+    const QList<PageCorpus::Page> tocPages = m_corpus.pages(PageCorpus::TocPage, source.id());
+    const QList<PageCorpus::Page> chapterPages = m_corpus.pages(PageCorpus::ChapterPage, source.id());
+    const ChapterRule chapterRule = *source.chapterRule();
+    const TocRule tocRule = *source.tocRule();
+    ContentParser *parser = &m_parser;
+
+    // ContentParser entry points, as the search and download paths call them
+
+    addCase("parseSearchResults/" + key, "pages", searchPages.size(), totalBytes(searchPages),
+            [parser, source, searchPages]() {
+        qint64 produced = 0;
+        for (const PageCorpus::Page &page : searchPages) {
+            produced += parser->parseSearchResults(page.body, page.charset, source, page.url).size();
+        }
+        return produced;
+    });
+
+    addCase("parseBookDetails/" + key, "pages", bookPages.size(), totalBytes(bookPages),
+            [parser, source, bookPages]() {
+        qint64 produced = 0;
+        for (const PageCorpus::Page &page : bookPages) {
+            produced += parser->parseBookDetails(page.html, source, page.url).bookName().size();
+        }
+        return produced;
+    });
+
+    addCase("parseChapterList/" + key, "pages", tocPages.size(), totalBytes(tocPages),
+            [parser, tocRule, tocPages]() {
+        qint64 produced = 0;
+        for (const PageCorpus::Page &page : tocPages) {
+            produced += parser->parseChapterList(page.body, page.charset, tocRule, page.url).size();
+        }
+        return produced;
+    });
+
+    addCase("parseChapterContent/" + key, "pages", chapterPages.size(), totalBytes(chapterPages),
+            [parser, chapterRule, chapterPages]() {
+        qint64 produced = 0;
+        for (const PageCorpus::Page &page : chapterPages) {
+            produced += parser->parseChapterContent(page.body, page.charset, chapterRule).size();
+        }
+        return produced;
+    });
+
+    // The chapter body as the content selector finds it, text and HTML
+    QStringList contentTexts;
+    QStringList contentHtml;
+    for (const PageCorpus::Page &page : chapterPages) {
+        LexborHtmlParser document;
+        if (!document.parseHtml(page.body, page.charset)) {
+            continue;
+        }
+        const QList<LexborHtmlParser::ElementInfo> matches = document.selectElementsWithInfo(chapterRule.content());
+        if (!matches.isEmpty()) {
+            contentTexts.append(matches.first().textContent);
+            contentHtml.append(LexborHtmlParser::htmlOf(matches.first().node));
+        }
+    }
+
+    addCase("cleanText/" + key, "texts", contentTexts.size(), utf8Bytes(contentTexts),
+            [parser, contentTexts]() {
+        qint64 produced = 0;
+        for (const QString &text : contentTexts) {
+            produced += parser->cleanText(text).size();
+        }
+        return produced;
+    });
+
+    // Selector queries on documents parsed beforehand, and every link on them
+    std::vector<std::shared_ptr<LexborHtmlParser>> tocDocuments;
+    QList<QPair<QString, QString>> links;
+    for (const PageCorpus::Page &page : tocPages) {
+        std::shared_ptr<LexborHtmlParser> document = std::make_shared<LexborHtmlParser>();
+        if (!document->parseHtml(page.body, page.charset)) {
+            continue;
+        }
+        for (const LexborHtmlParser::ElementInfo &link : document->selectElementsWithInfo("a")) {
+            links.append(qMakePair(link.textContent.trimmed(), LexborHtmlParser::attributeOf(link.node, "href")));
+        }
+        tocDocuments.push_back(document);
+    }
+
+    addCase("selectElementsWithInfo/" + key, "pages", int(tocDocuments.size()), totalBytes(tocPages),
+            [tocDocuments, tocRule]() {
+        qint64 produced = 0;
+        for (const std::shared_ptr<LexborHtmlParser> &document : tocDocuments) {
+            produced += document->selectElementsWithInfo(tocRule.item()).size();
+        }
+        return produced;
+    });
+
+    // Replacements measured against the code they replaced
+
+    QStringList allHtml;
+    for (const QList<PageCorpus::Page> &pages : {searchPages, bookPages, chapterPages}) {
+        for (const PageCorpus::Page &page : pages) {
+            allHtml.append(page.html);
+        }
+    }
+    addCase("legacy/preprocessHtml/" + key, "pages", allHtml.size(), utf8Bytes(allHtml), [allHtml]() {
+        qint64 produced = 0;
+        for (const QString &html : allHtml) {
+            produced += LegacyParsers::preprocessHtml(html).size();
+        }
+        return produced;
+    });
+    addCase("HtmlSanitizer/" + key, "pages", allHtml.size(), utf8Bytes(allHtml), [allHtml]() {
+        qint64 produced = 0;
+        for (const QString &html : allHtml) {
+            produced += HtmlSanitizer::sanitize(html, HtmlSanitizer::StripControlChars
+                                                      | HtmlSanitizer::StripComments
+                                                      | HtmlSanitizer::CollapseWhitespace).size();
+        }
+        return produced;
+    }, "legacy/preprocessHtml/" + key);
+
+    addCase("legacy/formatChapterText/" + key, "texts", contentHtml.size(), utf8Bytes(contentHtml),
+            [contentHtml, chapterRule]() {
+        qint64 produced = 0;
+        for (const QString &html : contentHtml) {
+            produced += LegacyParsers::formatChapterText(html, chapterRule).size();
+        }
+        return produced;
+    });
+    addCase("TextNormalizer/" + key, "texts", contentHtml.size(), utf8Bytes(contentHtml),
+            [contentHtml, chapterRule]() {
+        // formatChapterContent after its filter step
+        qint64 produced = 0;
+        for (const QString &html : contentHtml) {
+            QString formatted = html;
+            QString breakTag;
+            if (!chapterRule.paragraphTag().isEmpty()) {
+                if (chapterRule.paragraphTagClosed()) {
+                    breakTag = chapterRule.paragraphTag();
+                } else {
+                    formatted.replace(QRegularExpression(chapterRule.paragraphTag()), "\n");
+                }
+            }
+            produced += TextNormalizer::normalize(formatted, TextNormalizer::ChapterText, breakTag).size();
+        }
+        return produced;
+    }, "legacy/formatChapterText/" + key);
+
+    if (!chapterRule.filterTxt().isEmpty()) {
+        const QString filterTxt = chapterRule.filterTxt();
+        addCase("legacy/filterTxt/" + key, "texts", contentHtml.size(), utf8Bytes(contentHtml),
+                [contentHtml, filterTxt]() {
+            qint64 produced = 0;
+            for (const QString &html : contentHtml) {
+                produced += LegacyParsers::filterText(html, filterTxt).size();
+            }
+            return produced;
+        });
+        addCase("ContentFilter/" + key, "texts", contentHtml.size(), utf8Bytes(contentHtml),
+                [contentHtml, filterTxt]() {
+            qint64 produced = 0;
+            for (const QString &html : contentHtml) {
+                produced += ContentFilter::forRule(filterTxt)->apply(html).size();
+            }
+            return produced;
+        }, "legacy/filterTxt/" + key);
+    }
+
+    qint64 linkBytes = 0;
+    for (const QPair<QString, QString> &link : links) {
+        linkBytes += link.first.toUtf8().size() + link.second.toUtf8().size();
+    }
+    addCase("legacy/isNonChapterLink/" + key, "links", links.size(), linkBytes, [links]() {
+        qint64 produced = 0;
+        for (const QPair<QString, QString> &link : links) {
+            produced += LegacyParsers::isNonChapterLink(link.first, link.second) ? 0 : 1;
+        }
+        return produced;
+    });
+    addCase("ChapterLinkClassifier/" + key, "links", links.size(), linkBytes, [links]() {
+        const ChapterLinkClassifier &classifier = ChapterLinkClassifier::instance();
+        qint64 produced = 0;
+        for (const QPair<QString, QString> &link : links) {
+            produced += classifier.isNonChapterLink(link.first, link.second) ? 0 : 1;
+        }
+        return produced;
+    }, "legacy/isNonChapterLink/" + key);
+
+    // The token-stream TOC path against the DOM path it bypasses
+    if (StreamingTocExtractor::isStreamable(tocRule.item())) {
+        std::shared_ptr<StreamingTocExtractor> extractor = std::make_shared<StreamingTocExtractor>(tocRule.item());
+        addCase("StreamingTocExtractor/" + key, "pages", tocPages.size(), totalBytes(tocPages),
+                [parser, extractor, tocPages]() {
+            qint64 produced = 0;
+            QString baseUrl;
+            extractor->setLinkCallback([parser, &produced, &baseUrl](const QString &title, const QString &href) {
+                Chapter chapter;
+                if (parser->tocLinkToChapter(title, href, baseUrl, &chapter)) {
+                    ++produced;
+                }
+            });
+            for (const PageCorpus::Page &page : tocPages) {
+                baseUrl = page.url;
+                extractor->begin(page.charset);
+                for (int offset = 0; offset < page.body.size(); offset += STREAM_CHUNK_BYTES) {
+                    const int size = qMin(STREAM_CHUNK_BYTES, page.body.size() - offset);
+                    extractor->feed(page.body.constData() + offset, size_t(size));
+                }
+                extractor->end();
+            }
+            extractor->setLinkCallback(nullptr);
+            return produced;
+        }, "parseChapterList/" + key);
+    }
+}
+
+QList<ParserBench::Result> ParserBench::run()
+{
+    QList<Result> results;
+    for (const Case &benchCase : m_cases) {
+        if (!m_options.filter.isEmpty() && !benchCase.name.contains(m_options.filter, Qt::CaseInsensitive)) {
+            continue;
+        }
+        results.append(measure(benchCase));
+    }
+    return results;
+}
+
+ParserBench::Result ParserBench::measure(const Case &benchCase) const
+{
+    Result result;
+    result.name = benchCase.name;
+    result.unit = benchCase.unit;
+    result.baseline = benchCase.baseline;
+
+    // Warm-up: thread parsers, selector and filter caches, lazy statics
+    result.empty = benchCase.round() == 0;
+
+    qint64 produced = 0;
+    const AllocationCounter::Snapshot before = AllocationCounter::snapshot();
+    QElapsedTimer timer;
+    timer.start();
+    do {
+        produced += benchCase.round();
+        ++result.rounds;
+    } while (timer.elapsed() < m_options.minTimeMs || result.rounds < m_options.minRounds);
+    result.nsecs = timer.nsecsElapsed();
+    const AllocationCounter::Snapshot after = AllocationCounter::snapshot();
+
+    result.items = qint64(result.rounds) * benchCase.items;
+    result.bytes = qint64(result.rounds) * benchCase.bytes;
+    result.allocations = after.allocations - before.allocations;
+    result.allocatedBytes = after.bytes - before.bytes;
+    g_produced = g_produced + produced;
+    return result;
+}
+
+void ParserBench::printReport(const QList<Result> &results, QTextStream &out)
+{
+    out << QString("%1 %2 %3 %4 %5\n")
+               .arg("Case", -44).arg("Rate", 20).arg("MB/s", 9).arg("Allocs/item", 12).arg("KB alloc/item", 14);
+
+    QHash<QString, Result> byName;
+    for (const Result &result : results) {
+        byName.insert(result.name, result);
+        out << QString("%1 %2 %3/s %4 %5 %6%7\n")
+                   .arg(result.name, -44)
+                   .arg(result.itemsPerSecond(), 12, 'f', 1).arg(result.unit, -5)
+                   .arg(result.megabytesPerSecond(), 9, 'f', 2)
+                   .arg(result.allocationsPerItem(), 12, 'f', 1)
+                   .arg(result.allocatedKBPerItem(), 14, 'f', 1)
+                   .arg(result.empty ? "  (no output: corpus does not fit the rules)" : "");
+    }
+
+    bool header = false;
+    for (const Result &result : results) {
+        if (result.baseline.isEmpty() || !byName.contains(result.baseline)) {
+            continue;
+        }
+        if (!header) {
+            out << "\nAgainst the code they replaced:\n";
+            header = true;
+        }
+        const Result &baseline = byName[result.baseline];
+        const double baselineNsecs = baseline.items > 0 ? double(baseline.nsecs) / baseline.items : 0;
+        const double currentNsecs = result.items > 0 ? double(result.nsecs) / result.items : 0;
+        out << QString("  %1 vs %2: %3 faster, %4 fewer allocations\n")
+                   .arg(result.name, baseline.name)
+                   .arg(ratio(baselineNsecs, currentNsecs))
+                   .arg(ratio(baseline.allocationsPerItem(), result.allocationsPerItem()));
+    }
+    out.flush();
+}
+
+bool ParserBench::writeJson(const QList<Result> &results, const QString &filePath, QString *error)
+{
+    QJsonArray cases;
+    for (const Result &result : results) {
+        QJsonObject json;
+        json["name"] = result.name;
+        json["unit"] = result.unit;
+        if (!result.baseline.isEmpty()) {
+            json["baseline"] = result.baseline;
+        }
+        json["rounds"] = result.rounds;
+        json["itemsPerSecond"] = result.itemsPerSecond();
+        json["megabytesPerSecond"] = result.megabytesPerSecond();
+        json["allocationsPerItem"] = result.allocationsPerItem();
+        json["allocatedKBPerItem"] = result.allocatedKBPerItem();
+        json["empty"] = result.empty;
+        cases.append(json);
+    }
+
+    QJsonObject root;
+    root["version"] = 1;
+    root["countsMalloc"] = AllocationCounter::coversMalloc();
+    root["cases"] = cases;
+
+    QSaveFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error) {
+            *error = QString("Cannot write %1: %2").arg(filePath, file.errorString());
+        }
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    if (!file.commit()) {
+        if (error) {
+            *error = QString("Cannot write %1: %2").arg(filePath, file.errorString());
+        }
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef PARSERBENCH_H
+#define PARSERBENCH_H
+
+#include <QString>
+#include <QStringList>
+#include <QList>
+#include <QTextStream>
+#include <functional>
+#include "PageCorpus.h"
+#include "../../src/parser/ContentParser.h"
+
+/**
+ * @brief Timed runs of ContentParser entry points over a PageCorpus
+ *
+ * Each case runs over all of its pages once as a warm-up, then in rounds
+ * until both the minimum time and the minimum round count are reached. Only
+ * the timed rounds count towards throughput and allocations. Cases that
+ * replaced an older implementation are paired with it, and the report prints
+ * the speed-up.
+ */
+class ParserBench
+{
+public:
+    struct Options {
+        qint64 minTimeMs = 500;     // Timed per case
+        int minRounds = 3;
+        QString filter;             // Run only cases whose name contains this
+    };
+
+    struct Result {
+        QString name;               // "entry point/source", e.g. "parseChapterList/xbiqugu"
+        QString unit;               // What one item is: "pages", "texts", "links"
+        QString baseline;           // Case this one is compared against, if any
+        int rounds = 0;
+        qint64 items = 0;           // Over all timed rounds
+        qint64 bytes = 0;
+        qint64 nsecs = 0;
+        quint64 allocations = 0;
+        quint64 allocatedBytes = 0;
+        bool empty = false;         // Produced nothing: the corpus does not fit the rules
+
+        double itemsPerSecond() const;
+        double megabytesPerSecond() const;
+        double allocationsPerItem() const;
+        double allocatedKBPerItem() const;
+    };
+
+    ParserBench(const PageCorpus &corpus, const Options &options);
+    ~ParserBench();
+
+    QStringList caseNames() const;
+    QList<Result> run();
+
+    static void printReport(const QList<Result> &results, QTextStream &out);
+    static bool writeJson(const QList<Result> &results, const QString &filePath, QString *error = nullptr);
+
+private:
+    struct Case {
+        QString name;
+        QString unit;
+        QString baseline;
+        int items = 0;              // Per round
+        qint64 bytes = 0;           // Input bytes per round
+        std::function<qint64()> round;  // Runs every item once; returns how much it produced
+    };
+
+    Q_DISABLE_COPY(ParserBench)
+
+    void addCase(const QString &name, const QString &unit, int items, qint64 bytes,
+                 std::function<qint64()> round, const QString &baseline = QString());
+    void addSourceCases(const BookSource &source);
+    Result measure(const Case &benchCase) const;
+
+    const PageCorpus &m_corpus;
+    Options m_options;
+    ContentParser m_parser;
+    QList<Case> m_cases;
+};
+
+#endif // PARSERBENCH_H
@@ -0,0 +1,125 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QDebug>
+
+#include "AllocationCounter.h"
+#include "PageCorpus.h"
+#include "ParserBench.h"
+#include "../../src/parser/RuleManager.h"
+
+namespace {
+
+bool g_verbose = false;
+
+// The parser logs per page; only warnings matter while timing
+void benchMessageHandler(QtMsgType type, const QMessageLogContext &, const QString &message)
+{
+    if (type == QtDebugMsg && !g_verbose) {
+        return;
+    }
+    QTextStream(stderr) << message << '\n';
+}
+
+} // namespace
+
+// Times ContentParser over generated pages for every source in a rule file:
+//   ParserBench --rules resources/rules/test-rules.json --toc-chapters 5000 --charset gbk
+//   ParserBench --archive tools/replay_server/fixtures --no-generate --filter xbiqugu
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ParserBench");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Measures ContentParser throughput and allocations over a page corpus");
+    parser.addHelpOption();
+
+    const PageCorpus::Options defaults;
+    const QCommandLineOption rulesOption("rules", "Rule file whose sources are benchmarked.", "file", "resources/rules/test-rules.json");
+    const QCommandLineOption archiveOption("archive", "Also benchmark the pages of a fixture archive.", "dir");
+    const QCommandLineOption noGenerateOption("no-generate", "Use only the archive pages.");
+    const QCommandLineOption booksOption("books", "Generated books per source.", "n", QString::number(defaults.books));
+    const QCommandLineOption tocOption("toc-chapters", "Links in each generated chapter list.", "n", QString::number(defaults.tocChapters));
+    const QCommandLineOption chaptersOption("chapters", "Generated chapter pages per book.", "n", QString::number(defaults.chaptersPerBook));
+    const QCommandLineOption paragraphsOption("paragraphs", "Paragraphs per generated chapter.", "n", QString::number(defaults.paragraphs));
+    const QCommandLineOption rowsOption("search-rows", "Results per generated search page.", "n", QString::number(defaults.searchRows));
+    const QCommandLineOption charsetOption("charset", "Encoding of the generated pages, e.g. gbk.", "charset", QString::fromLatin1(defaults.charset));
+    const QCommandLineOption seedOption("seed", "Seed for the generated text.", "seed", QString::number(defaults.seed));
+    const QCommandLineOption timeOption("min-time", "Minimum timed duration per case, in ms.", "ms", "500");
+    const QCommandLineOption roundsOption("min-rounds", "Minimum timed rounds per case.", "n", "3");
+    const QCommandLineOption filterOption("filter", "Run only cases whose name contains this text.", "text");
+    const QCommandLineOption listOption("list", "List the cases and exit.");
+    const QCommandLineOption jsonOption("json", "Also write the results to this file.", "file");
+    const QCommandLineOption verboseOption("verbose", "Keep the parser's debug output.");
+    parser.addOptions({rulesOption, archiveOption, noGenerateOption, booksOption, tocOption, chaptersOption,
+                       paragraphsOption, rowsOption, charsetOption, seedOption, timeOption, roundsOption,
+                       filterOption, listOption, jsonOption, verboseOption});
+    parser.process(app);
+
+    g_verbose = parser.isSet(verboseOption);
+    qInstallMessageHandler(benchMessageHandler);
+
+    RuleManager ruleManager;
+    if (!ruleManager.loadRulesFromFile(parser.value(rulesOption))) {
+        qCritical() << "ParserBench:" << ruleManager.getLastError();
+        return 1;
+    }
+
+    PageCorpus corpus(ruleManager.getAllSources());
+    if (!parser.isSet(noGenerateOption)) {
+        PageCorpus::Options options;
+        options.books = qMax(1, parser.value(booksOption).toInt());
+        options.tocChapters = qMax(1, parser.value(tocOption).toInt());
+        options.chaptersPerBook = qMax(1, parser.value(chaptersOption).toInt());
+        options.paragraphs = qMax(1, parser.value(paragraphsOption).toInt());
+        options.searchRows = qMax(1, parser.value(rowsOption).toInt());
+        options.charset = parser.value(charsetOption).toLatin1();
+        options.seed = parser.value(seedOption).toUInt();
+        corpus.generate(options);
+    }
+    if (parser.isSet(archiveOption)) {
+        QString error;
+        if (corpus.loadArchive(parser.value(archiveOption), &error) < 0) {
+            qCritical() << "ParserBench:" << error;
+            return 1;
+        }
+    }
+    if (corpus.size() == 0) {
+        qCritical() << "ParserBench: No pages to benchmark";
+        return 1;
+    }
+
+    ParserBench::Options benchOptions;
+    benchOptions.minTimeMs = qMax(1, parser.value(timeOption).toInt());
+    benchOptions.minRounds = qMax(1, parser.value(roundsOption).toInt());
+    benchOptions.filter = parser.value(filterOption);
+    ParserBench bench(corpus, benchOptions);
+
+    QTextStream out(stdout);
+    if (parser.isSet(listOption)) {
+        for (const QString &name : bench.caseNames()) {
+            out << name << '\n';
+        }
+        return 0;
+    }
+
+    out << "ParserBench: " << corpus.size() << " pages from " << corpus.sources().size() << " sources\n";
+    if (!AllocationCounter::coversMalloc()) {
+        out << "ParserBench: Only operator new is counted on this platform; Qt and Lexbor buffers are not\n";
+    }
+    out << '\n';
+    out.flush();
+
+    const QList<ParserBench::Result> results = bench.run();
+    ParserBench::printReport(results, out);
+
+    if (parser.isSet(jsonOption)) {
+        QString error;
+        if (!ParserBench::writeJson(results, parser.value(jsonOption), &error)) {
+            qCritical() << "ParserBench:" << error;
+            return 1;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,283 @@
+#include "ReplayServer.h"
+#include <QTimer>
+#include <QDateTime>
+#include <QDebug>
+
+namespace {
+
+QByteArray reasonPhrase(int status)
+{
+    switch (status) {
+    case 200: return "OK";
+    case 301: return "Moved Permanently";
+    case 302: return "Found";
+    case 304: return "Not Modified";
+    case 400: return "Bad Request";
+    case 403: return "Forbidden";
+    case 404: return "Not Found";
+    case 429: return "Too Many Requests";
+    case 500: return "Internal Server Error";
+    case 502: return "Bad Gateway";
+    case 503: return "Service Unavailable";
+    case 504: return "Gateway Timeout";
+    default: return "Status";
+    }
+}
+
+const int MAX_HEADER_BYTES = 64 * 1024;
+const int THROTTLE_TICK_MS = 50;
+
+} // namespace
+
+ReplayServer::ReplayServer(FixtureArchive *archive, const Options &options, QObject *parent)
+    : QTcpServer(parent)
+    , m_archive(archive)
+    , m_options(options)
+    , m_randomState(options.seed != 0 ? options.seed : quint64(QDateTime::currentMSecsSinceEpoch()))
+    , m_served(0)
+{
+}
+
+void ReplayServer::incomingConnection(qintptr socketDescriptor)
+{
+    QTcpSocket *socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        socket->deleteLater();
+        return;
+    }
+
+    m_connections.insert(socket, Connection());
+    connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+    connect(socket, &QTcpSocket::disconnected, this, [this, socket]() {
+        m_connections.remove(socket);
+        socket->deleteLater();
+    });
+}
+
+void ReplayServer::onReadyRead(QTcpSocket *socket)
+{
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) {
+        return;
+    }
+    it->buffer.append(socket->readAll());
+
+    // One request at a time per connection; pipelined requests wait in the buffer
+    if (it->busy) {
+        return;
+    }
+
+    Request request;
+    bool malformed = false;
+    if (!takeRequest(it->buffer, &request, &malformed)) {
+        if (malformed) {
+            // The stream cannot be resynchronised: answer once, unthrottled, and drop the connection
+            const QByteArray body("Malformed request\n");
+            socket->write("HTTP/1.1 400 " + reasonPhrase(400) + "\r\nContent-Type: text/plain; charset=utf-8\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\nConnection: close\r\n\r\n" + body);
+            socket->flush();
+            m_connections.remove(socket);
+            socket->abort();
+            socket->deleteLater();
+        }
+        return;
+    }
+
+    it->busy = true;
+    respond(socket, request);
+}
+
+bool ReplayServer::takeRequest(QByteArray &buffer, Request *request, bool *malformed)
+{
+    const int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        *malformed = buffer.size() > MAX_HEADER_BYTES;
+        return false;
+    }
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() != 3) {
+        *malformed = true;
+        return false;
+    }
+
+    request->method = requestLine[0].toUpper();
+    const QByteArray target = requestLine[1];
+    request->keepAlive = requestLine[2].trimmed() != "HTTP/1.0";
+
+    QByteArray host;
+    QByteArray fixtureUrl;
+    int contentLength = 0;
+    for (int i = 1; i < lines.size(); ++i) {
+        const QByteArray line = lines[i].trimmed();
+        const int colon = line.indexOf(':');
+        if (colon <= 0) {
+            continue;
+        }
+        const QByteArray name = line.left(colon).trimmed().toLower();
+        const QByteArray value = line.mid(colon + 1).trimmed();
+        if (name == "host") {
+            host = value;
+        } else if (name == "content-length") {
+            contentLength = value.toInt();
+        } else if (name == "x-fixture-url") {
+            fixtureUrl = value;
+        } else if (name == "connection" || name == "proxy-connection") {
+            const QByteArray token = value.toLower();
+            if (token == "close") {
+                request->keepAlive = false;
+            } else if (token == "keep-alive") {
+                request->keepAlive = true;
+            }
+        }
+    }
+
+    const int bodyStart = headerEnd + 4;
+    if (buffer.size() - bodyStart < contentLength) {
+        return false;   // Body still arriving
+    }
+    request->body = buffer.mid(bodyStart, contentLength);
+    buffer.remove(0, bodyStart + contentLength);
+
+    // X-Fixture-Url keeps the original scheme; proxied requests use the absolute form
+    if (!fixtureUrl.isEmpty()) {
+        request->url = QUrl::fromEncoded(fixtureUrl);
+    } else if (target.startsWith("http://") || target.startsWith("https://")) {
+        request->url = QUrl::fromEncoded(target);
+    } else {
+        request->url = QUrl::fromEncoded("http://" + host + target);
+    }
+
+    if (!request->url.isValid()) {
+        *malformed = true;
+        return false;
+    }
+    return true;
+}
+
+void ReplayServer::respond(QTcpSocket *socket, const Request &request)
+{
+    int delayMs = m_options.latencyMs;
+    if (m_options.jitterMs > 0) {
+        delayMs += int(nextRandom() * (m_options.jitterMs + 1));
+    }
+
+    QPointer<QTcpSocket> guard(socket);
+    QTimer::singleShot(delayMs, this, [this, guard, request]() {
+        if (!guard) {
+            return;
+        }
+        QTcpSocket *socket = guard.data();
+
+        if (m_options.dropRate > 0.0 && nextRandom() < m_options.dropRate) {
+            qDebug() << "ReplayServer: Dropping" << request.method << request.url.toString();
+            m_connections.remove(socket);
+            socket->abort();
+            socket->deleteLater();
+            return;
+        }
+
+        if (m_options.errorRate > 0.0 && nextRandom() < m_options.errorRate) {
+            qDebug() << "ReplayServer: Injecting" << m_options.errorStatus << "for" << request.url.toString();
+            writeResponse(socket, m_options.errorStatus, {{"Content-Type", "text/plain; charset=utf-8"}},
+                          QByteArray("Injected failure\n"), request.keepAlive);
+            return;
+        }
+
+        FixtureArchive::Entry entry;
+        if (!m_archive->find(request.method, request.url, request.body, &entry)) {
+            qDebug() << "ReplayServer: No fixture for" << request.method << request.url.toString();
+            writeResponse(socket, 404, {{"Content-Type", "text/plain; charset=utf-8"}},
+                          QByteArray("No fixture for ") + request.url.toEncoded() + '\n', request.keepAlive);
+            return;
+        }
+
+        m_served++;
+        writeResponse(socket, entry.statusCode, entry.headers, entry.body, request.keepAlive);
+    });
+}
+
+void ReplayServer::writeResponse(QTcpSocket *socket, int status,
+                                 const QList<QPair<QByteArray, QByteArray>> &headers,
+                                 const QByteArray &body, bool keepAlive)
+{
+    QByteArray head = "HTTP/1.1 " + QByteArray::number(status) + ' ' + reasonPhrase(status) + "\r\n";
+    for (const auto &header : headers) {
+        const QByteArray name = header.first.toLower();
+        if (name == "content-length" || name == "connection" || name == "transfer-encoding") {
+            continue;
+        }
+        // Qt joins repeated headers (Set-Cookie) with newlines: send one line per value
+        for (const QByteArray &value : header.second.split('\n')) {
+            head += header.first + ": " + value + "\r\n";
+        }
+    }
+    head += "Content-Length: " + QByteArray::number(body.size()) + "\r\n";
+    head += keepAlive ? "Connection: keep-alive\r\n" : "Connection: close\r\n";
+    head += "\r\n";
+
+    if (m_options.bandwidthKBps <= 0) {
+        socket->write(head);
+        socket->write(body);
+        finishResponse(socket, keepAlive);
+        return;
+    }
+
+    socket->write(head);
+    writeThrottled(QPointer<QTcpSocket>(socket), body, keepAlive);
+}
+
+void ReplayServer::writeThrottled(QPointer<QTcpSocket> socket, QByteArray remaining, bool keepAlive)
+{
+    if (!socket) {
+        return;
+    }
+
+    const int chunkSize = qMax(1, m_options.bandwidthKBps * 1024 * THROTTLE_TICK_MS / 1000);
+    socket->write(remaining.left(chunkSize));
+    remaining.remove(0, chunkSize);
+
+    if (remaining.isEmpty()) {
+        finishResponse(socket.data(), keepAlive);
+        return;
+    }
+
+    QTimer::singleShot(THROTTLE_TICK_MS, this, [this, socket, remaining, keepAlive]() {
+        writeThrottled(socket, remaining, keepAlive);
+    });
+}
+
+void ReplayServer::finishResponse(QTcpSocket *socket, bool keepAlive)
+{
+    if (!keepAlive) {
+        m_connections.remove(socket);
+        socket->disconnectFromHost();
+        return;
+    }
+
+    auto it = m_connections.find(socket);
+    if (it == m_connections.end()) {
+        return;
+    }
+    it->busy = false;
+
+    // Serve a request that arrived while this one was in flight
+    if (!it->buffer.isEmpty()) {
+        QTimer::singleShot(0, this, [this, socket = QPointer<QTcpSocket>(socket)]() {
+            if (socket) {
+                onReadyRead(socket.data());
+            }
+        });
+    }
+}
+
+double ReplayServer::nextRandom()
+{
+    // xorshift64*: reproducible runs for a fixed --seed
+    m_randomState ^= m_randomState >> 12;
+    m_randomState ^= m_randomState << 25;
+    m_randomState ^= m_randomState >> 27;
+    const quint64 value = m_randomState * 2685821657736338717ULL;
+    return double(value >> 11) / double(1ULL << 53);
+}
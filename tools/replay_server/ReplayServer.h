@@ -0,0 +1,69 @@
+#ifndef REPLAYSERVER_H
+#define REPLAYSERVER_H
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QHash>
+#include <QPointer>
+#include "../../src/network/FixtureArchive.h"
+
+/**
+ * @brief Local stand-in for the book source sites, serving a FixtureArchive
+ *
+ * Speaks HTTP/1.1 with keep-alive and accepts both proxy-style absolute
+ * request targets and origin-form targets with a Host header; HttpClient's
+ * replay mode also sends the original URL as X-Fixture-Url. Latency,
+ * bandwidth and failures can be injected to model slow or flaky sources.
+ */
+class ReplayServer : public QTcpServer
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        int latencyMs = 0;              // Delay before the response headers
+        int jitterMs = 0;               // Uniform extra delay in [0, jitterMs]
+        int bandwidthKBps = 0;          // Body throughput per connection, 0 for unlimited
+        double errorRate = 0.0;         // Share of requests answered with errorStatus
+        int errorStatus = 503;
+        double dropRate = 0.0;          // Share of requests whose connection is closed without an answer
+        quint32 seed = 0;               // Random seed for jitter and injection, 0 for time-based
+    };
+
+    ReplayServer(FixtureArchive *archive, const Options &options, QObject *parent = nullptr);
+
+    qint64 servedCount() const { return m_served; }
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private:
+    struct Connection {
+        QByteArray buffer;
+        bool busy = false;              // A response is being delayed or written
+    };
+
+    struct Request {
+        QByteArray method;
+        QUrl url;
+        QByteArray body;
+        bool keepAlive = true;
+    };
+
+    void onReadyRead(QTcpSocket *socket);
+    bool takeRequest(QByteArray &buffer, Request *request, bool *malformed);
+    void respond(QTcpSocket *socket, const Request &request);
+    void writeResponse(QTcpSocket *socket, int status, const QList<QPair<QByteArray, QByteArray>> &headers,
+                       const QByteArray &body, bool keepAlive);
+    void writeThrottled(QPointer<QTcpSocket> socket, QByteArray remaining, bool keepAlive);
+    void finishResponse(QTcpSocket *socket, bool keepAlive);
+    double nextRandom();
+
+    FixtureArchive *m_archive;
+    Options m_options;
+    QHash<QTcpSocket*, Connection> m_connections;
+    quint64 m_randomState;
+    qint64 m_served;
+};
+
+#endif // REPLAYSERVER_H
@@ -0,0 +1,61 @@
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QHostAddress>
+#include <QDebug>
+
+#include "ReplayServer.h"
+
+// Serves a fixture archive so searches and downloads can be benchmarked offline:
+//   ReplayServer --archive tools/replay_server/fixtures --latency 80 --bandwidth 256
+//   HUYAN_REPLAY_SERVER=127.0.0.1:8089 HuYanReader
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("ReplayServer");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Replays recorded book source responses for offline benchmarks");
+    parser.addHelpOption();
+
+    const QCommandLineOption archiveOption("archive", "Fixture archive directory.", "dir", "fixtures");
+    const QCommandLineOption portOption("port", "Listen port.", "port", "8089");
+    const QCommandLineOption latencyOption("latency", "Delay before each response, in ms.", "ms", "0");
+    const QCommandLineOption jitterOption("jitter", "Random extra delay up to this many ms.", "ms", "0");
+    const QCommandLineOption bandwidthOption("bandwidth", "Body throughput per connection in KB/s, 0 for unlimited.", "kbps", "0");
+    const QCommandLineOption errorRateOption("error-rate", "Share of requests answered with --error-status (0-1).", "rate", "0");
+    const QCommandLineOption errorStatusOption("error-status", "Status code for injected errors.", "code", "503");
+    const QCommandLineOption dropRateOption("drop-rate", "Share of requests whose connection is reset (0-1).", "rate", "0");
+    const QCommandLineOption seedOption("seed", "Random seed for jitter and injected failures.", "seed", "0");
+    parser.addOptions({archiveOption, portOption, latencyOption, jitterOption, bandwidthOption,
+                       errorRateOption, errorStatusOption, dropRateOption, seedOption});
+    parser.process(app);
+
+    FixtureArchive archive(parser.value(archiveOption));
+    QString error;
+    if (!archive.load(&error)) {
+        qCritical() << "ReplayServer:" << error;
+        return 1;
+    }
+    if (archive.size() == 0) {
+        qWarning() << "ReplayServer: Archive" << archive.directory() << "has no fixtures";
+    }
+
+    ReplayServer::Options options;
+    options.latencyMs = qMax(0, parser.value(latencyOption).toInt());
+    options.jitterMs = qMax(0, parser.value(jitterOption).toInt());
+    options.bandwidthKBps = qMax(0, parser.value(bandwidthOption).toInt());
+    options.errorRate = qBound(0.0, parser.value(errorRateOption).toDouble(), 1.0);
+    options.errorStatus = parser.value(errorStatusOption).toInt();
+    options.dropRate = qBound(0.0, parser.value(dropRateOption).toDouble(), 1.0);
+    options.seed = parser.value(seedOption).toUInt();
+
+    ReplayServer server(&archive, options);
+    const quint16 port = quint16(parser.value(portOption).toUInt());
+    if (!server.listen(QHostAddress::LocalHost, port)) {
+        qCritical() << "ReplayServer: Cannot listen on port" << port << ":" << server.errorString();
+        return 1;
+    }
+
+    qDebug() << "ReplayServer: Serving" << archive.size() << "fixtures on 127.0.0.1:" << server.serverPort();
+    return app.exec();
+}